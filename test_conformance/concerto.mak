@@ -26,6 +26,9 @@ STATIC_LIBS := vx_conformance_engine
 ifneq (,$(findstring OPENVX_USE_NN_16,$(SYSDEFS)))
 STATIC_LIBS +=  network
 endif
+ifneq ($(TARGET_OS),Windows_NT)
+SYS_SHARED_LIBS += pthread
+endif
 ifeq ($(HOST_COMPILER),GCC)
 CFLAGS += -Wno-unused-function
 endif
@@ -53,23 +53,31 @@ TEST(Accumulate, testNodeCreation)
 }
 
 
-static CT_Image accumulate_generate_random_8u(int width, int height)
+static CT_Image accumulate_generate_random_8u(int width, int height, int keyed)
 {
     CT_Image image;
 
-    ASSERT_NO_FAILURE_(return 0,
-            image = ct_allocate_ct_image_random(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    if (keyed)
+        ASSERT_NO_FAILURE_(return 0,
+                image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    else
+        ASSERT_NO_FAILURE_(return 0,
+                image = ct_allocate_ct_image_random(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
 
     return image;
 }
 
 
-static CT_Image accumulate_generate_random_16s(int width, int height)
+static CT_Image accumulate_generate_random_16s(int width, int height, int keyed)
 {
     CT_Image image;
 
-    ASSERT_NO_FAILURE_(return 0,
-            image = ct_allocate_ct_image_random(width, height, VX_DF_IMAGE_S16, &CT()->seed_, -32768, 32768));
+    if (keyed)
+        ASSERT_NO_FAILURE_(return 0,
+                image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_S16, &CT()->seed_, -32768, 32768));
+    else
+        ASSERT_NO_FAILURE_(return 0,
+                image = ct_allocate_ct_image_random(width, height, VX_DF_IMAGE_S16, &CT()->seed_, -32768, 32768));
 
     return image;
 }
@@ -115,13 +123,16 @@ static void accumulate_check(CT_Image input, CT_Image accum_src, CT_Image accum_
 
 typedef struct {
     const char* testName;
-    int dummy_;
+    int keyed; // production-size inputs use ct_allocate_ct_image_random_keyed()
     int width, height;
 } Arg;
 
 
 #define PARAMETERS \
-    CT_GENERATE_PARAMETERS("random", ADD_SIZE_SMALL_SET, ARG, 0)
+    CT_GENERATE_PARAMETERS("random", ADD_SIZE_SMALL_SET, ARG, 0), \
+    ARG_PRODUCTION_BEGIN(), \
+    CT_GENERATE_PARAMETERS("random", ADD_SIZE_PRODUCTION_SET, ARG, 1), \
+    ARG_PRODUCTION_END()
 
 TEST_WITH_ARG(Accumulate, testGraphProcessing, Arg,
     PARAMETERS
@@ -134,9 +145,9 @@ TEST_WITH_ARG(Accumulate, testGraphProcessing, Arg,
 
     CT_Image input = NULL, accum_src = NULL, accum_dst = NULL;
 
-    ASSERT_NO_FAILURE(input = accumulate_generate_random_8u(arg_->width, arg_->height));
+    ASSERT_NO_FAILURE(input = accumulate_generate_random_8u(arg_->width, arg_->height, arg_->keyed));
 
-    ASSERT_NO_FAILURE(accum_src = accumulate_generate_random_16s(arg_->width, arg_->height));
+    ASSERT_NO_FAILURE(accum_src = accumulate_generate_random_16s(arg_->width, arg_->height, arg_->keyed));
 
     ASSERT_VX_OBJECT(input_image = ct_image_to_vx_image(input, context), VX_TYPE_IMAGE);
 
@@ -175,9 +186,9 @@ TEST_WITH_ARG(Accumulate, testImmediateProcessing, Arg,
 
     CT_Image input = NULL, accum_src = NULL, accum_dst = NULL;
 
-    ASSERT_NO_FAILURE(input = accumulate_generate_random_8u(arg_->width, arg_->height));
+    ASSERT_NO_FAILURE(input = accumulate_generate_random_8u(arg_->width, arg_->height, arg_->keyed));
 
-    ASSERT_NO_FAILURE(accum_src = accumulate_generate_random_16s(arg_->width, arg_->height));
+    ASSERT_NO_FAILURE(accum_src = accumulate_generate_random_16s(arg_->width, arg_->height, arg_->keyed));
 
     ASSERT_VX_OBJECT(input_image = ct_image_to_vx_image(input, context), VX_TYPE_IMAGE);
 
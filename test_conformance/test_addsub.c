@@ -223,15 +223,19 @@ typedef struct {
     vxuArithmFunction vxuFunc;
     vxArithmFunction vxFunc;
     referenceFunction referenceFunc;
+    int keyed; // fill inputs with ct_fill_image_random_keyed() (production sizes)
 } fuzzy_arg, formats_arg;
 
-#define FUZZY_ARG(func, p, w, h, f1, f2, fr)        \
+#define FUZZY_ARG_(func, p, w, h, f1, f2, fr, keyed)    \
     ARG(#func ": " #p " " #w "x" #h " " #f1 SGN_##func #f2 "=" #fr,   \
-        VX_CONVERT_POLICY_##p, w, h, VX_DF_IMAGE_##f1, VX_DF_IMAGE_##f2, VX_DF_IMAGE_##fr, vxu##func, vx##func##Node, reference##func)
+        VX_CONVERT_POLICY_##p, w, h, VX_DF_IMAGE_##f1, VX_DF_IMAGE_##f2, VX_DF_IMAGE_##fr, vxu##func, vx##func##Node, reference##func, keyed)
+
+#define FUZZY_ARG(func, p, w, h, f1, f2, fr)        FUZZY_ARG_(func, p, w, h, f1, f2, fr, 0)
+#define FUZZY_ARG_KEYED(func, p, w, h, f1, f2, fr)  FUZZY_ARG_(func, p, w, h, f1, f2, fr, 1)
 
 #define FORMATS_ARG(func, p, f1, f2, fr)  \
     ARG(#func ": " #p " " #f1 SGN_##func #f2 "=" #fr, \
-        VX_CONVERT_POLICY_##p, 0, 0, VX_DF_IMAGE_##f1, VX_DF_IMAGE_##f2, VX_DF_IMAGE_##fr, vxu##func, vx##func##Node, reference##func)
+        VX_CONVERT_POLICY_##p, 0, 0, VX_DF_IMAGE_##f1, VX_DF_IMAGE_##f2, VX_DF_IMAGE_##fr, vxu##func, vx##func##Node, reference##func, 0)
 
 #define ARITHM_INVALID_FORMATS(func)            \
     FORMATS_ARG(func, SATURATE, S16, S16, U8),  \
@@ -293,11 +297,28 @@ typedef struct {
     FUZZY_ARG(func, WRAP, 1280, 720, U8, S16, S16),     \
     FUZZY_ARG(func, WRAP, 1280, 720, S16, U8, S16),     \
     FUZZY_ARG(func, WRAP, 1280, 720, S16, S16, S16),    \
-    ARG_EXTENDED_END()
+    ARG_EXTENDED_END(),                                 \
+                                                        \
+    ARG_PRODUCTION_BEGIN(),                                 \
+    FUZZY_ARG_KEYED(func, SATURATE, 1920, 1080, U8, U8, U8),\
+    FUZZY_ARG_KEYED(func, SATURATE, 3840, 2160, U8, U8, U8),\
+    FUZZY_ARG_KEYED(func, SATURATE, 4096, 4096, U8, U8, U8),\
+    FUZZY_ARG_KEYED(func, SATURATE, 1917, 1079, U8, U8, U8),\
+    FUZZY_ARG_KEYED(func, WRAP, 1917, 1079, U8, S16, S16),  \
+    FUZZY_ARG_KEYED(func, WRAP, 1917, 1079, S16, S16, S16), \
+    ARG_PRODUCTION_END()
 
 TESTCASE(vxuAddSub, CT_VXContext, ct_setup_vx_context, 0)
 TESTCASE(vxAddSub,  CT_VXContext, ct_setup_vx_context, 0)
 
+static void fuzzy_fill_random(vx_image image, int keyed)
+{
+    if (keyed)
+        ASSERT_NO_FAILURE(ct_fill_image_random_keyed(image, &CT()->seed_));
+    else
+        ASSERT_NO_FAILURE(ct_fill_image_random(image, &CT()->seed_));
+}
+
 TEST_WITH_ARG(vxuAddSub, testNegativeFormat, formats_arg, ARITHM_INVALID_FORMATS(Add), ARITHM_INVALID_FORMATS(Subtract))
 {
     vx_image src1, src2, dst;
@@ -608,8 +629,8 @@ TEST_WITH_ARG(vxuAddSub, testFuzzy, fuzzy_arg, ARITHM_FUZZY_ARGS(Add), ARITHM_FU
     ASSERT_VX_OBJECT(src2 = vxCreateImage(context, arg_->width, arg_->height, arg_->arg2_format),   VX_TYPE_IMAGE);
     ASSERT_VX_OBJECT(dst  = vxCreateImage(context, arg_->width, arg_->height, arg_->result_format), VX_TYPE_IMAGE);
 
-    ASSERT_NO_FAILURE(ct_fill_image_random(src1, &CT()->seed_));
-    ASSERT_NO_FAILURE(ct_fill_image_random(src2, &CT()->seed_));
+    ASSERT_NO_FAILURE(fuzzy_fill_random(src1, arg_->keyed));
+    ASSERT_NO_FAILURE(fuzzy_fill_random(src2, arg_->keyed));
 
     ASSERT_EQ_VX_STATUS(VX_SUCCESS, arg_->vxuFunc(context, src1, src2, arg_->policy, dst));
 
@@ -644,8 +665,8 @@ TEST_WITH_ARG(vxAddSub, testFuzzy, fuzzy_arg, ARITHM_FUZZY_ARGS(Add), ARITHM_FUZ
     ASSERT_VX_OBJECT(src1 = vxCreateImage(context, arg_->width, arg_->height, arg_->arg1_format),   VX_TYPE_IMAGE);
     ASSERT_VX_OBJECT(src2 = vxCreateImage(context, arg_->width, arg_->height, arg_->arg2_format),   VX_TYPE_IMAGE);
 
-    ASSERT_NO_FAILURE(ct_fill_image_random(src1, &CT()->seed_));
-    ASSERT_NO_FAILURE(ct_fill_image_random(src2, &CT()->seed_));
+    ASSERT_NO_FAILURE(fuzzy_fill_random(src1, arg_->keyed));
+    ASSERT_NO_FAILURE(fuzzy_fill_random(src2, arg_->keyed));
 
     // build one-node graph
     ASSERT_VX_OBJECT(arg_->vxFunc(graph, src1, src2, arg_->policy, dst), VX_TYPE_NODE);
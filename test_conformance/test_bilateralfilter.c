@@ -51,23 +51,6 @@ enum TestTensorDF
     TT_U8
 };
 
-static size_t ownGetFlatByteOffset(
-        size_t index,
-        vx_size dim_num,
-        const vx_size * in_dims,
-        const vx_size * in_strides)
-{
-    size_t res = 0;
-
-    for (vx_size d = 0; d < dim_num; ++d)
-    {
-        res += in_strides[d] * (index % in_dims[d]);
-        index /= in_dims[d];
-    }
-
-    return res;
-}
-
 static void ownUnpackFormat(
         enum TestTensorDF fmt,
         /*OUT*/ vx_enum * data_type,
@@ -112,6 +95,156 @@ static void ownFillRandData(
     }
 }
 
+// weights of all the possible differences of two values, released with ct_free_mem()
+static vx_float32 * ownAllocColorWeights(enum TestTensorDF fmt, float sigmaValues)
+{
+    const vx_int32 size = fmt == TT_U8 ? 256 : 256*256;
+    const vx_float32 gauss_color_coeff = -0.5/(sigmaValues*sigmaValues);
+    vx_float32 * table = (vx_float32*)ct_alloc_mem(size * sizeof(vx_float32));
+
+    if (!table)
+        return NULL;
+
+    // i*i is computed in floating point, int32 overflows for Q78 differences above 46340
+    for (vx_int32 i = 0; i < size; i++)
+    {
+        table[i] = (vx_float32)exp((vx_float32)i*i*gauss_color_coeff);
+    }
+
+    return table;
+}
+
+// walks the elements of a tensor in flat index order, updating the byte offset incrementally
+typedef struct
+{
+    vx_size dim_num;
+    const vx_size * dims;
+    const vx_size * strides;
+    vx_size coord[MAX_TENSOR_DIMS];
+    size_t offset;
+} ownTensorWalker;
+
+static void ownTensorWalkerInit(ownTensorWalker * walker, size_t index, vx_size dim_num, const vx_size * dims, const vx_size * strides)
+{
+    walker->dim_num = dim_num;
+    walker->dims = dims;
+    walker->strides = strides;
+    walker->offset = 0;
+
+    for (vx_size d = 0; d < dim_num; ++d)
+    {
+        walker->coord[d] = index % dims[d];
+        walker->offset += strides[d] * walker->coord[d];
+        index /= dims[d];
+    }
+}
+
+static void ownTensorWalkerNext(ownTensorWalker * walker)
+{
+    for (vx_size d = 0; d < walker->dim_num; ++d)
+    {
+        walker->offset += walker->strides[d];
+        if (++walker->coord[d] < walker->dims[d])
+            return;
+
+        walker->offset -= walker->strides[d] * walker->dims[d];
+        walker->coord[d] = 0;
+    }
+}
+
+static vx_int32 ownReadValue(enum TestTensorDF fmt, const void * ptr, size_t byte_offset)
+{
+    const char * b_ptr = (const char*)ptr + byte_offset;
+    return fmt == TT_Q78 ? *(const vx_int16*)b_ptr : *(const vx_uint8*)b_ptr;
+}
+
+typedef struct
+{
+    const void * in_ptr;
+    const vx_size * in_dims;
+    const vx_size * in_strides;
+    const void * out_ptr;
+    const vx_size * out_dims;
+    const vx_size * out_strides;
+    enum TestTensorDF fmt;
+    vx_size dim_num;
+    size_t first, last;     // checked flat indices
+    size_t row;             // flat indices per parallel item
+    vx_int32 radius;
+    const vx_float32 * space_weight;
+    const vx_float32 * color_weight;
+    size_t total_num;
+    size_t equal_num;
+} ownBilateralFilterJob;
+
+static void ownCheckBilateralFilterRows(void * job_, int begin, int end)
+{
+    ownBilateralFilterJob * job = (ownBilateralFilterJob*)job_;
+    const vx_int32 radius = job->radius;
+    const size_t n = 2 * radius + 1;
+    const size_t first = job->first + (size_t)begin * job->row;
+    const size_t last = MIN(job->first + (size_t)end * job->row, job->last);
+    size_t total_num = 0, equal_num = 0;
+    ownTensorWalker lead, out;
+    vx_int32 * window;
+
+    if (first >= last)
+        return;
+
+    // the values of [index - radius, index + radius], index k is kept at k % n
+    window = (vx_int32*)malloc(n * sizeof(vx_int32));
+    if (!window)
+        return;
+
+    ownTensorWalkerInit(&lead, first - radius, job->dim_num, job->in_dims, job->in_strides);
+    for (size_t k = first - radius; k <= first + radius; ++k)
+    {
+        window[k % n] = ownReadValue(job->fmt, job->in_ptr, lead.offset);
+        ownTensorWalkerNext(&lead);
+    }
+
+    ownTensorWalkerInit(&out, first, job->dim_num, job->out_dims, job->out_strides);
+
+    for (size_t index = first; index < last; ++index)
+    {
+        const vx_int32 in = window[index % n];
+        const vx_int32 out_value = ownReadValue(job->fmt, job->out_ptr, out.offset);
+        vx_float32 sum = 0, wsum = 0, w = 0;
+        vx_int32 ref;
+
+        for (vx_int32 j = -radius; j <= radius; j++)
+        {
+            const vx_int32 nei = window[(index + j) % n];
+            w = job->space_weight[j+radius]*job->color_weight[abs(nei - in)];
+            sum += nei*w;
+            wsum += w;
+        }
+
+        if (job->fmt == TT_Q78)
+            ref = (vx_int16)round(sum/wsum);
+        else
+            ref = (vx_uint8)round(sum/wsum);
+
+        total_num += 1;
+        equal_num += ref == out_value ? 1 : 0;
+
+        ownTensorWalkerNext(&out);
+        if (index + 1 < last)
+        {
+            // index - radius leaves the window, index + radius + 1 enters at the same slot
+            window[(index + radius + 1) % n] = ownReadValue(job->fmt, job->in_ptr, lead.offset);
+            ownTensorWalkerNext(&lead);
+        }
+    }
+
+    free(window);
+
+    ct_global_lock();
+    job->total_num += total_num;
+    job->equal_num += equal_num;
+    ct_global_unlock();
+}
+
 static void ownCheckBilateralFilterResult(
         const void * in_ptr, const vx_size * in_dims, const vx_size * in_strides,
         enum TestTensorDF fmt,
@@ -123,103 +256,56 @@ static void ownCheckBilateralFilterResult(
         void * out_ptr, const vx_size * out_dims, const vx_size * out_strides)
 {
     vx_float32 tolerance = 0.0;
-    vx_float32 total_num = 0.0;
-    vx_float32 equal_num = 0.0;
     vx_int32 radius = diameter/2;
-    vx_float32 color_weight_8[256];
-    vx_float32 color_weight_16[256*256];
-    vx_float32 sum = 0, wsum = 0, w = 0;
-    vx_float32 gauss_color_coeff = -0.5/(sigmaValues*sigmaValues);
     vx_float32 gauss_space_coeff = -0.5/(sigmaSpace*sigmaSpace);
+    ownBilateralFilterJob job;
+    vx_float32 * color_weight;
 
-    vx_float32 *space_weight = (vx_float32*)malloc((radius * 2 + 1) * sizeof(vx_float32));
+    ASSERT(dim_num <= MAX_TENSOR_DIMS);
 
-    for(vx_int32 i = 0; i < 256; i++)
-    {
-        color_weight_8[i] = (vx_float32)exp(i*i*gauss_color_coeff);
-    }
+    // the filter is applied along the flat index, there is nothing to check without full neighbourhoods
+    if (out_count <= (vx_size)(2 * radius))
+        return;
 
-    for(vx_int32 i = 0; i < 256*256; i++)
-    {
-        color_weight_16[i] = (vx_float32)exp(i*i*gauss_color_coeff);
-    }
+    vx_float32 *space_weight = (vx_float32*)malloc((radius * 2 + 1) * sizeof(vx_float32));
+    ASSERT(space_weight);
 
     for(vx_int32 i = -radius; i <= radius; i++ )
     {
         space_weight[i+radius] = (vx_float32)exp(i*i*gauss_space_coeff);
     }
 
-    for (size_t index = radius; index < out_count-radius; ++index)
+    job.in_ptr = in_ptr;
+    job.in_dims = in_dims;
+    job.in_strides = in_strides;
+    job.out_ptr = out_ptr;
+    job.out_dims = out_dims;
+    job.out_strides = out_strides;
+    job.fmt = fmt;
+    job.dim_num = dim_num;
+    job.first = radius;
+    job.last = out_count - radius;
+    job.row = in_dims[0];
+    job.radius = radius;
+    job.space_weight = space_weight;
+    job.color_weight = color_weight = ownAllocColorWeights(fmt, sigmaValues);
+    job.total_num = 0;
+    job.equal_num = 0;
+
+    if (!color_weight)
     {
-        const size_t in_byte_offset = ownGetFlatByteOffset(index, dim_num, in_dims, in_strides);
-        const size_t out_byte_offset = ownGetFlatByteOffset(index, dim_num, out_dims, out_strides);
-
-        const char * in_b_ptr = (char*)in_ptr + in_byte_offset;
-        const char * out_b_ptr = (char*)out_ptr + out_byte_offset;
-
-        switch (fmt)
-        {
-            case TT_Q78:
-            {
-                const vx_int16 in = *(vx_int16*)in_b_ptr;
-                const vx_int16 out = *(vx_int16*)out_b_ptr;
-                int16_t ref;
-
-                sum = 0, wsum = 0;
-
-                for(vx_int32 j = -radius; j <= radius; j++)
-                {
-                    vx_size nei_byte_offset = ownGetFlatByteOffset(index + j, dim_num, in_dims, in_strides);
-                    const char *nei_b_ptr = (char*)in_ptr + nei_byte_offset;
-                    const vx_int16 nei = *(vx_int16*)nei_b_ptr;
-                    w = space_weight[j+radius]*color_weight_16[abs(nei - in)];
-                    sum += nei*w;
-                    wsum += w;
-                }
-                ref = (vx_int16)round(sum/wsum);
-                
-                total_num += 1; 
-
-                if (ref == out)
-                {
-                     equal_num += 1;
-                } 
-            }
-            break;
-            case TT_U8:
-            {
-                const vx_uint8 in = *(vx_uint8*)in_b_ptr;
-                const vx_uint8 out = *(vx_uint8*)out_b_ptr;
-                uint8_t ref;
-
-                sum = 0, wsum = 0;
-
-                for(vx_int32 j = -radius; j <= radius; j++)
-                {
-                    vx_size nei_byte_offset = ownGetFlatByteOffset(index + j, dim_num, in_dims, in_strides);
-                    const char *nei_b_ptr = (char*)in_ptr + nei_byte_offset;
-                    const vx_uint8 nei = *(vx_uint8*)nei_b_ptr;
-                    w = space_weight[j+radius]*color_weight_8[abs(nei - in)];
-                    sum += nei*w;
-                    wsum += w;
-                }
-                ref = (vx_uint8)round(sum/wsum);
-
-                total_num += 1; 
-
-                if (ref == out)
-                {
-                     equal_num += 1;
-                } 
-            }
-            break;
-            default: assert(0);
-        }
+        free(space_weight);
+        FAIL("Can't allocate color weights");
     }
 
-    tolerance = (equal_num / total_num);
+    ct_parallel_for(0, (int)((job.last - job.first + job.row - 1) / job.row), ownCheckBilateralFilterRows, &job);
 
     free(space_weight);
+    ct_free_mem(color_weight);
+
+    ASSERT(job.total_num == job.last - job.first);
+
+    tolerance = ((vx_float32)job.equal_num / job.total_num);
 
     ASSERT(tolerance >= MIN_TOLERANCE);
 }
@@ -492,7 +578,112 @@ TEST(BilateralFilter, testNodeCreation)
     free(dst_tensor_strides);
 }
 
+typedef struct
+{
+    const char * name;
+    enum TestTensorDF fmt;
+    vx_size width, height;
+    int   diameter;
+    float sigmaSpace;
+    float sigmaValues;
+} test_bilateral_filter_size_arg;
+
+#define BILATERAL_FILTER_SIZE_ARG(fmt, w, h, diameter, sigmaSpace, sigmaValues) \
+    ARG("BILATERAL_FILTER_" #fmt "/" #w "x" #h "/d=" #diameter, TT_##fmt, w, h, diameter, sigmaSpace, sigmaValues)
+
+TEST_WITH_ARG(BilateralFilter, testBilateralFilterSize, test_bilateral_filter_size_arg,
+        ARG_PRODUCTION_BEGIN(),
+        BILATERAL_FILTER_SIZE_ARG(U8, 1920, 1080, 5, 1, 1),
+        BILATERAL_FILTER_SIZE_ARG(U8, 1920, 1080, 9, 3, 25),
+        BILATERAL_FILTER_SIZE_ARG(U8, 1920, 1080, 15, 5, 50),
+        BILATERAL_FILTER_SIZE_ARG(Q78, 1920, 1080, 5, 1, 1),
+        BILATERAL_FILTER_SIZE_ARG(Q78, 1920, 1080, 9, 3, 25),
+        BILATERAL_FILTER_SIZE_ARG(U8, 3840, 2160, 9, 3, 25),
+        ARG_PRODUCTION_END()
+)
+{
+    const vx_context context = context_->vx_context_;
+    const enum TestTensorDF fmt = arg_->fmt;
+    const vx_size dims = 2;
+
+    uint64_t rng;
+    {
+        uint64_t * seed = &CT()->seed_;
+        ASSERT(!!seed);
+        CT_RNG_INIT(rng, *seed);
+    }
+
+    vx_enum data_type;
+    vx_uint8 fixed_point_position;
+    vx_size sizeof_data_type;
+    ownUnpackFormat(fmt, &data_type, &fixed_point_position, &sizeof_data_type);
+
+    const vx_size tensor_dims[MAX_TENSOR_DIMS] = { arg_->width, arg_->height, 1 };
+    const vx_size tensor_strides[MAX_TENSOR_DIMS] = { sizeof_data_type, sizeof_data_type * arg_->width, sizeof_data_type * arg_->width * arg_->height };
+    const size_t count = arg_->width * arg_->height;
+    const size_t tensor_bytes = count * sizeof_data_type;
+
+    vx_tensor src_tensor = vxCreateTensor(context, dims, tensor_dims, data_type, fixed_point_position);
+    vx_tensor dst_tensor = vxCreateTensor(context, dims, tensor_dims, data_type, fixed_point_position);
+    ASSERT_VX_OBJECT(src_tensor, VX_TYPE_TENSOR);
+    ASSERT_VX_OBJECT(dst_tensor, VX_TYPE_TENSOR);
+
+    void * const src_data = malloc(tensor_bytes);
+    void * const dst_data = malloc(tensor_bytes);
+    ASSERT(src_data && dst_data);
+
+    {
+        ownFillRandData(fmt, &rng, count, src_data);
+
+        vx_size view_start[MAX_TENSOR_DIMS] = { 0 };
+        VX_CALL(vxCopyTensorPatch(src_tensor, dims, view_start, tensor_dims, tensor_strides, src_data, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST));
+    }
+
+    {
+        vx_graph graph = vxCreateGraph(context);
+        ASSERT_VX_OBJECT(graph, VX_TYPE_GRAPH);
+
+        vx_node node = vxBilateralFilterNode(graph, src_tensor, arg_->diameter, arg_->sigmaSpace, arg_->sigmaValues, dst_tensor);
+
+        ASSERT_VX_OBJECT(node, VX_TYPE_NODE);
+        VX_CALL(vxReleaseNode(&node));
+        EXPECT_EQ_PTR(NULL, node);
+
+        VX_CALL(vxVerifyGraph(graph));
+        VX_CALL(vxProcessGraph(graph));
+
+        VX_CALL(vxReleaseGraph(&graph));
+        EXPECT_EQ_PTR(NULL, graph);
+    }
+
+    {
+        const size_t view_start[MAX_TENSOR_DIMS] = { 0 };
+        VX_CALL(vxCopyTensorPatch(dst_tensor, dims, view_start, tensor_dims, tensor_strides, dst_data, VX_READ_ONLY, VX_MEMORY_TYPE_HOST));
+
+        int64_t time_start = CT_getTickCount();
+        ASSERT_NO_FAILURE(ownCheckBilateralFilterResult(
+                src_data, tensor_dims, tensor_strides,
+                fmt,
+                dims,
+                count,
+                arg_->diameter,
+                arg_->sigmaSpace,
+                arg_->sigmaValues,
+                dst_data, tensor_dims, tensor_strides));
+        CT_TIME_PRINTF("    reference: %.2f ms\n", CT_getElapsedMs(time_start));
+    }
+
+    VX_CALL(vxReleaseTensor(&src_tensor));
+    VX_CALL(vxReleaseTensor(&dst_tensor));
+    EXPECT_EQ_PTR(NULL, src_tensor);
+    EXPECT_EQ_PTR(NULL, dst_tensor);
+
+    free(src_data);
+    free(dst_data);
+}
+
 TESTCASE_TESTS(BilateralFilter,
     testNodeCreation,
-    testBilateralFilterOp
+    testBilateralFilterOp,
+    testBilateralFilterSize
 );
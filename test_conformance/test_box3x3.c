@@ -118,6 +118,17 @@ static CT_Image box3x3_generate_random(const char* fileName, int width, int heig
     return image;
 }
 
+// the same as box3x3_generate_random(), filled with ct_allocate_ct_image_random_keyed() for the production-size inputs
+static CT_Image box3x3_generate_random_keyed(const char* fileName, int width, int height)
+{
+    CT_Image image;
+
+    ASSERT_NO_FAILURE_(return 0,
+            image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+
+    return image;
+}
+
 static CT_Image box3x3_read_image(const char* fileName, int width, int height)
 {
     CT_Image image = NULL;
@@ -129,95 +140,29 @@ static CT_Image box3x3_read_image(const char* fileName, int width, int height)
 }
 
 
-static uint8_t box3x3_calculate(CT_Image src, uint32_t x, uint32_t y)
-{
-    uint8_t res = (uint8_t)(ct_floor_u32_no_overflow( ((float)(
-            (int16_t)(*CT_IMAGE_DATA_PTR_8U(src, x + 0, y + 0)) +
-                      *CT_IMAGE_DATA_PTR_8U(src, x - 1, y + 0) +
-                      *CT_IMAGE_DATA_PTR_8U(src, x + 1, y + 0) +
-                      *CT_IMAGE_DATA_PTR_8U(src, x + 0, y - 1) +
-                      *CT_IMAGE_DATA_PTR_8U(src, x - 1, y - 1) +
-                      *CT_IMAGE_DATA_PTR_8U(src, x + 1, y - 1) +
-                      *CT_IMAGE_DATA_PTR_8U(src, x + 0, y + 1) +
-                      *CT_IMAGE_DATA_PTR_8U(src, x - 1, y + 1) +
-                      *CT_IMAGE_DATA_PTR_8U(src, x + 1, y + 1)) )/9 ) );
-    return res;
-}
-
-static uint8_t box3x3_calculate_replicate(CT_Image src, uint32_t x_, uint32_t y_)
+static void box3x3_calculate_row(const uint8_t* src, int32_t stride, void* dst_, uint32_t width, void* user_data)
 {
-    int32_t x = (int)x_;
-    int32_t y = (int)y_;
-    uint8_t res = (uint8_t)(ct_floor_u32_no_overflow( ((float)(
-            (int16_t)(CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y + 0)) +
-                      CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y + 0) +
-                      CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y + 0) +
-                      CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y - 1) +
-                      CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y - 1) +
-                      CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y - 1) +
-                      CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y + 1) +
-                      CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y + 1) +
-                      CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y + 1)) )/9 ) );
-    return res;
-}
+    uint8_t* dst = (uint8_t*)dst_;
+    uint32_t x;
 
-static uint8_t box3x3_calculate_constant(CT_Image src, uint32_t x_, uint32_t y_, vx_uint32 constant_value)
-{
-    int32_t x = (int)x_;
-    int32_t y = (int)y_;
-    uint8_t res = (uint8_t)(ct_floor_u32_no_overflow( ((float)(
-            (int16_t)(CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y + 0, constant_value)) +
-                      CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y + 0, constant_value) +
-                      CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y + 0, constant_value) +
-                      CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y - 1, constant_value) +
-                      CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y - 1, constant_value) +
-                      CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y - 1, constant_value) +
-                      CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y + 1, constant_value) +
-                      CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y + 1, constant_value) +
-                      CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y + 1, constant_value)) )/9 ) );
-    return res;
+    for (x = 0; x < width; x++)
+    {
+        const uint8_t* s = src + x;
+        int16_t sum = (int16_t)(
+                s[-stride - 1] + s[-stride] + s[-stride + 1] +
+                s[-1]          + s[0]       + s[1] +
+                s[stride - 1]  + s[stride]  + s[stride + 1]);
+        dst[x] = (uint8_t)(ct_floor_u32_no_overflow(((float)sum) / 9));
+    }
 }
 
 
 CT_Image box3x3_create_reference_image(CT_Image src, vx_border_t border)
 {
-    CT_Image dst;
-
     CT_ASSERT_(return NULL, src->format == VX_DF_IMAGE_U8);
+    ASSERT_(return NULL, border.mode == VX_BORDER_UNDEFINED || border.mode == VX_BORDER_REPLICATE || border.mode == VX_BORDER_CONSTANT);
 
-    dst = ct_allocate_image(src->width, src->height, src->format);
-
-    if (border.mode == VX_BORDER_UNDEFINED)
-    {
-        CT_FILL_IMAGE_8U(return 0, dst,
-                if (x >= 1 && y >= 1 && x < src->width - 1 && y < src->height - 1)
-                {
-                    uint8_t res = box3x3_calculate(src, x, y);
-                    *dst_data = res;
-                });
-    }
-    else if (border.mode == VX_BORDER_REPLICATE)
-    {
-        CT_FILL_IMAGE_8U(return 0, dst,
-                {
-                    uint8_t res = box3x3_calculate_replicate(src, x, y);
-                    *dst_data = res;
-                });
-    }
-    else if (border.mode == VX_BORDER_CONSTANT)
-    {
-        vx_uint32 constant_value = border.constant_value.U32;
-        CT_FILL_IMAGE_8U(return 0, dst,
-                {
-                    uint8_t res = box3x3_calculate_constant(src, x, y, constant_value);
-                    *dst_data = res;
-                });
-    }
-    else
-    {
-        ASSERT_(return 0, 0);
-    }
-    return dst;
+    return ct_filter_image_8u(src, border, 1, VX_DF_IMAGE_U8, box3x3_calculate_row, NULL);
 }
 
 
@@ -269,7 +214,10 @@ typedef struct {
     CT_GENERATE_PARAMETERS("simple_gradient", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_GRADIENT_STEPS, ARG, box3x3_generate_simple_gradient, NULL), \
     CT_GENERATE_PARAMETERS("bi_level", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_SMALL_SET, ARG, box3x3_generate_bi_level, NULL), \
     CT_GENERATE_PARAMETERS("randomInput", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_SMALL_SET, ARG, box3x3_generate_random, NULL), \
-    CT_GENERATE_PARAMETERS("lena", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_NONE, ARG, box3x3_read_image, "lena.bmp")
+    CT_GENERATE_PARAMETERS("lena", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_NONE, ARG, box3x3_read_image, "lena.bmp"), \
+    ARG_PRODUCTION_BEGIN(), \
+    CT_GENERATE_PARAMETERS("randomInput", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_PRODUCTION_SET, ARG, box3x3_generate_random_keyed, NULL), \
+    ARG_PRODUCTION_END()
 
 TEST_WITH_ARG(Box3x3, testGraphProcessing, Filter_Arg,
     BOX_PARAMETERS
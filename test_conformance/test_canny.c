@@ -37,7 +37,6 @@ static int32_t offsets[][2] =
     { -1,  1}, {  0,  1}, {  1,  1}
 };
 
-#ifndef USE_OPENCV_GENERATED_REFERENCE
 static uint64_t magnitude(CT_Image img, uint32_t x, uint32_t y, int32_t k, vx_enum type, int32_t* dx_out, int32_t* dy_out)
 {
     static int32_t dim1[][7] = { { 1, 2, 1}, { 1,  4, 6, 4, 1}, { 1,  6, 15, 20, 15, 6, 1}};
@@ -74,13 +73,133 @@ static uint64_t magnitude(CT_Image img, uint32_t x, uint32_t y, int32_t k, vx_en
         return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
 }
 
-static void follow_edge(CT_Image img, uint32_t x, uint32_t y)
+typedef struct {
+    CT_Image  src;
+    uint32_t  gsz;
+    vx_enum   norm;
+    uint64_t* mag;  // width * height, the same layout as src without stride
+    int32_t*  dx;
+    int32_t*  dy;
+} canny_gradient_job;
+
+static void canny_gradient_rows(void* job_, int begin, int end)
+{
+    canny_gradient_job* job = (canny_gradient_job*)job_;
+    uint32_t width = job->src->width, half = job->gsz / 2;
+    uint32_t i, j;
+
+    for (j = (uint32_t)begin; j < (uint32_t)end; ++j)
+    {
+        for (i = half; i < width - half; ++i)
+        {
+            size_t idx = (size_t)j * width + i;
+            job->mag[idx] = magnitude(job->src, i, j, job->gsz, job->norm, &job->dx[idx], &job->dy[idx]);
+        }
+    }
+}
+
+typedef struct {
+    CT_Image        dst;
+    const uint64_t* mag;
+    const int32_t*  dx;
+    const int32_t*  dy;
+    uint64_t        lo, hi;
+    uint32_t        bsz;
+} canny_nms_job;
+
+// threshold + nms, neighbour magnitudes are taken from the precomputed gradient
+static void canny_nms_rows(void* job_, int begin, int end)
+{
+    canny_nms_job* job = (canny_nms_job*)job_;
+    CT_Image dst = job->dst;
+    size_t width = dst->width;
+    uint32_t i, j;
+
+    for (j = (uint32_t)begin; j < (uint32_t)end; ++j)
+    {
+        for (i = job->bsz; i < dst->width - job->bsz; ++i)
+        {
+            size_t idx = j * width + i;
+            int32_t dx = job->dx[idx], dy = job->dy[idx], e = CREF_NONE;
+            uint64_t m = job->mag[idx], m1, m2;
+
+            if (m > job->lo)
+            {
+                uint64_t l1 = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+
+                if (l1 * l1 < (uint64_t)(2 * dx * (int64_t)dx)) // |y| < |x| * tan(pi/8)
+                {
+                    m1 = job->mag[idx - 1];
+                    m2 = job->mag[idx + 1];
+                }
+                else if (l1 * l1 < (uint64_t)(2 * dy * (int64_t)dy)) // |x| < |y| * tan(pi/8)
+                {
+                    m1 = job->mag[idx - width];
+                    m2 = job->mag[idx + width];
+                }
+                else
+                {
+                    int32_t s = (dx ^ dy) < 0 ? -1 : 1;
+                    m1 = job->mag[idx - width - s];
+                    m2 = job->mag[idx + width + s] + 1; // (+1) is OpenCV's gotcha
+                }
+
+                if (m > m1 && m >= m2)
+                    e = (m > job->hi ? CREF_EDGE : CREF_LINK);
+            }
+
+            dst->data.y[j * dst->stride + i] = e;
+        }
+    }
+}
+
+// hysteresis with an explicit stack: every edge or link pixel is pushed at most once,
+// so long connected edges of large images can't overflow the call stack
+static void canny_trace_edges(CT_Image dst, uint32_t bsz)
 {
-    uint32_t i;
-    img->data.y[y * img->stride + x] = 255;
-    for (i = 0; i < sizeof(offsets)/sizeof(offsets[0]); ++i)
-        if (img->data.y[(y + offsets[i][0]) * img->stride + x + offsets[i][1]] == CREF_LINK)
-            follow_edge(img, x + offsets[i][1], y + offsets[i][0]);
+    uint8_t* data = dst->data.y;
+    size_t capacity = 0, top = 0;
+    uint32_t* stack = NULL;
+    uint32_t i, j, k;
+
+    for (j = bsz; j < dst->height - bsz; ++j)
+        for (i = bsz; i < dst->width - bsz; ++i)
+            if (data[j * dst->stride + i] != CREF_NONE)
+                capacity++;
+
+    if (capacity == 0)
+        return;
+
+    stack = (uint32_t*)ct_alloc_mem(capacity * sizeof(uint32_t));
+    ASSERT(stack);
+
+    for (j = bsz; j < dst->height - bsz; ++j)
+    {
+        for (i = bsz; i < dst->width - bsz; ++i)
+        {
+            if (data[j * dst->stride + i] != CREF_EDGE)
+                continue;
+
+            data[j * dst->stride + i] = 255;
+            stack[top++] = j * dst->stride + i;
+
+            while (top > 0)
+            {
+                uint32_t p = stack[--top];
+                for (k = 0; k < sizeof(offsets)/sizeof(offsets[0]); ++k)
+                {
+                    uint32_t q = (uint32_t)((int32_t)p + offsets[k][1] * (int32_t)dst->stride + offsets[k][0]);
+                    if (data[q] == CREF_LINK)
+                    {
+                        data[q] = 255;
+                        stack[top++] = q;
+                    }
+                }
+            }
+        }
+    }
+
+    ct_free_mem(stack);
 }
 
 static void reference_canny(CT_Image src, CT_Image dst, int32_t low_thresh, int32_t high_thresh, uint32_t gsz, vx_enum norm)
@@ -89,6 +208,9 @@ static void reference_canny(CT_Image src, CT_Image dst, int32_t low_thresh, int3
     uint64_t hi = norm == VX_NORM_L1 ? high_thresh : high_thresh*high_thresh;
     uint32_t i, j;
     uint32_t bsz = gsz/2 + 1;
+    size_t size;
+    canny_gradient_job gradient;
+    canny_nms_job nms;
 
     ASSERT(src && dst);
     ASSERT(src->width == dst->width);
@@ -109,50 +231,39 @@ static void reference_canny(CT_Image src, CT_Image dst, int32_t low_thresh, int3
         for (i = 0; i < bsz; ++i)
             dst->data.y[j * dst->stride + i] = dst->data.y[j * dst->stride + dst->width - 1 - i] = 255;
 
-    // threshold + nms
-    for (j = bsz; j < dst->height - bsz; ++j)
+    size = (size_t)src->width * src->height;
+    gradient.src  = src;
+    gradient.gsz  = gsz;
+    gradient.norm = norm;
+    gradient.mag  = (uint64_t*)ct_alloc_mem(size * sizeof(uint64_t));
+    gradient.dx   = (int32_t*)ct_alloc_mem(size * sizeof(int32_t));
+    gradient.dy   = (int32_t*)ct_alloc_mem(size * sizeof(int32_t));
+    if (!gradient.mag || !gradient.dx || !gradient.dy)
     {
-        for (i = bsz; i < dst->width - bsz; ++i)
-        {
-            int32_t dx, dy, e = CREF_NONE;
-            uint64_t m1, m2;
-
-            uint64_t m = magnitude(src, i, j, gsz, norm, &dx, &dy);
-
-            if (m > lo)
-            {
-                uint64_t l1 = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+        ct_free_mem(gradient.mag);
+        ct_free_mem(gradient.dx);
+        ct_free_mem(gradient.dy);
+        FAIL("Can't allocate gradient buffers for %ux%u image", src->width, src->height);
+    }
 
-                if (l1 * l1 < (uint64_t)(2 * dx * (int64_t)dx)) // |y| < |x| * tan(pi/8)
-                {
-                    m1 = magnitude(src, i-1, j, gsz, norm, 0, 0);
-                    m2 = magnitude(src, i+1, j, gsz, norm, 0, 0);
-                }
-                else if (l1 * l1 < (uint64_t)(2 * dy * (int64_t)dy)) // |x| < |y| * tan(pi/8)
-                {
-                    m1 = magnitude(src, i, j-1, gsz, norm, 0, 0);
-                    m2 = magnitude(src, i, j+1, gsz, norm, 0, 0);
-                }
-                else
-                {
-                    int32_t s = (dx ^ dy) < 0 ? -1 : 1;
-                    m1 = magnitude(src, i-s, j-1, gsz, norm, 0, 0);
-                    m2 = magnitude(src, i+s, j+1, gsz, norm, 0, 0) + 1; // (+1) is OpenCV's gotcha
-                }
+    // gradient is computed once per pixel, rows are independent
+    ct_parallel_for((int)(gsz / 2), (int)(src->height - gsz / 2), canny_gradient_rows, &gradient);
 
-                if (m > m1 && m >= m2)
-                    e = (m > hi ? CREF_EDGE : CREF_LINK);
-            }
+    nms.dst = dst;
+    nms.mag = gradient.mag;
+    nms.dx  = gradient.dx;
+    nms.dy  = gradient.dy;
+    nms.lo  = lo;
+    nms.hi  = hi;
+    nms.bsz = bsz;
+    ct_parallel_for((int)bsz, (int)(dst->height - bsz), canny_nms_rows, &nms);
 
-            dst->data.y[j * src->stride + i] = e;
-        }
-    }
+    ct_free_mem(gradient.mag);
+    ct_free_mem(gradient.dx);
+    ct_free_mem(gradient.dy);
 
     // trace edges
-    for (j = bsz; j < dst->height - bsz; ++j)
-        for (i = bsz; i < dst->width - bsz; ++i)
-            if(dst->data.y[j * dst->stride + i] == CREF_EDGE)
-                follow_edge(dst, i, j);
+    ASSERT_NO_FAILURE(canny_trace_edges(dst, bsz));
 
     // clear non-edges
     for (j = bsz; j < dst->height - bsz; ++j)
@@ -160,114 +271,152 @@ static void reference_canny(CT_Image src, CT_Image dst, int32_t low_thresh, int3
             if(dst->data.y[j * dst->stride + i] < 255)
                 dst->data.y[j * dst->stride + i] = 0;
 }
-#endif
+
+// bump CANNY_REFERENCE_VERSION when reference_canny() output changes
+#define CANNY_REFERENCE_VERSION 1
+
+static void reference_canny_cached(CT_Image src, CT_Image dst, int32_t low_thresh, int32_t high_thresh, uint32_t gsz, vx_enum norm)
+{
+    CT_RefCacheKey key;
+
+    ct_ref_cache_key_init(&key, "canny", CANNY_REFERENCE_VERSION);
+    ct_ref_cache_key_add_image(&key, src);
+    ct_ref_cache_key_add_int(&key, low_thresh);
+    ct_ref_cache_key_add_int(&key, high_thresh);
+    ct_ref_cache_key_add_int(&key, gsz);
+    ct_ref_cache_key_add_int(&key, norm);
+
+    if (ct_ref_cache_load_image(&key, dst))
+        return;
+
+    reference_canny(src, dst, low_thresh, high_thresh, gsz, norm);
+    if (!CT_HasFailure())
+        ct_ref_cache_store_image(&key, dst);
+}
 
 // computes count(disttransform(src) >= 2, where dst != 0)
 static uint32_t disttransform2_metric(CT_Image src, CT_Image dst, CT_Image dist, uint32_t* total_edge_pixels)
 {
-    uint32_t i, j, k, count, total;
+    uint32_t i, j, count, total;
+    uint32_t width, height;
+    uint8_t* vert;
 
     ASSERT_(return 0, src && dst && dist && total_edge_pixels);
     ASSERT_(return 0, src->width == dst->width && src->width == dist->width);
     ASSERT_(return 0, src->height == dst->height && src->height == dist->height);
     ASSERT_(return 0, src->format == dst->format && src->format == dist->format && src->format == VX_DF_IMAGE_U8);
 
-    // fill borders with 1 (or 0 for edges)
-    for (i = 0; i < dst->width; ++i)
-    {
-        dist->data.y[i] = src->data.y[i] == 0 ? 1 : 0;
-        dist->data.y[(dist->height - 1) * dist->stride + i] = src->data.y[(dist->height - 1) * src->stride + i] == 0 ? 1 : 0;
-    }
-    for (j = 1; j < dst->height - 1; ++j)
-    {
-        dist->data.y[j * dist->stride] = src->data.y[j * src->stride] == 0 ? 1 : 0;
-        dist->data.y[j * dist->stride + dist->width - 1] = src->data.y[j * src->stride + dist->width - 1] == 0 ? 1 : 0;
-    }
+    width = src->width;
+    height = src->height;
 
-    // minimalistic variant of disttransform:
+    // vertical OR of the 3 source rows around the current one
+    vert = (uint8_t*)ct_alloc_mem(width);
+    ASSERT_(return 0, vert);
+
+    // minimalistic variant of disttransform, computed together with the count in one pass:
     // 0   ==>      disttransform(src) == 0
     // 1   ==> 1 <= disttransform(src) < 2
     // 255 ==>      disttransform(src) >= 2
-    for (j = 1; j < src->height-1; ++j)
+    // borders are filled with 1 (or 0 for edges)
+    total = count = 0;
+    for (j = 0; j < height; ++j)
     {
-        for (i = 1; i < src->width-1; ++i)
+        const uint8_t* s = src->data.y + j * src->stride;
+        const uint8_t* d = dst->data.y + j * dst->stride;
+        uint8_t* t = dist->data.y + j * dist->stride;
+
+        if (j == 0 || j == height - 1)
         {
-            if (src->data.y[j * src->stride + i] != 0)
-                dist->data.y[j * dist->stride + i] = 0;
-            else
-            {
-                int has_edge = 0;
-                for (k = 0; k < sizeof(offsets)/sizeof(offsets[0]); ++k)
-                {
-                    if (src->data.y[(j + offsets[k][1]) * src->stride + i + offsets[k][0]] != 0)
-                    {
-                        has_edge = 1;
-                        break;
-                    }
-                }
+            for (i = 0; i < width; ++i)
+                t[i] = s[i] == 0 ? 1 : 0;
+        }
+        else
+        {
+            const uint8_t* up = s - src->stride;
+            const uint8_t* down = s + src->stride;
 
-                dist->data.y[j * dist->stride + i] = (has_edge ? 1 : 255);
-            }
+            for (i = 0; i < width; ++i)
+                vert[i] = up[i] | s[i] | down[i];
+
+            // the center pixel is zero when its neighbourhood is checked, so it may be included
+            for (i = 1; i + 1 < width; ++i)
+                t[i] = s[i] != 0 ? 0 : ((vert[i - 1] | vert[i] | vert[i + 1]) != 0 ? 1 : 255);
+
+            t[0] = s[0] == 0 ? 1 : 0;
+            t[width - 1] = s[width - 1] == 0 ? 1 : 0;
         }
-    }
 
-    // count pixels where disttransform(src) < 2 and dst != 0
-    total = count = 0;
-    for (j = 0; j < dst->height; ++j)
-    {
-        for (i = 0; i < dst->width; ++i)
+        // count pixels where disttransform(src) < 2 and dst != 0
+        for (i = 0; i < width; ++i)
         {
-            if (dst->data.y[j * dst->stride + i] != 0)
-            {
-                total += 1;
-                count += (dist->data.y[j * dist->stride + i] < 2) ? 1 : 0;
-            }
+            uint32_t is_edge = d[i] != 0;
+            total += is_edge;
+            count += is_edge & (t[i] < 2);
         }
     }
 
+    ct_free_mem(vert);
+
     *total_edge_pixels = total;
 
     return count;
 }
 
-#ifndef USE_OPENCV_GENERATED_REFERENCE
+static void gaussian5x5_calculate_row(const uint8_t* src, int32_t stride, void* dst_, uint32_t width, void* user_data)
+{
+    static const uint32_t ww[] = {1, 4, 6, 4, 1};
+    uint8_t* dst = (uint8_t*)dst_;
+    uint32_t i, k, n;
+
+    for (i = 0; i < width; ++i)
+    {
+        uint32_t r = 0;
+        for (k = 0; k < 5; ++k)
+        {
+            const uint8_t* row = src + ((int32_t)k - 2) * stride + i - 2;
+            uint32_t rr = 0;
+            for (n = 0; n < 5; ++n)
+                rr += ww[n] * row[n];
+
+            r += rr * ww[k];
+        }
+        dst[i] = (uint8_t)((r + (1<<7)) >> 8);
+    }
+}
+
 // own blur to not depend on OpenVX borders handling
 static CT_Image gaussian5x5(CT_Image img)
 {
-    CT_Image res;
-    uint32_t i, j, k, n;
-    uint32_t ww[] = {1, 4, 6, 4, 1};
+    vx_border_t border;
 
     ASSERT_(return 0, img);
     ASSERT_(return 0, img->format == VX_DF_IMAGE_U8);
 
-    res = ct_allocate_image(img->width, img->height, img->format);
-    ASSERT_(return 0, res);
+    border.mode = VX_BORDER_REPLICATE;
+    return ct_filter_image_8u(img, border, 2, VX_DF_IMAGE_U8, gaussian5x5_calculate_row, NULL);
+}
 
-    for (j = 0; j < img->height; ++j)
+// per-pixel form of gaussian5x5(), rows are clamped by the height and columns by the width
+// (the version before ct_filter_image_8u() clamped rows by the width, that matched only for square images)
+static uint8_t gaussian5x5_pixel(CT_Image img, int x, int y)
+{
+    static const uint32_t ww[] = {1, 4, 6, 4, 1};
+    uint32_t r = 0;
+    int k, n;
+
+    for (k = 0; k < 5; ++k)
     {
-        for (i = 0; i < img->width; ++i)
+        int yy = CT_MAX(0, CT_MIN(y + k - 2, (int)img->height - 1));
+        uint32_t rr = 0;
+        for (n = 0; n < 5; ++n)
         {
-            uint32_t r = 0;
-            for (k = 0; k < 5; ++k)
-            {
-                uint32_t rr = 0;
-                uint32_t kj = k + j < 2 ? 0 : (k + j - 2 >= img->width ? img->width -1 :  k + j - 2);
-                for (n = 0; n < 5; ++n)
-                {
-                    uint32_t ni = n + i < 2 ? 0 : (n + i - 2 >= img->width ? img->width -1 :  n + i - 2);
-                    rr += ww[n] * img->data.y[kj * img->stride + ni];
-                }
-
-                r += rr * ww[k];
-            }
-            res->data.y[j * res->stride + i] = (r + (1<<7)) >> 8;
+            int xx = CT_MAX(0, CT_MIN(x + n - 2, (int)img->width - 1));
+            rr += ww[n] * *CT_IMAGE_DATA_PTR_8U(img, xx, yy);
         }
+        r += rr * ww[k];
     }
-
-    return res;
+    return (uint8_t)((r + (1<<7)) >> 8);
 }
-#endif
 
 static CT_Image get_source_image(const char* filename)
 {
@@ -652,5 +801,156 @@ TEST_WITH_ARG(vxCanny, Lena, canny_arg,
     ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxReleaseImage(&dst));
 }
 
-TESTCASE_TESTS(vxuCanny, DISABLED_BitExactL1, Lena)
-TESTCASE_TESTS(vxCanny,  DISABLED_BitExactL1, Lena)
+typedef struct {
+    const char* name;
+    uint32_t width, height;
+    int32_t grad_size;
+    vx_enum norm_type;
+    int32_t low_thresh;
+    int32_t high_thresh;
+} canny_production_arg;
+
+#define CANNY_PRODUCTION_ARG(w, h, grad, norm, lo, hi) ARG(#w "x" #h "/" #norm " " #grad "x" #grad " thresh=(" #lo ", " #hi ")", w, h, grad, VX_NORM_##norm, lo, hi)
+
+#define CANNY_PRODUCTION_PARAMETERS \
+    ARG_PRODUCTION_BEGIN(), \
+    CANNY_PRODUCTION_ARG(1920, 1080, 3, L1, 100, 120), \
+    CANNY_PRODUCTION_ARG(1920, 1080, 3, L2, 100, 120), \
+    CANNY_PRODUCTION_ARG(1920, 1080, 5, L2, 1200, 1440), \
+    CANNY_PRODUCTION_ARG(3840, 2160, 3, L1, 100, 120), \
+    CANNY_PRODUCTION_ARG(3840, 2160, 7, L2, 16000, 19200), \
+    ARG_PRODUCTION_END()
+
+// lena tiled with mirroring to the requested size: natural content without seams at tile borders
+static CT_Image canny_tiled_source(uint32_t width, uint32_t height)
+{
+    CT_Image lena = NULL, src = NULL;
+    uint32_t x, y;
+
+    ASSERT_NO_FAILURE_(return NULL, lena = ct_read_image("lena_gray.bmp", 1));
+    ASSERT_NO_FAILURE_(return NULL, src = ct_allocate_image(width, height, VX_DF_IMAGE_U8));
+
+    for (y = 0; y < height; ++y)
+    {
+        uint32_t ty = y % (2 * lena->height);
+        const uint8_t* lena_row = CT_IMAGE_DATA_PTR_8U(lena, 0, ty < lena->height ? ty : 2 * lena->height - 1 - ty);
+        uint8_t* src_row = CT_IMAGE_DATA_PTR_8U(src, 0, y);
+
+        for (x = 0; x < width; ++x)
+        {
+            uint32_t tx = x % (2 * lena->width);
+            src_row[x] = lena_row[tx < lena->width ? tx : 2 * lena->width - 1 - tx];
+        }
+    }
+
+    return src;
+}
+
+static void canny_check_production(vx_context context, const canny_production_arg* arg, vx_bool use_graph)
+{
+    uint32_t total, count;
+    vx_image src, dst;
+    vx_threshold hyst;
+    CT_Image input = NULL, vxdst = NULL, refdst = NULL, dist = NULL;
+    vx_int32 low_thresh  = arg->low_thresh;
+    vx_int32 high_thresh = arg->high_thresh;
+    vx_border_t border = { VX_BORDER_UNDEFINED, {{ 0 }} };
+    vx_int32 border_width = arg->grad_size/2 + 1;
+    vx_enum thresh_data_type = low_thresh > 255 ? VX_TYPE_INT16 : VX_TYPE_UINT8;
+    int64_t time_start;
+
+    ASSERT_NO_FAILURE(input = canny_tiled_source(arg->width, arg->height));
+    ASSERT_NO_FAILURE(src = ct_image_to_vx_image(input, context));
+    ASSERT_VX_OBJECT(dst = vxCreateImage(context, input->width, input->height, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+
+    ASSERT_VX_OBJECT(hyst = vxCreateThreshold(context, VX_THRESHOLD_TYPE_RANGE, thresh_data_type), VX_TYPE_THRESHOLD);
+    ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxSetThresholdAttribute(hyst, VX_THRESHOLD_THRESHOLD_LOWER, &low_thresh,  sizeof(low_thresh)));
+    ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxSetThresholdAttribute(hyst, VX_THRESHOLD_THRESHOLD_UPPER, &high_thresh, sizeof(high_thresh)));
+
+    if (use_graph)
+    {
+        vx_graph graph;
+        vx_node node;
+
+        ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+        ASSERT_VX_OBJECT(node = vxCannyEdgeDetectorNode(graph, src, hyst, arg->grad_size, arg->norm_type, dst), VX_TYPE_NODE);
+        ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxSetNodeAttribute(node, VX_NODE_BORDER, &border, sizeof(border)));
+        ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxProcessGraph(graph));
+        ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxReleaseNode(&node));
+        ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxReleaseGraph(&graph));
+    }
+    else
+    {
+        ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxSetContextAttribute(context, VX_CONTEXT_IMMEDIATE_BORDER, &border, sizeof(border)));
+        ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxuCannyEdgeDetector(context, src, hyst, arg->grad_size, arg->norm_type, dst));
+    }
+
+    ASSERT_NO_FAILURE(vxdst = ct_image_from_vx_image(dst));
+
+    // there are no golden files for these sizes, the reference is computed
+    time_start = CT_getTickCount();
+    ASSERT_NO_FAILURE(refdst = ct_allocate_image(input->width, input->height, VX_DF_IMAGE_U8));
+    ASSERT_NO_FAILURE(reference_canny_cached(input, refdst, low_thresh, high_thresh, arg->grad_size, arg->norm_type));
+    CT_TIME_PRINTF("    reference: %.2f ms\n", CT_getElapsedMs(time_start));
+
+    ASSERT_NO_FAILURE(ct_adjust_roi(vxdst,  border_width, border_width, border_width, border_width));
+    ASSERT_NO_FAILURE(ct_adjust_roi(refdst, border_width, border_width, border_width, border_width));
+
+    ASSERT_NO_FAILURE(dist = ct_allocate_image(refdst->width, refdst->height, VX_DF_IMAGE_U8));
+
+    // the same two-way acceptance criteria as for the Lena tests
+    ASSERT_NO_FAILURE(count = disttransform2_metric(refdst, vxdst, dist, &total));
+    if (count < CANNY_ACCEPTANCE_THRESHOLD * total)
+    {
+        CT_RecordFailureAtFormat("disttransform(reference) < 2 only for %u of %u pixels of output edges which is %.2f%% < %.2f%%", __FUNCTION__, __FILE__, __LINE__,
+            count, total, count/(double)total*100, CANNY_ACCEPTANCE_THRESHOLD*100);
+    }
+
+    ASSERT_NO_FAILURE(count = disttransform2_metric(vxdst, refdst, dist, &total));
+    if (count < CANNY_ACCEPTANCE_THRESHOLD * total)
+    {
+        CT_RecordFailureAtFormat("disttransform(output) < 2 only for %u of %u pixels of reference edges which is %.2f%% < %.2f%%", __FUNCTION__, __FILE__, __LINE__,
+            count, total, count/(double)total*100, CANNY_ACCEPTANCE_THRESHOLD*100);
+    }
+
+    ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxReleaseThreshold(&hyst));
+    ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxReleaseImage(&src));
+    ASSERT_EQ_VX_STATUS(VX_SUCCESS, vxReleaseImage(&dst));
+}
+
+typedef struct {
+    const char* name;
+    int width, height;
+} blur_arg;
+
+// the pre-blur of the "blurred_" sources replicates the border on all four sides, also for non-square images
+TEST_WITH_ARG(vxuCanny, Gaussian5x5Borders, blur_arg,
+    ARG("37x11", 37, 11),
+    ARG("11x37", 11, 37),
+    ARG("16x16", 16, 16),
+    ARG("3x2", 3, 2))
+{
+    CT_Image src = NULL, dst = NULL;
+    int x, y;
+
+    ASSERT_NO_FAILURE(src = ct_allocate_ct_image_random(arg_->width, arg_->height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    ASSERT_NO_FAILURE(dst = gaussian5x5(src));
+    ASSERT(dst && dst->width == src->width && dst->height == src->height);
+
+    for (y = 0; y < (int)dst->height; ++y)
+        for (x = 0; x < (int)dst->width; ++x)
+            ASSERT_EQ_INT(gaussian5x5_pixel(src, x, y), *CT_IMAGE_DATA_PTR_8U(dst, x, y));
+}
+
+TEST_WITH_ARG(vxuCanny, Production, canny_production_arg, CANNY_PRODUCTION_PARAMETERS)
+{
+    ASSERT_NO_FAILURE(canny_check_production(context_->vx_context_, arg_, vx_false_e));
+}
+
+TEST_WITH_ARG(vxCanny, Production, canny_production_arg, CANNY_PRODUCTION_PARAMETERS)
+{
+    ASSERT_NO_FAILURE(canny_check_production(context_->vx_context_, arg_, vx_true_e));
+}
+
+TESTCASE_TESTS(vxuCanny, DISABLED_BitExactL1, Lena, Gaussian5x5Borders, Production)
+TESTCASE_TESTS(vxCanny,  DISABLED_BitExactL1, Lena, Production)
@@ -120,30 +120,34 @@ static CT_Image convolve_read_image(const char* fileName, int width, int height)
     return image;
 }
 
-static int32_t convolve_get(CT_Image src, int32_t x, int32_t y, vx_border_t border,
-        int cols, int rows, vx_int16* data, vx_uint32 scale, vx_df_image dst_format)
+typedef struct {
+    int cols, rows;
+    vx_int16* data;
+    vx_uint32 scale;
+    vx_df_image dst_format;
+} convolve_params;
+
+static int32_t convolve_get(const uint8_t* src, int32_t stride, const convolve_params* p)
 {
-    int i;
+    int i, j;
     int32_t sum = 0, value = 0;
-    int32_t src_data[MAX_CONV_SIZE * MAX_CONV_SIZE] = { 0 };
-
-    ASSERT_(return 0, cols <= MAX_CONV_SIZE);
-    ASSERT_(return 0, rows <= MAX_CONV_SIZE);
+    const vx_int16* coeff = p->data + p->cols * p->rows - 1;
 
-    ASSERT_NO_FAILURE_(return 0,
-            ct_image_read_rect_S32(src, src_data, x - cols / 2, y - rows / 2, x + cols / 2, y + rows / 2, border));
-
-    for (i = 0; i < cols * rows; ++i)
-        sum += src_data[i] * data[cols * rows - 1 - i];
+    src -= (p->rows / 2) * stride + p->cols / 2;
+    for (i = 0; i < p->rows; ++i, src += stride)
+    {
+        for (j = 0; j < p->cols; ++j)
+            sum += src[j] * *coeff--;
+    }
 
-    value = sum / scale;
+    value = sum / p->scale;
 
-    if (dst_format == VX_DF_IMAGE_U8)
+    if (p->dst_format == VX_DF_IMAGE_U8)
     {
         if (value < 0) value = 0;
         else if (value > UINT8_MAX) value = UINT8_MAX;
     }
-    else if (dst_format == VX_DF_IMAGE_S16)
+    else if (p->dst_format == VX_DF_IMAGE_S16)
     {
         if (value < INT16_MIN) value = INT16_MIN;
         else if (value > INT16_MAX) value = INT16_MAX;
@@ -152,37 +156,45 @@ static int32_t convolve_get(CT_Image src, int32_t x, int32_t y, vx_border_t bord
     return value;
 }
 
+static void convolve_calculate_row(const uint8_t* src, int32_t stride, void* dst, uint32_t width, void* user_data)
+{
+    const convolve_params* p = (const convolve_params*)user_data;
+    uint32_t x;
+
+    if (p->dst_format == VX_DF_IMAGE_U8)
+    {
+        for (x = 0; x < width; x++)
+            ((vx_uint8*)dst)[x] = (vx_uint8)convolve_get(src + x, stride, p);
+    }
+    else
+    {
+        for (x = 0; x < width; x++)
+            ((vx_int16*)dst)[x] = (vx_int16)convolve_get(src + x, stride, p);
+    }
+}
+
 
 static CT_Image convolve_create_reference_image(CT_Image src, vx_border_t border,
         int cols, int rows, vx_int16* data, vx_uint32 scale, vx_df_image dst_format)
 {
-    CT_Image dst;
+    convolve_params params;
 
     CT_ASSERT_(return NULL, src->format == VX_DF_IMAGE_U8);
+    ASSERT_(return NULL, cols <= MAX_CONV_SIZE);
+    ASSERT_(return NULL, rows <= MAX_CONV_SIZE);
 
-    dst = ct_allocate_image(src->width, src->height, dst_format);
-
-    if (dst_format == VX_DF_IMAGE_U8)
-    {
-        CT_FILL_IMAGE_8U(return 0, dst,
-                {
-                    int32_t res = convolve_get(src, x, y, border, cols, rows, data, scale, dst_format);
-                    *dst_data = (vx_uint8)res;
-                });
-    }
-    else if (dst_format == VX_DF_IMAGE_S16)
-    {
-        CT_FILL_IMAGE_16S(return 0, dst,
-                {
-                    int32_t res = convolve_get(src, x, y, border, cols, rows, data, scale, dst_format);
-                    *dst_data = (vx_int16)res;
-                });
-    }
-    else
+    if (dst_format != VX_DF_IMAGE_U8 && dst_format != VX_DF_IMAGE_S16)
     {
         CT_FAIL_(return 0, "NOT IMPLEMENTED");
     }
-    return dst;
+
+    params.cols = cols;
+    params.rows = rows;
+    params.data = data;
+    params.scale = scale;
+    params.dst_format = dst_format;
+
+    return ct_filter_image_8u(src, border, (uint32_t)CT_MAX(cols, rows) / 2, dst_format, convolve_calculate_row, &params);
 }
 
 
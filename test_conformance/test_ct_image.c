@@ -0,0 +1,100 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_engine/test.h"
+
+// CT_Image helpers the reference implementations rely on, no OpenVX calls
+TESTCASE(CTImage, CT_VoidContext, 0, 0)
+
+typedef struct {
+    const char* testName;
+    vx_border_t border;
+} padded_arg;
+
+// pixel (x, y) of src extended by the border, x and y may be out of the image
+static uint8_t padded_expected(CT_Image src, vx_border_t border, int x, int y)
+{
+    int inside = x >= 0 && y >= 0 && x < (int)src->width && y < (int)src->height;
+    if (border.mode == VX_BORDER_CONSTANT && !inside)
+        return border.constant_value.U8;
+    return *CT_IMAGE_DATA_PTR_8U(src, CT_MAX(0, CT_MIN(x, (int)src->width - 1)), CT_MAX(0, CT_MIN(y, (int)src->height - 1)));
+}
+
+TEST_WITH_ARG(CTImage, testPaddedAdjustRoi, padded_arg,
+    ARG("VX_BORDER_REPLICATE", { VX_BORDER_REPLICATE, {{ 0 }} }),
+    ARG("VX_BORDER_CONSTANT", { VX_BORDER_CONSTANT, {{ 17 }} }))
+{
+    const int pad = 2;
+    CT_Image src = NULL, padded = NULL;
+    int x, y;
+
+    ASSERT_NO_FAILURE(src = ct_allocate_ct_image_random(7, 5, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    ASSERT_NO_FAILURE(padded = ct_image_make_padded(src, arg_->border, pad));
+    ASSERT(padded->width == src->width && padded->height == src->height);
+
+    for (y = -pad; y < (int)src->height + pad; y++)
+    {
+        for (x = -pad; x < (int)src->width + pad; x++)
+            ASSERT_EQ_INT(padded_expected(src, arg_->border, x, y), *CT_IMAGE_DATA_PTR_PADDED_8U(padded, x, y));
+    }
+
+    // negative margins extend the view into the padding, the border pixels are at the view edges
+    ASSERT_NO_FAILURE(ct_adjust_roi(padded, -pad, -pad, -pad, -pad));
+    ASSERT(padded->width == src->width + 2 * pad && padded->height == src->height + 2 * pad);
+    ASSERT(padded->roi.x == 0 && padded->roi.y == 0);
+
+    for (y = 0; y < (int)padded->height; y++)
+        for (x = 0; x < (int)padded->width; x++)
+            ASSERT_EQ_INT(padded_expected(src, arg_->border, x - pad, y - pad), *CT_IMAGE_DATA_PTR_8U(padded, x, y));
+
+    // and back to the original area
+    ASSERT_NO_FAILURE(ct_adjust_roi(padded, pad, pad, pad, pad));
+    ASSERT(padded->width == src->width && padded->height == src->height);
+    for (y = 0; y < (int)src->height; y++)
+        for (x = 0; x < (int)src->width; x++)
+            ASSERT_EQ_INT(*CT_IMAGE_DATA_PTR_8U(src, x, y), *CT_IMAGE_DATA_PTR_8U(padded, x, y));
+}
+
+typedef struct {
+    const char* testName;
+    vx_df_image format;
+    int a, b;
+} keyed_arg;
+
+// the keyed fill must not depend on --ref_threads, the reference results of the production tier rely on it
+TEST_WITH_ARG(CTImage, testRandomKeyedThreads, keyed_arg,
+    ARG("U8", VX_DF_IMAGE_U8, 0, 256),
+    ARG("S16", VX_DF_IMAGE_S16, -32768, 32768),
+    ARG("RGB", VX_DF_IMAGE_RGB, 0, 256),
+    ARG("IYUV", VX_DF_IMAGE_IYUV, 0, 256))
+{
+    const int num_threads = ct_get_num_threads();
+    uint64_t seed_serial = CT()->seed_, seed_parallel = CT()->seed_;
+    CT_Image serial = NULL, parallel = NULL;
+
+    ct_set_num_threads(1);
+    serial = ct_allocate_ct_image_random_keyed(642, 481, arg_->format, &seed_serial, arg_->a, arg_->b);
+    ct_set_num_threads(CT_MAX(num_threads, 4));
+    parallel = ct_allocate_ct_image_random_keyed(642, 481, arg_->format, &seed_parallel, arg_->a, arg_->b);
+    ct_set_num_threads(num_threads);
+
+    ASSERT(serial && parallel);
+    ASSERT_EQ_CTIMAGE(serial, parallel);
+    ASSERT(seed_serial == seed_parallel && seed_serial != CT()->seed_);
+}
+
+TESTCASE_TESTS(CTImage, testPaddedAdjustRoi, testRandomKeyedThreads)
@@ -65,6 +65,21 @@ static CT_Image dilate3x3_generate_random(const char* fileName, int width, int h
     return image;
 }
 
+// the same as dilate3x3_generate_random(), filled with ct_allocate_ct_image_random_keyed() for the production-size inputs
+static CT_Image dilate3x3_generate_random_keyed(const char* fileName, int width, int height)
+{
+    CT_Image image;
+
+    ASSERT_NO_FAILURE_(return 0,
+            image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 2));
+
+    // convert 0/1 values to 0/255
+    CT_FILL_IMAGE_8U(return 0, image,
+            *dst_data = (*dst_data) ? 255 : 0);
+
+    return image;
+}
+
 static CT_Image dilate3x3_read_image(const char* fileName, int width, int height)
 {
     CT_Image image = NULL;
@@ -84,98 +99,36 @@ static int32_t dilate_get(int32_t *values)
     return v;
 }
 
-static uint8_t dilate3x3_calculate(CT_Image src, uint32_t x, uint32_t y)
+static void dilate3x3_calculate_row(const uint8_t* src, int32_t stride, void* dst_, uint32_t width, void* user_data)
 {
-    int32_t values[9] = {
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y + 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y + 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y + 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y + 1)
-    };
-    return (uint8_t)dilate_get(values);
-}
+    uint8_t* dst = (uint8_t*)dst_;
+    uint32_t x;
 
-static uint8_t dilate3x3_calculate_replicate(CT_Image src, uint32_t x_, uint32_t y_)
-{
-    int32_t x = (int)x_;
-    int32_t y = (int)y_;
-    int32_t values[9] = {
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y + 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y + 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y + 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y + 1)
-    };
-    return (uint8_t)dilate_get(values);
-}
-
-static uint8_t dilate3x3_calculate_constant(CT_Image src, uint32_t x_, uint32_t y_, vx_uint32 constant_value)
-{
-    int32_t x = (int)x_;
-    int32_t y = (int)y_;
-    int32_t values[9] = {
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y + 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y + 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y + 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y + 1, constant_value)
-    };
-    return (uint8_t)dilate_get(values);
+    for (x = 0; x < width; x++)
+    {
+        const uint8_t* s = src + x;
+        int32_t values[9] = {
+            (int32_t)s[0],
+            (int32_t)s[-1],
+            (int32_t)s[1],
+            (int32_t)s[-stride],
+            (int32_t)s[-stride - 1],
+            (int32_t)s[-stride + 1],
+            (int32_t)s[stride],
+            (int32_t)s[stride - 1],
+            (int32_t)s[stride + 1]
+        };
+        dst[x] = (uint8_t)dilate_get(values);
+    }
 }
 
 
 static CT_Image dilate3x3_create_reference_image(CT_Image src, vx_border_t border)
 {
-    CT_Image dst;
-
     CT_ASSERT_(return NULL, src->format == VX_DF_IMAGE_U8);
+    ASSERT_(return NULL, border.mode == VX_BORDER_UNDEFINED || border.mode == VX_BORDER_REPLICATE || border.mode == VX_BORDER_CONSTANT);
 
-    dst = ct_allocate_image(src->width, src->height, src->format);
-
-    if (border.mode == VX_BORDER_UNDEFINED)
-    {
-        CT_FILL_IMAGE_8U(return 0, dst,
-                if (x >= 1 && y >= 1 && x < src->width - 1 && y < src->height - 1)
-                {
-                    uint8_t res = dilate3x3_calculate(src, x, y);
-                    *dst_data = res;
-                });
-    }
-    else if (border.mode == VX_BORDER_REPLICATE)
-    {
-        CT_FILL_IMAGE_8U(return 0, dst,
-                {
-                    uint8_t res = dilate3x3_calculate_replicate(src, x, y);
-                    *dst_data = res;
-                });
-    }
-    else if (border.mode == VX_BORDER_CONSTANT)
-    {
-        vx_uint32 constant_value = border.constant_value.U32;
-        CT_FILL_IMAGE_8U(return 0, dst,
-                {
-                    uint8_t res = dilate3x3_calculate_constant(src, x, y, constant_value);
-                    *dst_data = res;
-                });
-    }
-    else
-    {
-        ASSERT_(return 0, 0);
-    }
-    return dst;
+    return ct_filter_image_8u(src, border, 1, VX_DF_IMAGE_U8, dilate3x3_calculate_row, NULL);
 }
 
 
@@ -219,7 +172,10 @@ typedef struct {
 
 #define PARAMETERS \
     CT_GENERATE_PARAMETERS("randomInput", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_SMALL_SET, ARG, dilate3x3_generate_random, NULL), \
-    CT_GENERATE_PARAMETERS("lena", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_NONE, ARG, dilate3x3_read_image, "lena.bmp")
+    CT_GENERATE_PARAMETERS("lena", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_NONE, ARG, dilate3x3_read_image, "lena.bmp"), \
+    ARG_PRODUCTION_BEGIN(), \
+    CT_GENERATE_PARAMETERS("randomInput", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_PRODUCTION_SET, ARG, dilate3x3_generate_random_keyed, NULL), \
+    ARG_PRODUCTION_END()
 
 TEST_WITH_ARG(Dilate3x3, testGraphProcessing, Arg,
     PARAMETERS
@@ -128,127 +128,57 @@ static int32_t gaussian5x5_pyramid_get(int32_t *values)
     return res;
 }
 
-static uint8_t gaussian5x5_pyramid_calculate(CT_Image src, uint32_t x, uint32_t y)
+static void gaussian5x5_pyramid_calculate_row(const uint8_t* src, int32_t stride, void* dst_, uint32_t width, void* user_data)
 {
-    int32_t values[25] = {
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 2, y - 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y - 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y - 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y - 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 2, y - 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 2, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 2, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 2, y - 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y - 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y - 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y - 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 2, y - 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 2, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 2, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 2, y + 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y + 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y + 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y + 2),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 2, y + 2),
-    };
-    return (uint8_t)gaussian5x5_pyramid_get(values);
-}
+    uint8_t* dst = (uint8_t*)dst_;
+    uint32_t x;
 
-static uint8_t gaussian5x5_calculate_replicate(CT_Image src, uint32_t x_, uint32_t y_)
-{
-    int32_t x = (int)x_;
-    int32_t y = (int)y_;
-    int32_t values[25] = {
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 2, y - 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y - 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y - 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y - 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 2, y - 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 2, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 2, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 2, y - 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y - 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y - 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y - 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 2, y - 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 2, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 2, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 2, y + 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y + 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y + 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y + 2),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 2, y + 2),
-    };
-    return (uint8_t)gaussian5x5_pyramid_get(values);
+    for (x = 0; x < width; x++)
+    {
+        int32_t values[25];
+        int dx, dy, i = 0;
+        for (dy = -2; dy <= 2; dy++)
+        {
+            for (dx = -2; dx <= 2; dx++)
+                values[i++] = (int32_t)src[dy * stride + (int32_t)x + dx];
+        }
+        dst[x] = (uint8_t)gaussian5x5_pyramid_get(values);
+    }
 }
 
-static uint8_t gaussian5x5_calculate_constant(CT_Image src, uint32_t x_, uint32_t y_, vx_uint32 constant_value)
+// blurs the whole level once, the result is also valid for one pixel outside of the level
+// (candidates of the nearest neighbor lookup); VX_BORDER_UNDEFINED is computed as replicated
+static CT_Image gaussian5x5_pyramid_blur(CT_Image src, vx_border_t border)
 {
-    int32_t x = (int)x_;
-    int32_t y = (int)y_;
-    int32_t values[25] = {
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 2, y - 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y - 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y - 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y - 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 2, y - 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 2, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 2, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 2, y - 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y - 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y - 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y - 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 2, y - 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 2, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 2, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 2, y + 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y + 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y + 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y + 2, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 2, y + 2, constant_value),
-    };
-    return (uint8_t)gaussian5x5_pyramid_get(values);
+    CT_Image padded = NULL, blurred = NULL;
+
+    ASSERT_NO_FAILURE_(return NULL, padded = ct_image_make_padded(src, border, 1));
+    ASSERT_NO_FAILURE_(return NULL, ct_adjust_roi(padded, -1, -1, -1, -1));
+
+    ASSERT_NO_FAILURE_(return NULL, blurred = ct_filter_image_8u(padded, border, 2, VX_DF_IMAGE_U8, gaussian5x5_pyramid_calculate_row, NULL));
+    ASSERT_NO_FAILURE_(return NULL, ct_adjust_roi(blurred, 1, 1, 1, 1));
+
+    return blurred;
 }
 
-static vx_int32 gaussian_pyramid_get_pixel(CT_Image input, int x, int y, vx_border_t border, int level)
+static vx_int32 gaussian_pyramid_get_pixel(CT_Image input, CT_Image blurred, int x, int y, vx_border_t border, int level)
 {
     if (border.mode == VX_BORDER_UNDEFINED)
     {
         if (x >= 2 + level && y >= 2 + level && x < (int)input->width - 2 - level && y < (int)input->height - 2 - level)
-            return gaussian5x5_pyramid_calculate(input, x, y);
+            return *CT_IMAGE_DATA_PTR_8U(blurred, x, y);
         else
             return -1;
     }
-    else if (border.mode == VX_BORDER_REPLICATE)
-    {
-        return gaussian5x5_calculate_replicate(input, x, y);
-    }
-    else if (border.mode == VX_BORDER_CONSTANT)
+    else if (border.mode == VX_BORDER_REPLICATE || border.mode == VX_BORDER_CONSTANT)
     {
-        return gaussian5x5_calculate_constant(input, x, y, border.constant_value.U32);
+        CT_ASSERT_(return -1, x >= -1 && y >= -1 && x <= (int)input->width && y <= (int)input->height);
+        return *CT_IMAGE_DATA_PTR_PADDED_8U(blurred, x, y);
     }
     CT_FAIL_(return -1, "NOT IMPLEMENTED");
 }
 
-static void gaussian_pyramid_check_pixel(CT_Image input, CT_Image output, int x, int y, vx_border_t border, int level)
+static void gaussian_pyramid_check_pixel(CT_Image input, CT_Image blurred, CT_Image output, int x, int y, vx_border_t border, int level)
 {
     vx_uint8 res = *CT_IMAGE_DATA_PTR_8U(output, x, y);
 
@@ -261,7 +191,7 @@ static void gaussian_pyramid_check_pixel(CT_Image input, CT_Image output, int x,
         for (sx = 0; sx <= 1; sx++)
         {
             vx_int32 candidate = 0;
-            ASSERT_NO_FAILURE_(return, candidate = gaussian_pyramid_get_pixel(input, x_min + sx, y_min + sy, border, level));
+            ASSERT_NO_FAILURE_(return, candidate = gaussian_pyramid_get_pixel(input, blurred, x_min + sx, y_min + sy, border, level));
             if (candidate == -1 || abs(candidate - res) <= VX_GAUSSIAN_PYRAMID_TOLERANCE)
                 return;
         }
@@ -278,9 +208,11 @@ static void gaussian_pyramid_check_image(CT_Image input, CT_Image output, vx_bor
     }
     else
     {
+        CT_Image blurred = NULL;
+        ASSERT_NO_FAILURE(blurred = gaussian5x5_pyramid_blur(input, border));
         CT_FILL_IMAGE_8U(, output,
                 {
-                    ASSERT_NO_FAILURE(gaussian_pyramid_check_pixel(input, output, x, y, border, (int)level));
+                    ASSERT_NO_FAILURE(gaussian_pyramid_check_pixel(input, blurred, output, x, y, border, (int)level));
                 });
     }
 }
@@ -372,7 +304,7 @@ static void gaussian_pyramid_check(CT_Image input, vx_pyramid pyr, vx_size level
 
 
 
-static vx_uint8 gaussian_pyramid_reference_get_pixel(CT_Image prevLevel, int dst_width, int dst_height, int x, int y, vx_border_t border, int level)
+static vx_uint8 gaussian_pyramid_reference_get_pixel(CT_Image prevLevel, CT_Image blurred, int dst_width, int dst_height, int x, int y, vx_border_t border, int level)
 {
     vx_int32 candidate = -1;
     vx_float64 x_src = (((vx_float64)x + 0.5) * (vx_float64)prevLevel->width / (vx_float64)dst_width) - 0.5;
@@ -387,7 +319,7 @@ static vx_uint8 gaussian_pyramid_reference_get_pixel(CT_Image prevLevel, int dst
         x_int = prevLevel->width - 1;
     if (y_int >= (int)prevLevel->height)
         y_int = prevLevel->height - 1;
-    ASSERT_NO_FAILURE_(return 0, candidate = gaussian_pyramid_get_pixel(prevLevel, x_int, y_int, border, level));
+    ASSERT_NO_FAILURE_(return 0, candidate = gaussian_pyramid_get_pixel(prevLevel, blurred, x_int, y_int, border, level));
     if (candidate == -1)
         return 0;
     return CT_CAST_U8(candidate);
@@ -436,9 +368,11 @@ static CT_Image gaussian_pyramid_create_reference_image(CT_Image input, CT_Image
     }
     else
     {
+        CT_Image blurred = NULL;
+        ASSERT_NO_FAILURE_(return 0, blurred = gaussian5x5_pyramid_blur(prevLevel, border));
         CT_FILL_IMAGE_8U(return 0, dst,
                 {
-                    uint8_t res = gaussian_pyramid_reference_get_pixel(prevLevel, dst_width, dst_height, x, y, border, (int)target_level);
+                    uint8_t res = gaussian_pyramid_reference_get_pixel(prevLevel, blurred, dst_width, dst_height, x, y, border, (int)target_level);
                     *dst_data = res;
                 });
     }
@@ -446,6 +380,9 @@ static CT_Image gaussian_pyramid_create_reference_image(CT_Image input, CT_Image
     return dst;
 }
 
+// bump GAUSSIAN_PYRAMID_REFERENCE_VERSION when gaussian_pyramid_create_reference_image() output changes
+#define GAUSSIAN_PYRAMID_REFERENCE_VERSION 1
+
 void gaussian_pyramid_fill_reference(CT_Image input, vx_pyramid pyr, vx_size levels, vx_float32 scale, vx_border_t border)
 {
     vx_uint32 level = 0;
@@ -454,8 +391,16 @@ void gaussian_pyramid_fill_reference(CT_Image input, vx_pyramid pyr, vx_size lev
     CT_Image  output_cur   = NULL;
     vx_uint32 ref_width    = input->width;
     vx_uint32 ref_height   = input->height;
+    CT_RefCacheKey key, level_key;
 
     ASSERT(input && pyr && (levels < sizeof(c_orbscale) / sizeof(float) ));
+
+    // every level depends only on the input and the parameters
+    ct_ref_cache_key_init(&key, "gaussian_pyramid", GAUSSIAN_PYRAMID_REFERENCE_VERSION);
+    ct_ref_cache_key_add_image(&key, input);
+    ct_ref_cache_key_add(&key, &scale, sizeof(scale));
+    ct_ref_cache_key_add_int(&key, border.mode);
+    ct_ref_cache_key_add_int(&key, border.constant_value.U8);
     ASSERT_VX_OBJECT(output_image = vxGetPyramidLevel(pyr, 0), VX_TYPE_IMAGE);
     ASSERT_NO_FAILURE(output_prev = ct_image_from_vx_image(output_image));
 
@@ -492,7 +437,15 @@ void gaussian_pyramid_fill_reference(CT_Image input, vx_pyramid pyr, vx_size lev
             }
         }
 
-        ASSERT_NO_FAILURE(output_cur = gaussian_pyramid_create_reference_image(input, output_prev, border, scale, level));
+        level_key = key;
+        ct_ref_cache_key_add_int(&level_key, level);
+        ct_ref_cache_key_add_int(&level_key, output_cur->width);
+        ct_ref_cache_key_add_int(&level_key, output_cur->height);
+        if (!ct_ref_cache_load_image(&level_key, output_cur))
+        {
+            ASSERT_NO_FAILURE(output_cur = gaussian_pyramid_create_reference_image(input, output_prev, border, scale, level));
+            ct_ref_cache_store_image(&level_key, output_cur);
+        }
         ASSERT_NO_FAILURE(ct_image_copyto_vx_image(output_image, output_cur));
 
         VX_CALL(vxReleaseImage(&output_image));
@@ -1799,6 +1799,162 @@ TEST_WITH_ARG(Graph, testReplicateNode, Test_Replicate_Arg, TEST_REPLICATE_PARAM
 }
 
 
+typedef struct
+{
+    const char* testName;
+    int width;
+    int height;
+    vx_size max_items;
+} Test_Replicate_Scaling_Arg;
+
+// steady-state processing of every replica count is measured only with --benchmark
+#define REPLICATE_SCALING_ITERATIONS 5
+
+/* checks that every item of 'output' is saturate(item of 'input' + addend), without allocating CT images per item */
+static void check_replicate_add(vx_object_array input, vx_object_array output, vx_size items, vx_uint8 addend)
+{
+    vx_uint32 i, x, y;
+
+    for (i = 0; i < items; i++)
+    {
+        vx_image src = 0, dst = 0;
+        vx_rectangle_t rect;
+        vx_map_id src_map_id, dst_map_id;
+        vx_imagepatch_addressing_t src_addr, dst_addr;
+        void *src_base = NULL, *dst_base = NULL;
+        vx_uint32 width = 0, height = 0;
+        int num_failed = 0;
+
+        ASSERT_VX_OBJECT(src = (vx_image)vxGetObjectArrayItem(input, i), VX_TYPE_IMAGE);
+        ASSERT_VX_OBJECT(dst = (vx_image)vxGetObjectArrayItem(output, i), VX_TYPE_IMAGE);
+
+        VX_CALL(vxQueryImage(src, VX_IMAGE_WIDTH, &width, sizeof(width)));
+        VX_CALL(vxQueryImage(src, VX_IMAGE_HEIGHT, &height, sizeof(height)));
+        rect.start_x = rect.start_y = 0;
+        rect.end_x = width;
+        rect.end_y = height;
+
+        VX_CALL(vxMapImagePatch(src, &rect, 0, &src_map_id, &src_addr, &src_base, VX_READ_ONLY, VX_MEMORY_TYPE_HOST, 0));
+        VX_CALL(vxMapImagePatch(dst, &rect, 0, &dst_map_id, &dst_addr, &dst_base, VX_READ_ONLY, VX_MEMORY_TYPE_HOST, 0));
+
+        for (y = 0; y < height && num_failed == 0; y++)
+        {
+            for (x = 0; x < width; x++)
+            {
+                vx_uint8 s = *(vx_uint8*)vxFormatImagePatchAddress2d(src_base, x, y, &src_addr);
+                vx_uint8 d = *(vx_uint8*)vxFormatImagePatchAddress2d(dst_base, x, y, &dst_addr);
+                vx_uint8 expected = (vx_uint8)CT_MIN(255, s + addend);
+                if (d != expected)
+                {
+                    CT_ADD_FAILURE("Replica %u differs at (%u, %u): %d, expected %d", i, x, y, (int)d, (int)expected);
+                    num_failed++;
+                    break;
+                }
+            }
+        }
+
+        VX_CALL(vxUnmapImagePatch(dst, dst_map_id));
+        VX_CALL(vxUnmapImagePatch(src, src_map_id));
+        VX_CALL(vxReleaseImage(&dst));
+        VX_CALL(vxReleaseImage(&src));
+
+        if (num_failed)
+            return;
+    }
+}
+
+/*
+    Replicates an Add node over object arrays of 1, 2, 4, ... max_items images and reports the
+    processing time per item relative to a single item. An implementation that processes
+    replicas in parallel shows a time per item well below the single item time.
+    The 1920x1080 variant with 256 items needs about 1 GB for the two object arrays.
+    Without --benchmark only max_items replicas are processed once and checked.
+*/
+TEST_WITH_ARG(Graph, testReplicateNodeScaling, Test_Replicate_Scaling_Arg,
+    ARG("sz=640x480/REPLICAS=1..16", 640, 480, 16),
+    ARG_PRODUCTION_BEGIN(),
+    ARG("sz=1920x1080/REPLICAS=1..256", 1920, 1080, 256),
+    ARG_PRODUCTION_END()
+)
+{
+    vx_context context = context_->vx_context_;
+    vx_pixel_value_t value = {{ 2 }};
+    vx_image addend = 0;
+    CT_Image src = 0;
+    vx_size items;
+    double single_item_ms = 0;
+
+    ASSERT_NO_FAILURE(src = ct_allocate_ct_image_random_keyed(arg_->width, arg_->height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    ASSERT_VX_OBJECT(addend = vxCreateUniformImage(context, arg_->width, arg_->height, VX_DF_IMAGE_U8, &value), VX_TYPE_IMAGE);
+
+    for (items = ct_check_benchmark() ? 1 : arg_->max_items; items <= arg_->max_items; items *= 2)
+    {
+        vx_image exemplar = 0, src1 = 0, dst = 0;
+        vx_object_array input = 0, output = 0;
+        vx_graph graph = 0;
+        vx_node node = 0;
+        vx_bool replicate[] = { vx_true_e, vx_false_e, vx_false_e, vx_true_e };
+        vx_size i;
+        int iter;
+        int64_t time_start;
+        double first_ms, steady_ms;
+
+        ASSERT_VX_OBJECT(exemplar = ct_image_to_vx_image(src, context), VX_TYPE_IMAGE);
+        ASSERT_VX_OBJECT(input = vxCreateObjectArray(context, (vx_reference)exemplar, items), VX_TYPE_OBJECT_ARRAY);
+        ASSERT_VX_OBJECT(output = vxCreateObjectArray(context, (vx_reference)exemplar, items), VX_TYPE_OBJECT_ARRAY);
+
+        /* item i is the source image shifted by i, so that every replica gets different data */
+        for (i = 0; i < items; i++)
+        {
+            vx_image item = 0, shift = 0;
+            value.U8 = (vx_uint8)i;
+            ASSERT_VX_OBJECT(shift = vxCreateUniformImage(context, arg_->width, arg_->height, VX_DF_IMAGE_U8, &value), VX_TYPE_IMAGE);
+            ASSERT_VX_OBJECT(item = (vx_image)vxGetObjectArrayItem(input, (vx_uint32)i), VX_TYPE_IMAGE);
+            VX_CALL(vxuAdd(context, exemplar, shift, VX_CONVERT_POLICY_WRAP, item));
+            VX_CALL(vxReleaseImage(&item));
+            VX_CALL(vxReleaseImage(&shift));
+        }
+        VX_CALL(vxReleaseImage(&exemplar));
+
+        ASSERT_VX_OBJECT(src1 = (vx_image)vxGetObjectArrayItem(input, 0), VX_TYPE_IMAGE);
+        ASSERT_VX_OBJECT(dst = (vx_image)vxGetObjectArrayItem(output, 0), VX_TYPE_IMAGE);
+
+        ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+        ASSERT_VX_OBJECT(node = vxAddNode(graph, src1, addend, VX_CONVERT_POLICY_SATURATE, dst), VX_TYPE_NODE);
+        VX_CALL(vxReplicateNode(graph, node, replicate, 4));
+        VX_CALL(vxVerifyGraph(graph));
+
+        time_start = CT_getTickCount();
+        VX_CALL(vxProcessGraph(graph));
+        first_ms = CT_getElapsedMs(time_start);
+        if (ct_check_benchmark())
+        {
+            time_start = CT_getTickCount();
+            for (iter = 0; iter < REPLICATE_SCALING_ITERATIONS; iter++)
+                VX_CALL(vxProcessGraph(graph));
+            steady_ms = CT_getElapsedMs(time_start) / REPLICATE_SCALING_ITERATIONS;
+            if (items == 1)
+                single_item_ms = steady_ms;
+            CT_TIME_PRINTF("    replicas=%d: first process %.2f ms, steady process %.2f ms, %.3f ms/item, %.2fx of single item time per item\n",
+                           (int)items, first_ms, steady_ms, steady_ms / items,
+                           single_item_ms > 0 ? steady_ms / items / single_item_ms : 0.);
+        }
+
+        ASSERT_NO_FAILURE(check_replicate_add(input, output, items, 2));
+
+        VX_CALL(vxReleaseNode(&node));
+        VX_CALL(vxReleaseGraph(&graph));
+        VX_CALL(vxReleaseImage(&dst));
+        VX_CALL(vxReleaseImage(&src1));
+        VX_CALL(vxReleaseObjectArray(&output));
+        VX_CALL(vxReleaseObjectArray(&input));
+    }
+
+    VX_CALL(vxReleaseImage(&addend));
+}
+
+
+
 static void test_halfscalegaussian(vx_context context)
 {
     vx_uint32 nrefs_before = 0;
@@ -2356,6 +2512,7 @@ TESTCASE_TESTS(Graph,
         testAllocateUserKernelId,
         testAllocateUserKernelLibraryId,
         testReplicateNode,
+        testReplicateNodeScaling,
         testImageContainmentRelationship,
         testVerifyGraphLeak,
         testGraphState
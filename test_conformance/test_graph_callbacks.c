@@ -194,9 +194,92 @@ TEST_WITH_ARG(GraphCallback, testCallbackOrder, Arg,
     ASSERT(dst_image == 0); ASSERT(interm_image == 0); ASSERT(src_image == 0);
 }
 
+static vx_uint32 own_cb_count = 0;
+static vx_action VX_CALLBACK own_node_callback_count(vx_node node)
+{
+    own_cb_count++;
+    return VX_ACTION_CONTINUE;
+}
+
+typedef struct {
+    const char* testName;
+    int num_nodes;
+    int iterations;
+} overhead_arg;
+
+/*
+    Per-frame cost of node callbacks: a chain of Not nodes on a small image is processed
+    'iterations' times without callbacks, then with a counting callback on every node.
+    Without --benchmark only a few frames are processed to check the callback count.
+*/
+#define CALLBACK_CHECK_ITERATIONS 4
+
+TEST_WITH_ARG(GraphCallback, testCallbackOverhead, overhead_arg,
+        CT_ARG("NODES=1/ITERATIONS=1000", 1, 1000),
+        CT_ARG("NODES=8/ITERATIONS=1000", 8, 1000),
+        CT_ARG("NODES=32/ITERATIONS=1000", 32, 1000)
+        )
+{
+    vx_context context = context_->vx_context_;
+    vx_image images[33];
+    vx_node nodes[32];
+    vx_graph graph = 0;
+    int num_nodes = arg_->num_nodes, i;
+    int iterations = ct_check_benchmark() ? arg_->iterations : CT_MIN(arg_->iterations, CALLBACK_CHECK_ITERATIONS);
+    int64_t time_start;
+    double plain_ms, callback_ms;
+
+    ASSERT(num_nodes + 1 <= (int)(sizeof(images) / sizeof(images[0])));
+
+    for (i = 0; i <= num_nodes; i++)
+        ASSERT_VX_OBJECT(images[i] = vxCreateImage(context, 64, 48, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+    ASSERT_NO_FAILURE(ct_fill_image_random(images[0], &CT()->seed_));
+
+    ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+    for (i = 0; i < num_nodes; i++)
+        ASSERT_VX_OBJECT(nodes[i] = vxNotNode(graph, images[i], images[i + 1]), VX_TYPE_NODE);
+
+    VX_CALL(vxVerifyGraph(graph));
+    VX_CALL(vxProcessGraph(graph)); // warm-up
+
+    time_start = CT_getTickCount();
+    for (i = 0; i < iterations; i++)
+        VX_CALL(vxProcessGraph(graph));
+    plain_ms = CT_getElapsedMs(time_start);
+
+    for (i = 0; i < num_nodes; i++)
+        VX_CALL(vxAssignNodeCallback(nodes[i], own_node_callback_count));
+
+    own_cb_count = 0;
+    time_start = CT_getTickCount();
+    for (i = 0; i < iterations; i++)
+        VX_CALL(vxProcessGraph(graph));
+    callback_ms = CT_getElapsedMs(time_start);
+    if (ct_check_benchmark())
+        CT_TIME_PRINTF("    per frame: %.2f us without callbacks, %.2f us with callbacks, overhead %.3f us per callback\n",
+                       plain_ms * 1000. / iterations, callback_ms * 1000. / iterations,
+                       (callback_ms - plain_ms) * 1000. / ((double)iterations * num_nodes));
+
+    ASSERT_EQ_INT(num_nodes * iterations, own_cb_count);
+
+    for (i = 0; i < num_nodes; i++)
+    {
+        VX_CALL(vxReleaseNode(&nodes[i]));
+        ASSERT(nodes[i] == 0);
+    }
+    VX_CALL(vxReleaseGraph(&graph));
+    for (i = 0; i <= num_nodes; i++)
+    {
+        VX_CALL(vxReleaseImage(&images[i]));
+        ASSERT(images[i] == 0);
+    }
+    ASSERT(graph == 0);
+}
+
 
 TESTCASE_TESTS(GraphCallback,
         testContinue,
         testAbandon,
-        testCallbackOrder
+        testCallbackOrder,
+        testCallbackOverhead
         )
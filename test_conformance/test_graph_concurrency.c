@@ -0,0 +1,199 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_engine/test.h"
+#include <VX/vx.h>
+#include <VX/vxu.h>
+#include <string.h>
+
+#include "shared_functions.h"
+
+TESTCASE(GraphConcurrency, CT_VXContext, ct_setup_vx_context, 0)
+
+#define CONCURRENCY_MAX_THREADS 8
+// without --benchmark only CONCURRENCY_MAX_THREADS streams process this many frames each
+#define CONCURRENCY_CHECK_ITERATIONS 2
+
+typedef struct {
+    vx_context      shared_context; // NULL - every stream creates its own context
+    const uint8_t*  src_data;       // packed U8 frame, width * height
+    uint8_t*        dst_data[CONCURRENCY_MAX_THREADS];
+    vx_status       status[CONCURRENCY_MAX_THREADS];
+    int             width, height;
+    int             iterations;
+} concurrency_job;
+
+/*
+    One "camera stream": builds its own Box3x3 graph, processes it repeatedly and
+    reads back the last output. Runs on a worker thread, so errors are returned as status.
+*/
+static vx_status concurrency_run_stream(concurrency_job* job, int idx)
+{
+    vx_context context = job->shared_context ? job->shared_context : vxCreateContext();
+    vx_image src_image = 0, dst_image = 0;
+    vx_graph graph = 0;
+    vx_node node = 0;
+    vx_rectangle_t rect = { 0, 0, (vx_uint32)job->width, (vx_uint32)job->height };
+    vx_imagepatch_addressing_t addr = VX_IMAGEPATCH_ADDR_INIT;
+    vx_status status = vxGetStatus((vx_reference)context);
+    int i;
+
+    addr.dim_x = job->width;
+    addr.dim_y = job->height;
+    addr.stride_x = 1;
+    addr.stride_y = job->width;
+
+    if (status == VX_SUCCESS)
+    {
+        src_image = vxCreateImage(context, job->width, job->height, VX_DF_IMAGE_U8);
+        status = vxGetStatus((vx_reference)src_image);
+    }
+    if (status == VX_SUCCESS)
+    {
+        dst_image = vxCreateImage(context, job->width, job->height, VX_DF_IMAGE_U8);
+        status = vxGetStatus((vx_reference)dst_image);
+    }
+    if (status == VX_SUCCESS)
+        status = vxCopyImagePatch(src_image, &rect, 0, &addr, (void*)job->src_data, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
+    if (status == VX_SUCCESS)
+    {
+        graph = vxCreateGraph(context);
+        status = vxGetStatus((vx_reference)graph);
+    }
+    if (status == VX_SUCCESS)
+    {
+        node = vxBox3x3Node(graph, src_image, dst_image);
+        status = vxGetStatus((vx_reference)node);
+    }
+    if (status == VX_SUCCESS)
+        status = vxVerifyGraph(graph);
+    for (i = 0; i < job->iterations && status == VX_SUCCESS; i++)
+        status = vxProcessGraph(graph);
+    if (status == VX_SUCCESS)
+        status = vxCopyImagePatch(dst_image, &rect, 0, &addr, job->dst_data[idx], VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
+
+    if (node)
+        vxReleaseNode(&node);
+    if (graph)
+        vxReleaseGraph(&graph);
+    if (dst_image)
+        vxReleaseImage(&dst_image);
+    if (src_image)
+        vxReleaseImage(&src_image);
+    if (job->shared_context == NULL && vxGetStatus((vx_reference)context) == VX_SUCCESS)
+        vxReleaseContext(&context);
+
+    return status;
+}
+
+static void concurrency_thread(void* job_, int begin, int end)
+{
+    concurrency_job* job = (concurrency_job*)job_;
+    int i;
+    for (i = begin; i < end; i++)
+        job->status[i] = concurrency_run_stream(job, i);
+}
+
+typedef struct {
+    const char* testName;
+    vx_bool shared_context;
+    int width, height;
+    int iterations;
+} concurrency_arg;
+
+TEST_WITH_ARG(GraphConcurrency, testThroughput, concurrency_arg,
+    ARG("SharedContext/sz=640x480", vx_true_e, 640, 480, 20),
+    ARG("SeparateContexts/sz=640x480", vx_false_e, 640, 480, 20),
+    ARG_PRODUCTION_BEGIN(),
+    ARG("SharedContext/sz=1920x1080", vx_true_e, 1920, 1080, 10),
+    ARG("SeparateContexts/sz=1920x1080", vx_false_e, 1920, 1080, 10),
+    ARG_PRODUCTION_END()
+)
+{
+    vx_context context = context_->vx_context_;
+    vx_border_t border = { VX_BORDER_UNDEFINED, {{ 0 }} };
+    concurrency_job job;
+    CT_Image src = NULL, ref = NULL;
+    uint8_t* src_data = NULL;
+    int iterations = ct_check_benchmark() ? arg_->iterations : CT_MIN(arg_->iterations, CONCURRENCY_CHECK_ITERATIONS);
+    int num_threads, i, y;
+    double single_fps = 0;
+
+    ASSERT_NO_FAILURE(src = ct_allocate_ct_image_random_keyed(arg_->width, arg_->height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    // reference is computed once on the test thread
+    ASSERT_NO_FAILURE(ref = box3x3_create_reference_image(src, border));
+    ct_adjust_roi(ref, 1, 1, 1, 1);
+
+    src_data = (uint8_t*)ct_alloc_mem((size_t)arg_->width * arg_->height);
+    ASSERT(src_data);
+    for (y = 0; y < arg_->height; y++)
+        memcpy(src_data + (size_t)y * arg_->width, CT_IMAGE_DATA_PTR_8U(src, 0, y), arg_->width);
+
+    memset(&job, 0, sizeof(job));
+    job.shared_context = arg_->shared_context ? context : NULL;
+    job.src_data = src_data;
+    job.width = arg_->width;
+    job.height = arg_->height;
+    job.iterations = iterations;
+    for (i = 0; i < CONCURRENCY_MAX_THREADS; i++)
+    {
+        job.dst_data[i] = (uint8_t*)ct_alloc_mem((size_t)arg_->width * arg_->height);
+        ASSERT(job.dst_data[i]);
+    }
+
+    // the scaling from one stream up is measured only with --benchmark
+    for (num_threads = ct_check_benchmark() ? 1 : CONCURRENCY_MAX_THREADS; num_threads <= CONCURRENCY_MAX_THREADS; num_threads *= 2)
+    {
+        int64_t time_start = CT_getTickCount();
+        double time_ms, fps;
+
+        for (i = 0; i < num_threads; i++)
+            job.status[i] = VX_FAILURE;
+
+        ct_run_threads(num_threads, concurrency_thread, &job);
+
+        time_ms = CT_getElapsedMs(time_start);
+        fps = time_ms > 0 ? num_threads * iterations * 1000. / time_ms : 0;
+        if (num_threads == 1)
+            single_fps = fps;
+        if (ct_check_benchmark())
+            CT_TIME_PRINTF("    threads=%d: %.1f frames/s, %.2f ms/frame per stream, scaling %.2fx\n",
+                           num_threads, fps, time_ms / iterations, single_fps > 0 ? fps / single_fps : 0.);
+
+        for (i = 0; i < num_threads; i++)
+        {
+            CT_Image dst = NULL;
+
+            ASSERT_EQ_VX_STATUS(VX_SUCCESS, job.status[i]);
+
+            ASSERT_NO_FAILURE(dst = ct_allocate_image(arg_->width, arg_->height, VX_DF_IMAGE_U8));
+            for (y = 0; y < arg_->height; y++)
+                memcpy(CT_IMAGE_DATA_PTR_8U(dst, 0, y), job.dst_data[i] + (size_t)y * arg_->width, arg_->width);
+            ct_adjust_roi(dst, 1, 1, 1, 1);
+
+            EXPECT_CTIMAGE_NEAR(ref, dst, 1);
+        }
+    }
+
+    for (i = 0; i < CONCURRENCY_MAX_THREADS; i++)
+        ct_free_mem(job.dst_data[i]);
+    ct_free_mem(src_data);
+}
+
+TESTCASE_TESTS(GraphConcurrency,
+        testThroughput
+        )
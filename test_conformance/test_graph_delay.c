@@ -18,6 +18,7 @@
 #include "test_engine/test.h"
 #include <VX/vx.h>
 #include <VX/vxu.h>
+#include <string.h>
 
 TESTCASE(GraphDelay, CT_VXContext, ct_setup_vx_context, 0)
 
@@ -396,9 +397,113 @@ TEST(GraphDelay, testRegisterAutoAging)
     ASSERT(delay == 0);
 }
 
+static void own_fill_image_u8(vx_image image, vx_uint8 value)
+{
+    vx_rectangle_t rect = { 0, 0, 0, 0 };
+    vx_imagepatch_addressing_t addr = VX_IMAGEPATCH_ADDR_INIT;
+    vx_uint8* data = NULL;
+
+    VX_CALL(vxQueryImage(image, VX_IMAGE_WIDTH, &rect.end_x, sizeof(rect.end_x)));
+    VX_CALL(vxQueryImage(image, VX_IMAGE_HEIGHT, &rect.end_y, sizeof(rect.end_y)));
+
+    data = (vx_uint8*)ct_alloc_mem(rect.end_x * rect.end_y);
+    ASSERT(data);
+    memset(data, value, rect.end_x * rect.end_y);
+
+    addr.dim_x = rect.end_x;
+    addr.dim_y = rect.end_y;
+    addr.stride_x = 1;
+    addr.stride_y = rect.end_x;
+    VX_CALL(vxCopyImagePatch(image, &rect, 0, &addr, data, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST));
+
+    ct_free_mem(data);
+}
+
+typedef struct {
+    const char* testName;
+    vx_size slots;
+    int iterations;
+} aging_arg;
+
+/*
+    Per-frame cost of auto-aging: a temporal accumulator slot[0] = input + slot[-1] over a delay
+    of 'slots' small images is processed 'iterations' times without and then with auto-aging.
+    With input 1 and zeroed slots, slot[-1] holds the frame count (mod 256) after aging.
+    Without --benchmark the frames are only enough to age every slot a few times.
+*/
+#define AGING_CHECK_ITERATIONS 40
+
+TEST_WITH_ARG(GraphDelay, testAutoAgingOverhead, aging_arg,
+    ARG("SLOTS=2/ITERATIONS=2000", 2, 2000),
+    ARG("SLOTS=4/ITERATIONS=2000", 4, 2000),
+    ARG("SLOTS=8/ITERATIONS=2000", 8, 2000),
+    ARG("SLOTS=16/ITERATIONS=2000", 16, 2000)
+    )
+{
+    int i, w = 64, h = 48;
+    int iterations = ct_check_benchmark() ? arg_->iterations : CT_MIN(arg_->iterations, AGING_CHECK_ITERATIONS);
+    vx_context context = context_->vx_context_;
+    vx_graph graph = 0;
+    vx_image input = 0, exemplar = 0;
+    vx_delay delay = 0;
+    vx_node node = 0;
+    CT_Image last = NULL;
+    vx_size slot;
+    int64_t time_start;
+    double plain_ms, aging_ms;
+
+    ASSERT_VX_OBJECT(input = vxCreateImage(context, w, h, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(exemplar = vxCreateImage(context, w, h, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(delay = vxCreateDelay(context, (vx_reference)exemplar, arg_->slots), VX_TYPE_DELAY);
+    VX_CALL(vxReleaseImage(&exemplar));
+
+    ASSERT_NO_FAILURE(own_fill_image_u8(input, 1));
+
+    ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+    ASSERT_VX_OBJECT(node = vxAddNode(graph, input, (vx_image)vxGetReferenceFromDelay(delay, -1), VX_CONVERT_POLICY_WRAP,
+                                      (vx_image)vxGetReferenceFromDelay(delay, 0)), VX_TYPE_NODE);
+    VX_CALL(vxVerifyGraph(graph));
+    VX_CALL(vxProcessGraph(graph)); // warm-up
+
+    time_start = CT_getTickCount();
+    for (i = 0; i < iterations; i++)
+        VX_CALL(vxProcessGraph(graph));
+    plain_ms = CT_getElapsedMs(time_start);
+
+    for (slot = 0; slot < arg_->slots; slot++)
+        ASSERT_NO_FAILURE(own_fill_image_u8((vx_image)vxGetReferenceFromDelay(delay, -(vx_int32)slot), 0));
+
+    VX_CALL(vxRegisterAutoAging(graph, delay));
+    VX_CALL(vxVerifyGraph(graph));
+
+    time_start = CT_getTickCount();
+    for (i = 0; i < iterations; i++)
+        VX_CALL(vxProcessGraph(graph));
+    aging_ms = CT_getElapsedMs(time_start);
+    if (ct_check_benchmark())
+        CT_TIME_PRINTF("    per frame: %.2f us without auto-aging, %.2f us with auto-aging, overhead %.3f us\n",
+                       plain_ms * 1000. / iterations, aging_ms * 1000. / iterations,
+                       (aging_ms - plain_ms) * 1000. / iterations);
+
+    ASSERT_NO_FAILURE(last = ct_image_from_vx_image((vx_image)vxGetReferenceFromDelay(delay, -1)));
+    EXPECT_EQ_INT(iterations % 256, *CT_IMAGE_DATA_PTR_8U(last, 0, 0));
+    EXPECT_EQ_INT(iterations % 256, *CT_IMAGE_DATA_PTR_8U(last, w - 1, h - 1));
+
+    VX_CALL(vxReleaseNode(&node));
+    VX_CALL(vxReleaseGraph(&graph));
+    VX_CALL(vxReleaseDelay(&delay));
+    VX_CALL(vxReleaseImage(&input));
+
+    ASSERT(node == 0);
+    ASSERT(graph == 0);
+    ASSERT(delay == 0);
+    ASSERT(input == 0);
+}
+
 TESTCASE_TESTS(
     GraphDelay,
     testSimple,
     testPyramid,
-    testRegisterAutoAging
+    testRegisterAutoAging,
+    testAutoAgingOverhead
     )
@@ -18,6 +18,7 @@
 #include "test_engine/test.h"
 #include <VX/vx.h>
 #include <VX/vxu.h>
+#include <string.h>
 
 TESTCASE(GraphROI, CT_VXContext, ct_setup_vx_context, 0)
 
@@ -151,3 +152,187 @@ TESTCASE_TESTS(GraphROI,
         testSimple,
         testCallbackOrder
         )
+
+
+TESTCASE(GraphROITiled, CT_VXContext, ct_setup_vx_context, 0)
+
+typedef vx_node (*tiled_node_fn)(vx_graph graph, vx_image input, vx_image output);
+
+static vx_node tiled_box3x3_node(vx_graph graph, vx_image input, vx_image output) { return vxBox3x3Node(graph, input, output); }
+static vx_node tiled_gaussian3x3_node(vx_graph graph, vx_image input, vx_image output) { return vxGaussian3x3Node(graph, input, output); }
+static vx_node tiled_median3x3_node(vx_graph graph, vx_image input, vx_image output) { return vxMedian3x3Node(graph, input, output); }
+static vx_node tiled_dilate3x3_node(vx_graph graph, vx_image input, vx_image output) { return vxDilate3x3Node(graph, input, output); }
+static vx_node tiled_erode3x3_node(vx_graph graph, vx_image input, vx_image output) { return vxErode3x3Node(graph, input, output); }
+
+// all kernels are 3x3 filters, tiles are extended by this margin to produce the same result at tile edges
+#define TILED_KERNEL_RADIUS 1
+
+typedef struct {
+    const char* testName;
+    tiled_node_fn node_fn;
+    int tiles_x, tiles_y;
+    int width, height;
+} tiled_arg;
+
+#define ADD_TILED_KERNELS(testArgName, nextmacro, ...) \
+    CT_EXPAND(nextmacro(testArgName "/Box3x3", __VA_ARGS__, tiled_box3x3_node)), \
+    CT_EXPAND(nextmacro(testArgName "/Gaussian3x3", __VA_ARGS__, tiled_gaussian3x3_node)), \
+    CT_EXPAND(nextmacro(testArgName "/Median3x3", __VA_ARGS__, tiled_median3x3_node)), \
+    CT_EXPAND(nextmacro(testArgName "/Dilate3x3", __VA_ARGS__, tiled_dilate3x3_node)), \
+    CT_EXPAND(nextmacro(testArgName "/Erode3x3", __VA_ARGS__, tiled_erode3x3_node))
+
+#define ADD_TILE_GRID(testArgName, nextmacro, ...) \
+    CT_EXPAND(nextmacro(testArgName "/tiles=2x2", __VA_ARGS__, 2, 2)), \
+    CT_EXPAND(nextmacro(testArgName "/tiles=4x3", __VA_ARGS__, 4, 3)), \
+    CT_EXPAND(nextmacro(testArgName "/tiles=8x8", __VA_ARGS__, 8, 8))
+
+typedef struct {
+    vx_graph*  graphs;
+    vx_status* status;
+} tiled_job;
+
+// executed by the reference thread pool, every tile is an independent graph of the same context
+static void tiled_process_graphs(void* job_, int begin, int end)
+{
+    tiled_job* job = (tiled_job*)job_;
+    int i;
+    for (i = begin; i < end; i++)
+        job->status[i] = vxProcessGraph(job->graphs[i]);
+}
+
+TEST_WITH_ARG(GraphROITiled, testStitchedEqualsFullFrame, tiled_arg,
+    CT_GENERATE_PARAMETERS("random", ADD_TILED_KERNELS, ADD_TILE_GRID, ADD_SIZE_SMALL_SET, ARG),
+    ARG_PRODUCTION_BEGIN(),
+    CT_GENERATE_PARAMETERS("random", ADD_TILED_KERNELS, ADD_TILE_GRID, ADD_SIZE_PRODUCTION_SET, ARG),
+    ARG_PRODUCTION_END()
+)
+{
+    vx_context context = context_->vx_context_;
+    int num_tiles = arg_->tiles_x * arg_->tiles_y;
+    vx_image src_image = 0, dst_image = 0;
+    vx_graph graph = 0;
+    vx_node node = 0;
+    vx_image* tile_src = NULL;
+    vx_image* tile_dst = NULL;
+    vx_rectangle_t* tile_rect = NULL;
+    tiled_job job = { NULL, NULL };
+    CT_Image src = NULL, full = NULL, stitched = NULL;
+    int i;
+    int64_t time_start;
+    double time_serial, time_parallel;
+
+    ASSERT_NO_FAILURE(src = ct_allocate_ct_image_random_keyed(arg_->width, arg_->height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    ASSERT_VX_OBJECT(src_image = ct_image_to_vx_image(src, context), VX_TYPE_IMAGE);
+
+    /* full-frame result */
+    ASSERT_VX_OBJECT(dst_image = vxCreateImage(context, arg_->width, arg_->height, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+    ASSERT_VX_OBJECT(node = arg_->node_fn(graph, src_image, dst_image), VX_TYPE_NODE);
+    VX_CALL(vxVerifyGraph(graph));
+    VX_CALL(vxProcessGraph(graph));
+    ASSERT_NO_FAILURE(full = ct_image_from_vx_image(dst_image));
+    VX_CALL(vxReleaseNode(&node));
+    VX_CALL(vxReleaseGraph(&graph));
+    VX_CALL(vxReleaseImage(&dst_image));
+
+    /* one graph per tile, input ROIs overlap by the kernel radius */
+    tile_src  = (vx_image*)ct_calloc(num_tiles, sizeof(vx_image));
+    tile_dst  = (vx_image*)ct_calloc(num_tiles, sizeof(vx_image));
+    tile_rect = (vx_rectangle_t*)ct_calloc(num_tiles, sizeof(vx_rectangle_t));
+    job.graphs = (vx_graph*)ct_calloc(num_tiles, sizeof(vx_graph));
+    job.status = (vx_status*)ct_calloc(num_tiles, sizeof(vx_status));
+    ASSERT(tile_src && tile_dst && tile_rect && job.graphs && job.status);
+
+    for (i = 0; i < num_tiles; i++)
+    {
+        int tx = i % arg_->tiles_x, ty = i / arg_->tiles_x;
+        vx_rectangle_t roi;
+
+        tile_rect[i].start_x = arg_->width  * tx / arg_->tiles_x;
+        tile_rect[i].end_x   = arg_->width  * (tx + 1) / arg_->tiles_x;
+        tile_rect[i].start_y = arg_->height * ty / arg_->tiles_y;
+        tile_rect[i].end_y   = arg_->height * (ty + 1) / arg_->tiles_y;
+
+        roi.start_x = tile_rect[i].start_x >= TILED_KERNEL_RADIUS ? tile_rect[i].start_x - TILED_KERNEL_RADIUS : 0;
+        roi.start_y = tile_rect[i].start_y >= TILED_KERNEL_RADIUS ? tile_rect[i].start_y - TILED_KERNEL_RADIUS : 0;
+        roi.end_x   = CT_MIN(tile_rect[i].end_x + TILED_KERNEL_RADIUS, (vx_uint32)arg_->width);
+        roi.end_y   = CT_MIN(tile_rect[i].end_y + TILED_KERNEL_RADIUS, (vx_uint32)arg_->height);
+
+        ASSERT_VX_OBJECT(tile_src[i] = vxCreateImageFromROI(src_image, &roi), VX_TYPE_IMAGE);
+        ASSERT_VX_OBJECT(tile_dst[i] = vxCreateImage(context, roi.end_x - roi.start_x, roi.end_y - roi.start_y, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+        ASSERT_VX_OBJECT(job.graphs[i] = vxCreateGraph(context), VX_TYPE_GRAPH);
+        ASSERT_VX_OBJECT(node = arg_->node_fn(job.graphs[i], tile_src[i], tile_dst[i]), VX_TYPE_NODE);
+        VX_CALL(vxReleaseNode(&node));
+        VX_CALL(vxVerifyGraph(job.graphs[i]));
+
+        // tile position inside its own output image
+        tile_rect[i].end_x   -= roi.start_x;
+        tile_rect[i].end_y   -= roi.start_y;
+        tile_rect[i].start_x -= roi.start_x;
+        tile_rect[i].start_y -= roi.start_y;
+    }
+
+    /* serial execution as the baseline for scaling, only with --benchmark */
+    time_serial = 0;
+    if (ct_check_benchmark())
+    {
+        time_start = CT_getTickCount();
+        tiled_process_graphs(&job, 0, num_tiles);
+        time_serial = CT_getElapsedMs(time_start);
+        for (i = 0; i < num_tiles; i++)
+            ASSERT_EQ_VX_STATUS(VX_SUCCESS, job.status[i]);
+    }
+
+    /* tiles are processed concurrently, the result of this pass is checked */
+    time_start = CT_getTickCount();
+    ct_parallel_for(0, num_tiles, tiled_process_graphs, &job);
+    time_parallel = CT_getElapsedMs(time_start);
+    if (ct_check_benchmark())
+        CT_TIME_PRINTF("    %d tiles: serial %.2f ms, parallel %.2f ms with %d threads, speedup %.2fx\n",
+                       num_tiles, time_serial, time_parallel, ct_get_num_threads(),
+                       time_parallel > 0 ? time_serial / time_parallel : 0.);
+    for (i = 0; i < num_tiles; i++)
+        ASSERT_EQ_VX_STATUS(VX_SUCCESS, job.status[i]);
+
+    ASSERT_NO_FAILURE(stitched = ct_allocate_image(arg_->width, arg_->height, VX_DF_IMAGE_U8));
+    for (i = 0; i < num_tiles; i++)
+    {
+        int tx = i % arg_->tiles_x, ty = i / arg_->tiles_x;
+        uint32_t x0 = arg_->width * tx / arg_->tiles_x, y0 = arg_->height * ty / arg_->tiles_y;
+        uint32_t y;
+        CT_Image tile = NULL;
+
+        ASSERT_NO_FAILURE(tile = ct_image_from_vx_image(tile_dst[i]));
+        for (y = tile_rect[i].start_y; y < tile_rect[i].end_y; y++)
+        {
+            memcpy(CT_IMAGE_DATA_PTR_8U(stitched, x0, y0 + y - tile_rect[i].start_y),
+                   CT_IMAGE_DATA_PTR_8U(tile, tile_rect[i].start_x, y),
+                   tile_rect[i].end_x - tile_rect[i].start_x);
+        }
+    }
+
+    // border of the whole frame is undefined
+    ct_adjust_roi(full, TILED_KERNEL_RADIUS, TILED_KERNEL_RADIUS, TILED_KERNEL_RADIUS, TILED_KERNEL_RADIUS);
+    ct_adjust_roi(stitched, TILED_KERNEL_RADIUS, TILED_KERNEL_RADIUS, TILED_KERNEL_RADIUS, TILED_KERNEL_RADIUS);
+    EXPECT_EQ_CTIMAGE(full, stitched);
+
+    for (i = 0; i < num_tiles; i++)
+    {
+        VX_CALL(vxReleaseGraph(&job.graphs[i]));
+        VX_CALL(vxReleaseImage(&tile_dst[i]));
+        VX_CALL(vxReleaseImage(&tile_src[i]));
+    }
+    VX_CALL(vxReleaseImage(&src_image));
+
+    ct_free_mem(job.status);
+    ct_free_mem(job.graphs);
+    ct_free_mem(tile_rect);
+    ct_free_mem(tile_dst);
+    ct_free_mem(tile_src);
+
+    ASSERT(src_image == 0);
+}
+
+TESTCASE_TESTS(GraphROITiled,
+        testStitchedEqualsFullFrame
+        )
@@ -0,0 +1,338 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_engine/test.h"
+#include <VX/vx.h>
+#include <VX/vxu.h>
+
+TESTCASE(GraphScaling, CT_VXContext, ct_setup_vx_context, 0)
+
+// images are small on purpose: the test measures graph bookkeeping, not kernel throughput
+#define SCALING_WIDTH  64
+#define SCALING_HEIGHT 48
+
+// steady-state processing is measured only with --benchmark
+#define SCALING_STEADY_ITERATIONS 10
+
+typedef enum {
+    SCALING_CHAIN,  // src -> Not -> Not -> ... -> dst
+    SCALING_TREE,   // Not leaves reading src, reduced pairwise by Or nodes into dst
+    SCALING_FANOUT  // src -> Not -> v, then every other Not node reads v and writes its own image
+} scaling_topology;
+
+// creates the node like testCornersGraphFactory does: generic node of the kernel, parameters set by index
+static void scaling_add_node(vx_graph graph, vx_kernel kernel, vx_image in0, vx_image in1, vx_image out)
+{
+    vx_node node = 0;
+    vx_uint32 index = 0;
+
+    ASSERT_VX_OBJECT(node = vxCreateGenericNode(graph, kernel), VX_TYPE_NODE);
+    VX_CALL(vxSetParameterByIndex(node, index++, (vx_reference)in0));
+    if (in1)
+        VX_CALL(vxSetParameterByIndex(node, index++, (vx_reference)in1));
+    VX_CALL(vxSetParameterByIndex(node, index, (vx_reference)out));
+
+    VX_CALL(vxReleaseNode(&node));
+    ASSERT(node == 0);
+}
+
+// intermediates are virtual images or, if virtual_intermediates is false, explicit images of the src size
+static void scaling_build_chain(vx_graph graph, vx_kernel not_kernel, vx_image src, vx_image dst, int num_nodes,
+                                vx_bool virtual_intermediates)
+{
+    vx_context context = vxGetContext((vx_reference)graph);
+    vx_image prev = src;
+    vx_uint32 width = 0, height = 0;
+    int i;
+
+    ASSERT_VX_OBJECT(context, VX_TYPE_CONTEXT);
+    VX_CALL(vxQueryImage(src, VX_IMAGE_WIDTH, &width, sizeof(width)));
+    VX_CALL(vxQueryImage(src, VX_IMAGE_HEIGHT, &height, sizeof(height)));
+
+    for (i = 0; i < num_nodes; i++)
+    {
+        vx_image out = dst;
+
+        if (i < num_nodes - 1 && virtual_intermediates)
+            ASSERT_VX_OBJECT(out = vxCreateVirtualImage(graph, 0, 0, VX_DF_IMAGE_VIRT), VX_TYPE_IMAGE);
+        else if (i < num_nodes - 1)
+            ASSERT_VX_OBJECT(out = vxCreateImage(context, width, height, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+
+        ASSERT_NO_FAILURE(scaling_add_node(graph, not_kernel, prev, NULL, out));
+
+        if (prev != src)
+            VX_CALL(vxReleaseImage(&prev));
+        prev = out;
+    }
+}
+
+static void scaling_build_tree(vx_graph graph, vx_kernel not_kernel, vx_kernel or_kernel, vx_image src, vx_image dst,
+                               int num_leaves)
+{
+    vx_image* level = (vx_image*)ct_alloc_mem(num_leaves * sizeof(vx_image));
+    int count = num_leaves, i;
+
+    ASSERT(level);
+
+    for (i = 0; i < num_leaves; i++)
+    {
+        level[i] = dst;
+        if (num_leaves > 1)
+            ASSERT_VX_OBJECT(level[i] = vxCreateVirtualImage(graph, 0, 0, VX_DF_IMAGE_VIRT), VX_TYPE_IMAGE);
+        ASSERT_NO_FAILURE(scaling_add_node(graph, not_kernel, src, NULL, level[i]));
+    }
+
+    while (count > 1)
+    {
+        int next = 0;
+
+        for (i = 0; i + 1 < count; i += 2)
+        {
+            vx_image out = dst;
+
+            if (count > 2)
+                ASSERT_VX_OBJECT(out = vxCreateVirtualImage(graph, 0, 0, VX_DF_IMAGE_VIRT), VX_TYPE_IMAGE);
+
+            ASSERT_NO_FAILURE(scaling_add_node(graph, or_kernel, level[i], level[i + 1], out));
+
+            VX_CALL(vxReleaseImage(&level[i]));
+            VX_CALL(vxReleaseImage(&level[i + 1]));
+            level[next++] = out;
+        }
+        if (i < count) // odd one is carried to the next level
+            level[next++] = level[i];
+        count = next;
+    }
+
+    ct_free_mem(level);
+}
+
+static void scaling_build_fanout(vx_context context, vx_graph graph, vx_kernel not_kernel, vx_image src, vx_image dst,
+                                 int num_nodes)
+{
+    vx_image shared = 0;
+    int i;
+
+    ASSERT_VX_OBJECT(shared = vxCreateVirtualImage(graph, 0, 0, VX_DF_IMAGE_VIRT), VX_TYPE_IMAGE);
+    ASSERT_NO_FAILURE(scaling_add_node(graph, not_kernel, src, NULL, shared));
+
+    for (i = 1; i < num_nodes; i++)
+    {
+        vx_image out = dst;
+
+        if (i < num_nodes - 1)
+            ASSERT_VX_OBJECT(out = vxCreateImage(context, SCALING_WIDTH, SCALING_HEIGHT, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+
+        ASSERT_NO_FAILURE(scaling_add_node(graph, not_kernel, shared, NULL, out));
+
+        if (out != dst) // the graph keeps its own reference
+            VX_CALL(vxReleaseImage(&out));
+    }
+
+    VX_CALL(vxReleaseImage(&shared));
+}
+
+// result of a chain of Not nodes: src for an even and ~src for an odd number of nodes
+static CT_Image scaling_create_reference(CT_Image src, int invert)
+{
+    CT_Image ref = NULL;
+    uint32_t x, y;
+
+    ASSERT_NO_FAILURE_(return NULL, ref = ct_allocate_image(src->width, src->height, VX_DF_IMAGE_U8));
+    for (y = 0; y < ref->height; y++)
+        for (x = 0; x < ref->width; x++)
+        {
+            uint8_t value = *CT_IMAGE_DATA_PTR_8U(src, x, y);
+            *CT_IMAGE_DATA_PTR_8U(ref, x, y) = invert ? (uint8_t)~value : value;
+        }
+
+    return ref;
+}
+
+typedef struct {
+    const char* testName;
+    scaling_topology topology;
+    int num_nodes;
+} scaling_arg;
+
+#define SCALING_ARGS(topology_name, topology) \
+    ARG(#topology_name "/nodes=10",    topology, 10),    \
+    ARG(#topology_name "/nodes=100",   topology, 100),   \
+    ARG(#topology_name "/nodes=1000",  topology, 1000),  \
+    ARG_EXTENDED_BEGIN(),                                \
+    ARG(#topology_name "/nodes=10000", topology, 10000), \
+    ARG_EXTENDED_END()
+
+TEST_WITH_ARG(GraphScaling, testVerifyCost, scaling_arg,
+    SCALING_ARGS(Chain, SCALING_CHAIN),
+    SCALING_ARGS(Tree, SCALING_TREE),
+    SCALING_ARGS(FanOut, SCALING_FANOUT)
+)
+{
+    vx_context context = context_->vx_context_;
+    vx_kernel not_kernel = 0, or_kernel = 0;
+    vx_graph graph = 0;
+    vx_image src_image = 0, dst_image = 0;
+    CT_Image src = NULL, dst = NULL, ref = NULL;
+    int num_nodes = arg_->num_nodes, invert = 0;
+    int64_t time_start;
+    double verify_ms, first_ms, steady_ms;
+    int i;
+
+    ASSERT_NO_FAILURE(src = ct_allocate_ct_image_random_keyed(SCALING_WIDTH, SCALING_HEIGHT, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    ASSERT_VX_OBJECT(src_image = ct_image_to_vx_image(src, context), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(dst_image = vxCreateImage(context, SCALING_WIDTH, SCALING_HEIGHT, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+
+    ASSERT_VX_OBJECT(not_kernel = vxGetKernelByEnum(context, VX_KERNEL_NOT), VX_TYPE_KERNEL);
+    ASSERT_VX_OBJECT(or_kernel = vxGetKernelByEnum(context, VX_KERNEL_OR), VX_TYPE_KERNEL);
+
+    ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+
+    switch (arg_->topology)
+    {
+    case SCALING_CHAIN:
+        ASSERT_NO_FAILURE(scaling_build_chain(graph, not_kernel, src_image, dst_image, num_nodes, vx_true_e));
+        invert = num_nodes % 2;
+        break;
+    case SCALING_TREE:
+    {
+        // num_leaves Not nodes plus (num_leaves - 1) Or nodes
+        int num_leaves = (num_nodes + 1) / 2;
+        ASSERT_NO_FAILURE(scaling_build_tree(graph, not_kernel, or_kernel, src_image, dst_image, num_leaves));
+        num_nodes = 2 * num_leaves - 1;
+        invert = 1;
+        break;
+    }
+    case SCALING_FANOUT:
+        ASSERT_NO_FAILURE(scaling_build_fanout(context, graph, not_kernel, src_image, dst_image, num_nodes));
+        invert = 0;
+        break;
+    default:
+        FAIL("Unknown graph topology: %d", (int)arg_->topology);
+    }
+
+    time_start = CT_getTickCount();
+    VX_CALL(vxVerifyGraph(graph));
+    verify_ms = CT_getElapsedMs(time_start);
+    time_start = CT_getTickCount();
+    VX_CALL(vxProcessGraph(graph));
+    first_ms = CT_getElapsedMs(time_start);
+    if (ct_check_benchmark())
+    {
+        time_start = CT_getTickCount();
+        for (i = 0; i < SCALING_STEADY_ITERATIONS; i++)
+            VX_CALL(vxProcessGraph(graph));
+        steady_ms = CT_getElapsedMs(time_start) / SCALING_STEADY_ITERATIONS;
+        CT_TIME_PRINTF("    nodes=%d: verify %.3f ms (%.2f us/node), first process %.3f ms, steady process %.3f ms (%.2f us/node)\n",
+                       num_nodes, verify_ms, verify_ms * 1000. / num_nodes, first_ms, steady_ms, steady_ms * 1000. / num_nodes);
+    }
+
+    ASSERT_NO_FAILURE(dst = ct_image_from_vx_image(dst_image));
+
+    ASSERT_NO_FAILURE(ref = scaling_create_reference(src, invert));
+
+    EXPECT_EQ_CTIMAGE(ref, dst);
+
+    VX_CALL(vxReleaseGraph(&graph));
+    VX_CALL(vxReleaseKernel(&or_kernel));
+    VX_CALL(vxReleaseKernel(&not_kernel));
+    VX_CALL(vxReleaseImage(&dst_image));
+    VX_CALL(vxReleaseImage(&src_image));
+
+    ASSERT(graph == 0);
+    ASSERT(or_kernel == 0); ASSERT(not_kernel == 0);
+    ASSERT(dst_image == 0); ASSERT(src_image == 0);
+}
+
+typedef struct {
+    const char* testName;
+    vx_bool virtual_intermediates;
+    int num_intermediates;
+    int width, height;
+} footprint_arg;
+
+/*
+    Process RSS is sampled before the graph is built, after vxVerifyGraph and after the first
+    vxProcessGraph. An implementation that reuses or elides virtual buffers shows a much smaller
+    growth per intermediate for virtual chains than for chains of explicit images. RSS also depends
+    on the heap state left by previous tests, so the numbers are estimates and are only reported,
+    with --benchmark like the other benchmark results.
+*/
+TEST_WITH_ARG(GraphScaling, testVirtualImageFootprint, footprint_arg,
+    ARG("Virtual/intermediates=16/sz=640x480",  vx_true_e,  16, 640, 480),
+    ARG("Explicit/intermediates=16/sz=640x480", vx_false_e, 16, 640, 480),
+    ARG("Virtual/intermediates=64/sz=640x480",  vx_true_e,  64, 640, 480),
+    ARG("Explicit/intermediates=64/sz=640x480", vx_false_e, 64, 640, 480)
+)
+{
+    vx_context context = context_->vx_context_;
+    vx_kernel not_kernel = 0;
+    vx_graph graph = 0;
+    vx_image src_image = 0, dst_image = 0;
+    CT_Image src = NULL, dst = NULL, ref = NULL;
+    // one Not node per intermediate plus the last one writing dst
+    int num_nodes = arg_->num_intermediates + 1;
+    size_t rss_start, rss_verify, rss_process;
+    double frame_size = (double)arg_->width * arg_->height;
+
+    ASSERT_NO_FAILURE(src = ct_allocate_ct_image_random(arg_->width, arg_->height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+    ASSERT_VX_OBJECT(src_image = ct_image_to_vx_image(src, context), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(dst_image = vxCreateImage(context, arg_->width, arg_->height, VX_DF_IMAGE_U8), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(not_kernel = vxGetKernelByEnum(context, VX_KERNEL_NOT), VX_TYPE_KERNEL);
+
+    rss_start = ct_get_rss_bytes(NULL);
+
+    ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+    ASSERT_NO_FAILURE(scaling_build_chain(graph, not_kernel, src_image, dst_image, num_nodes, arg_->virtual_intermediates));
+
+    VX_CALL(vxVerifyGraph(graph));
+    rss_verify = ct_get_rss_bytes(NULL);
+
+    VX_CALL(vxProcessGraph(graph));
+    rss_process = ct_get_rss_bytes(NULL);
+
+    if (rss_start != 0 && ct_check_benchmark())
+    {
+        double verify_delta = (double)rss_verify - (double)rss_start;
+        double process_delta = (double)rss_process - (double)rss_start;
+        CT_TIME_PRINTF("    %s intermediates: RSS +%.1f KB after verify, +%.1f KB after first process, "
+                       "%.0f bytes per intermediate (%.2f frames)\n",
+                       arg_->virtual_intermediates ? "virtual" : "explicit",
+                       verify_delta / 1024., process_delta / 1024.,
+                       process_delta / arg_->num_intermediates, process_delta / arg_->num_intermediates / frame_size);
+    }
+
+    ASSERT_NO_FAILURE(dst = ct_image_from_vx_image(dst_image));
+
+    ASSERT_NO_FAILURE(ref = scaling_create_reference(src, num_nodes % 2));
+
+    EXPECT_EQ_CTIMAGE(ref, dst);
+
+    VX_CALL(vxReleaseGraph(&graph));
+    VX_CALL(vxReleaseKernel(&not_kernel));
+    VX_CALL(vxReleaseImage(&dst_image));
+    VX_CALL(vxReleaseImage(&src_image));
+
+    ASSERT(graph == 0);
+    ASSERT(not_kernel == 0);
+    ASSERT(dst_image == 0); ASSERT(src_image == 0);
+}
+
+TESTCASE_TESTS(GraphScaling,
+        testVerifyCost,
+        testVirtualImageFootprint
+        )
@@ -76,49 +76,48 @@ static CT_Image hog_read_image(const char *fileName, int width, int height)
     return image;
 }
 
-static vx_status hogcells_ref(CT_Image img, vx_int32 cell_width, vx_int32 cell_height, vx_int32 bins_num, vx_tensor magnitudes, vx_tensor bins)
+// lena tiled with mirroring to the requested size, for the production sizes
+static CT_Image hog_tiled_image(const char *fileName, int width, int height)
+{
+    CT_Image image = NULL, tile = NULL;
+    ASSERT_(return 0, width > 0 && height > 0);
+    ASSERT_NO_FAILURE_(return 0, tile = hog_read_image(fileName, 0, 0));
+    ASSERT_NO_FAILURE_(return 0, image = ct_allocate_image(width, height, VX_DF_IMAGE_U8));
+
+    for (int j = 0; j < height; j++)
+    {
+        vx_uint32 ty = j % (2 * tile->height);
+        const vx_uint8* src = CT_IMAGE_DATA_PTR_8U(tile, 0, ty < tile->height ? ty : 2 * tile->height - 1 - ty);
+        vx_uint8* dst = CT_IMAGE_DATA_PTR_8U(image, 0, j);
+        for (int i = 0; i < width; i++)
+        {
+            vx_uint32 tx = i % (2 * tile->width);
+            dst[i] = src[tx < tile->width ? tx : 2 * tile->width - 1 - tx];
+        }
+    }
+    return image;
+}
+
+/*
+    Magnitude and orientation of every (gx, gy) pair of U8 central differences, gx and gy
+    in [-255, 255]. Computed once per reference call with exactly the expressions the per-pixel
+    reference used, so the results are bit-compatible with it.
+*/
+#define HOG_GRADIENT_LUT_SIZE 511
+
+static void hog_init_gradient_lut(vx_float32* magnitude_lut, vx_float32* orientation_lut)
 {
-    vx_status status = 0;
-    vx_int32 width, height;
-    void* p_ct_base = ct_image_get_plane_base(img, 0);
     vx_float32 gx;
     vx_float32 gy;
     vx_float32 orientation;
     vx_float32 magnitude;
-    vx_int8 bin;
-    
-    width = img->width;
-    height = img->height;
-    vx_int16* mag_ref = (vx_int16 *)malloc(height / cell_height * width / cell_width * sizeof(vx_int16));
-    vx_int8* bins_ref = (vx_int8 *)malloc(height / cell_height * width / cell_width * bins_num );
-    vx_int16* mag = (vx_int16 *)malloc(height / cell_height * width / cell_width *sizeof(vx_int16));
-    vx_int8* bins_p = (vx_int8 *)malloc(height / cell_height * width / cell_width * bins_num);
-    memset(mag_ref, 0, height / cell_height * width / cell_width * sizeof(vx_int16));
-    memset(bins_ref, 0, height / cell_height * width / cell_width * bins_num);
-    float num_div_360 = (float)bins_num / 360.0f;
-
-    vx_size magnitudes_dim_num = 2, magnitudes_dims[6] = { width/cell_width, height/cell_height,0 }, magnitudes_strides[6] = { 2, 2 * width / cell_width };
-    vx_size bins_dim_num = 3, bins_dims[6] = { width / cell_width, height / cell_height, bins_num }, bins_strides[6] = { 1,  width / cell_width, height / cell_height * width / cell_width };
-    const size_t view_start[6] = { 0 };
-    vxCopyTensorPatch(magnitudes, magnitudes_dim_num, view_start, magnitudes_dims, magnitudes_strides, mag, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyTensorPatch(bins, bins_dim_num, view_start, bins_dims, bins_strides, bins_p, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
 
-    vx_int32 num_cellw = (vx_int32)floor(((vx_float64)width) / ((vx_float64)cell_width));
-    for (int j = 0; j < height; j++)
+    for (int dy = -255; dy <= 255; dy++)
     {
-        for (int i = 0; i < width; i++)
+        for (int dx = -255; dx <= 255; dx++)
         {
-            int x1 = i - 1 < 0 ? 0 : i - 1;
-            int x2 = i + 1 >= width ? width - 1 : i + 1;
-            vx_uint8 *gx1 = (vx_uint8*)((vx_uint8*)p_ct_base + j * img->stride + x1);
-            vx_uint8 *gx2 = (vx_uint8*)((vx_uint8*)p_ct_base + j * img->stride + x2);
-            gx = *gx2 - *gx1;
-
-            int y1 = j - 1 < 0 ? 0 : j - 1;
-            int y2 = j + 1 >= height ? height - 1 : j + 1;
-            vx_uint8 *gy1 = (vx_uint8*)((vx_uint8*)p_ct_base + y1 * img->stride + i);
-            vx_uint8 *gy2 = (vx_uint8*)((vx_uint8*)p_ct_base + y2 * img->stride + i);
-            gy = *gy2 - *gy1;
+            gx = dx;
+            gy = dy;
 
             magnitude = sqrtf(powf(gx, 2) + powf(gy, 2));
             orientation = fmod(atan2f(gy, gx + 0.00000000000001)
@@ -127,17 +126,116 @@ static vx_status hogcells_ref(CT_Image img, vx_int32 cell_width, vx_int32 cell_h
                 orientation += 360;
             }
 
-            bin = (vx_int8)floor(orientation * num_div_360);
+            magnitude_lut[(dy + 255) * HOG_GRADIENT_LUT_SIZE + dx + 255] = magnitude;
+            orientation_lut[(dy + 255) * HOG_GRADIENT_LUT_SIZE + dx + 255] = orientation;
+        }
+    }
+}
+
+typedef struct {
+    CT_Image img;
+    vx_int32 cell_width;
+    vx_int32 cell_height;
+    vx_int32 bins_num;
+    vx_int32 num_cellw;
+    vx_int16* mag_ref;
+    vx_int8* bins_ref;
+    const vx_float32* magnitude_lut;
+    const vx_float32* orientation_lut;
+} hog_cells_job;
+
+// every cell row is accumulated by one worker in raster order, as the sequential reference did
+static void hog_cells_rows(void* job_, int begin, int end)
+{
+    hog_cells_job* job = (hog_cells_job*)job_;
+    CT_Image img = job->img;
+    vx_int32 width = img->width, height = img->height;
+    vx_int32 cell_width = job->cell_width, cell_height = job->cell_height, bins_num = job->bins_num;
+    float num_div_360 = (float)bins_num / 360.0f;
+
+    for (vx_int32 celly = begin; celly < end; celly++)
+    {
+        vx_int16* mag_row = job->mag_ref + celly * job->num_cellw;
+        vx_int8* bins_row = job->bins_ref + celly * job->num_cellw * bins_num;
+
+        for (int j = celly * cell_height; j < (celly + 1) * cell_height; j++)
+        {
+            const vx_uint8* row = CT_IMAGE_DATA_PTR_8U(img, 0, j);
+            const vx_uint8* up = CT_IMAGE_DATA_PTR_8U(img, 0, j - 1 < 0 ? 0 : j - 1);
+            const vx_uint8* down = CT_IMAGE_DATA_PTR_8U(img, 0, j + 1 >= height ? height - 1 : j + 1);
 
-            vx_int32 cellx = i / cell_width;
-            vx_int32 celly = j / cell_height;
-            vx_int32 magnitudes_index = celly * num_cellw + cellx;
-            vx_int32 bins_index = (celly * num_cellw + cellx) * bins_num + bin;
-            *(mag_ref + magnitudes_index) += magnitude / (cell_width * cell_height);
-            *(bins_ref + bins_index) += magnitude / (cell_width * cell_height);
+            for (int i = 0; i < job->num_cellw * cell_width; i++)
+            {
+                int x1 = i - 1 < 0 ? 0 : i - 1;
+                int x2 = i + 1 >= width ? width - 1 : i + 1;
+                int lut_index = (down[i] - up[i] + 255) * HOG_GRADIENT_LUT_SIZE + row[x2] - row[x1] + 255;
+                vx_float32 magnitude = job->magnitude_lut[lut_index];
+                vx_int8 bin = (vx_int8)floor(job->orientation_lut[lut_index] * num_div_360);
+                vx_int32 cellx = i / cell_width;
+
+                *(mag_row + cellx) += magnitude / (cell_width * cell_height);
+                *(bins_row + cellx * bins_num + bin) += magnitude / (cell_width * cell_height);
+            }
         }
     }
-    for (int i = 0; i < height / cell_height * width / cell_width; i++)
+}
+
+// cell magnitudes and histograms, pixels out of the whole cells are skipped
+static vx_status hog_cells_compute(CT_Image img, vx_int32 cell_width, vx_int32 cell_height, vx_int32 bins_num, vx_int16* mag_ref, vx_int8* bins_ref)
+{
+    hog_cells_job job;
+    vx_float32* magnitude_lut = (vx_float32*)ct_alloc_mem(HOG_GRADIENT_LUT_SIZE * HOG_GRADIENT_LUT_SIZE * sizeof(vx_float32));
+    vx_float32* orientation_lut = (vx_float32*)ct_alloc_mem(HOG_GRADIENT_LUT_SIZE * HOG_GRADIENT_LUT_SIZE * sizeof(vx_float32));
+
+    if (!magnitude_lut || !orientation_lut)
+    {
+        ct_free_mem(magnitude_lut);
+        ct_free_mem(orientation_lut);
+        return VX_ERROR_NO_MEMORY;
+    }
+    hog_init_gradient_lut(magnitude_lut, orientation_lut);
+
+    job.img = img;
+    job.cell_width = cell_width;
+    job.cell_height = cell_height;
+    job.bins_num = bins_num;
+    job.num_cellw = img->width / cell_width;
+    job.mag_ref = mag_ref;
+    job.bins_ref = bins_ref;
+    job.magnitude_lut = magnitude_lut;
+    job.orientation_lut = orientation_lut;
+
+    memset(mag_ref, 0, img->height / cell_height * job.num_cellw * sizeof(vx_int16));
+    memset(bins_ref, 0, img->height / cell_height * job.num_cellw * bins_num);
+
+    ct_parallel_for(0, img->height / cell_height, hog_cells_rows, &job);
+
+    ct_free_mem(magnitude_lut);
+    ct_free_mem(orientation_lut);
+    return VX_SUCCESS;
+}
+
+static vx_status hogcells_ref(CT_Image img, vx_int32 cell_width, vx_int32 cell_height, vx_int32 bins_num, vx_tensor magnitudes, vx_tensor bins)
+{
+    vx_status status = 0;
+    vx_int32 width, height;
+
+    width = img->width;
+    height = img->height;
+    vx_int16* mag_ref = (vx_int16 *)malloc(height / cell_height * width / cell_width * sizeof(vx_int16));
+    vx_int8* bins_ref = (vx_int8 *)malloc(height / cell_height * width / cell_width * bins_num );
+    vx_int16* mag = (vx_int16 *)malloc(height / cell_height * width / cell_width *sizeof(vx_int16));
+    vx_int8* bins_p = (vx_int8 *)malloc(height / cell_height * width / cell_width * bins_num);
+
+    vx_size magnitudes_dim_num = 2, magnitudes_dims[6] = { width/cell_width, height/cell_height,0 }, magnitudes_strides[6] = { 2, 2 * width / cell_width };
+    vx_size bins_dim_num = 3, bins_dims[6] = { width / cell_width, height / cell_height, bins_num }, bins_strides[6] = { 1,  width / cell_width, height / cell_height * width / cell_width };
+    const size_t view_start[6] = { 0 };
+    vxCopyTensorPatch(magnitudes, magnitudes_dim_num, view_start, magnitudes_dims, magnitudes_strides, mag, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
+    vxCopyTensorPatch(bins, bins_dim_num, view_start, bins_dims, bins_strides, bins_p, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
+
+    status = hog_cells_compute(img, cell_width, cell_height, bins_num, mag_ref, bins_ref);
+
+    for (int i = 0; status == VX_SUCCESS && i < height / cell_height * width / cell_width; i++)
     {
         vx_float32 mag_ref_data = *(mag_ref + i);
         vx_float32 mag_data = *(mag + i);
@@ -177,6 +275,7 @@ typedef struct {
     vx_int32 cell_height;
     vx_int32 bins_num;
     const char* result_filename;
+    int width, height;
 } Arg;
 
 #define PARAMETERS \
@@ -185,6 +284,10 @@ typedef struct {
     ARG("case_cells8x8_9_Hogcells", hog_read_image, "lena_gray.bmp", 8, 8, 3, "hogcells_8x8_3.txt"), \
     ARG("case_cells8x8_9_Hogcells", hog_read_image, "lena_gray.bmp", 4, 4, 9, "hogcells_8x8_9.txt"), \
     ARG("case_cells8x8_9_Hogcells", hog_read_image, "lena_gray.bmp", 4, 4, 6, "hogcells_8x8_6.txt"), \
+    ARG_PRODUCTION_BEGIN(), \
+    ARG("case_cells8x8_9_Hogcells/sz=1920x1080", hog_tiled_image, "lena_gray.bmp", 8, 8, 9, NULL, 1920, 1080), \
+    ARG("case_cells8x8_9_Hogcells/sz=3840x2160", hog_tiled_image, "lena_gray.bmp", 8, 8, 9, NULL, 3840, 2160), \
+    ARG_PRODUCTION_END(), \
 
 TEST_WITH_ARG(HogCells, testGraphProcessing, Arg,
     PARAMETERS
@@ -203,7 +306,7 @@ TEST_WITH_ARG(HogCells, testGraphProcessing, Arg,
     vx_uint32 src_width;
     vx_uint32 src_height;
 
-    ASSERT_NO_FAILURE(src = arg_->generator(arg_->fileName, 0, 0));
+    ASSERT_NO_FAILURE(src = arg_->generator(arg_->fileName, arg_->width, arg_->height));
     src_width = src->width;
     src_height = src->height;
 
@@ -251,7 +354,7 @@ TEST_WITH_ARG(HogCells, testImmediateProcessing, Arg,
     vx_uint32 src_width;
     vx_uint32 src_height;
 
-    ASSERT_NO_FAILURE(src = arg_->generator(arg_->fileName, 0, 0));
+    ASSERT_NO_FAILURE(src = arg_->generator(arg_->fileName, arg_->width, arg_->height));
     src_width = src->width;
     src_height = src->height;
 
@@ -331,16 +434,61 @@ TEST(HogFeatures, testNodeCreation)
     ASSERT(input == 0);
 }
 
+typedef struct {
+    const vx_int16* mag_ref;
+    const vx_int8* bins_ref;
+    vx_int16* features_ref;
+    vx_int32 n_cellsx;
+    vx_int32 num_blockW;
+    vx_int32 cells_per_block_w;
+    vx_int32 cells_per_block_h;
+    vx_int32 bins_num;
+    vx_float32 threshold;
+} hog_blocks_job;
+
+// block normalization, every block writes only its own features
+static void hog_blocks_rows(void* job_, int begin, int end)
+{
+    hog_blocks_job* job = (hog_blocks_job*)job_;
+    vx_int32 n_cellsx = job->n_cellsx, num_blockW = job->num_blockW, bins_num = job->bins_num;
+
+    for (vx_int32 blkH = begin; blkH < end; blkH++)
+    {
+        for (vx_int32 blkW = 0; blkW < num_blockW; blkW++)
+        {
+            vx_float32 sum = 0;
+            for (vx_int32 y = 0; y < job->cells_per_block_h; y++)
+            {
+                for (vx_int32 x = 0; x < job->cells_per_block_w; x++)
+                {
+                    vx_int32 index = (blkH + y)*n_cellsx + (blkW + x);
+                    sum += (*(job->mag_ref + index)) * (*(job->mag_ref + index));
+                }
+            }
+            sum = sqrtf(sum + 0.00000000000001);
+            for (vx_int32 y = 0; y < job->cells_per_block_h; y++)
+            {
+                for (vx_int32 x = 0; x < job->cells_per_block_w; x++)
+                {
+                    for (vx_int32 k = 0; k < bins_num; k++)
+                    {
+                        vx_int32 bins_index = (blkH + y)*n_cellsx * bins_num + (blkW + x)*bins_num + k;
+                        vx_int32 block_index = blkH * num_blockW * bins_num + blkW * bins_num + k;
+                        float hist = min((*(job->bins_ref + bins_index) / sum), job->threshold);
+                        vx_int16 *features_ptr = job->features_ref + block_index;
+                        *features_ptr = *features_ptr + hist;
+                    }
+                }
+            }
+        }
+    }
+}
+
 static vx_status hogfeatures_ref(CT_Image img, vx_hog_t params, vx_tensor features)
 {
     vx_status status = 0;
     vx_int32 width, height;
-    void* p_ct_base = ct_image_get_plane_base(img, 0);
-    vx_float32 gx;
-    vx_float32 gy;
-    vx_float32 orientation;
-    vx_float32 magnitude;
-    vx_int8 bin;
+    hog_blocks_job job;
 
     width = img->width;
     height = img->height;
@@ -353,7 +501,6 @@ static vx_status hogfeatures_ref(CT_Image img, vx_hog_t params, vx_tensor featur
     vx_int32 num_windowsH = height / params.window_height;
     vx_int32 num_blockW = width / params.cell_width - 1;
     vx_int32 num_blockH = height / params.cell_height - 1;
-    vx_int32 num_block = num_blockW * num_blockH;
     vx_int32 n_cellsx = width / cell_width;
     vx_int32 cells_per_block_w = params.block_width / cell_width;
     vx_int32 cells_per_block_h = params.block_height / cell_height;
@@ -364,83 +511,31 @@ static vx_status hogfeatures_ref(CT_Image img, vx_hog_t params, vx_tensor featur
                                                 params.window_height / params.block_stride *bins_num * sizeof(vx_int16));
     vx_int16* features_p = (vx_int16 *)malloc(num_windowsW * num_windowsH * params.window_width / params.block_stride *
                                               params.window_height / params.block_stride *bins_num * sizeof(vx_int16));
-    memset(mag_ref, 0, height / cell_height * width / cell_width * sizeof(vx_int16));
-    memset(bins_ref, 0, height / cell_height * width / cell_width * bins_num);
     memset(features_ref, 0, num_windowsW * num_windowsH * params.window_width / params.block_stride *
         params.window_height / params.block_stride *bins_num * sizeof(vx_int16));
 
-    float num_div_360 = (float)bins_num / 360.0f;
-
     vx_size features_dim_num = 3, features_dims[6] = { num_windowsW, num_windowsH, params.window_width / params.block_stride *
         params.window_height / params.block_stride *bins_num }, features_strides[6] = { 2, 2 * num_windowsW, 2 * num_windowsW * num_windowsH};
     const size_t view_start[6] = { 0 };
     vxCopyTensorPatch(features, features_dim_num, view_start, features_dims, features_strides, features_p, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
 
-    vx_int32 num_cellw = (vx_int32)floor(((vx_float64)width) / ((vx_float64)cell_width));
-    for (int j = 0; j < height; j++)
-    {
-        for (int i = 0; i < width; i++)
-        {
-            int x1 = i - 1 < 0 ? 0 : i - 1;
-            int x2 = i + 1 >= width ? width - 1 : i + 1;
-            vx_uint8 *gx1 = (vx_uint8*)((vx_uint8*)p_ct_base + j * img->stride + x1);
-            vx_uint8 *gx2 = (vx_uint8*)((vx_uint8*)p_ct_base + j * img->stride + x2);
-            gx = *gx2 - *gx1;
-
-            int y1 = j - 1 < 0 ? 0 : j - 1;
-            int y2 = j + 1 >= height ? height - 1 : j + 1;
-            vx_uint8 *gy1 = (vx_uint8*)((vx_uint8*)p_ct_base + y1 * img->stride + i);
-            vx_uint8 *gy2 = (vx_uint8*)((vx_uint8*)p_ct_base + y2 * img->stride + i);
-            gy = *gy2 - *gy1;
-
-            magnitude = sqrtf(powf(gx, 2) + powf(gy, 2));
-            orientation = fmod(atan2f(gy, gx + 0.00000000000001)
-                * (180 / 3.14159265), 360);
-            if (orientation < 0) {
-                orientation += 360;
-            }
-
-            bin = (vx_int8)floor(orientation * num_div_360);
+    status = hog_cells_compute(img, cell_width, cell_height, bins_num, mag_ref, bins_ref);
 
-            vx_int32 cellx = i / cell_width;
-            vx_int32 celly = j / cell_height;
-            vx_int32 magnitudes_index = celly * num_cellw + cellx;
-            vx_int32 bins_index = (celly * num_cellw + cellx) * bins_num + bin;
-            *(mag_ref + magnitudes_index) += magnitude / (cell_width * cell_height);
-            *(bins_ref + bins_index) += magnitude / (cell_width * cell_height);
-        }
-    }
-    for (vx_int32 blkH = 0; blkH < num_blockH; blkH++)
+    if (status == VX_SUCCESS)
     {
-        for (vx_int32 blkW = 0; blkW < num_blockW; blkW++)
-        {
-            vx_float32 sum = 0;
-            for (vx_int32 y = 0; y < cells_per_block_h; y++)
-            {
-                for (vx_int32 x = 0; x < cells_per_block_w; x++)
-                {
-                    vx_int32 index = (blkH + y)*n_cellsx + (blkW + x);
-                    sum += (*(mag_ref + index)) * (*(mag_ref + index));
-                }
-            }
-            sum = sqrtf(sum + 0.00000000000001);
-            for (vx_int32 y = 0; y < cells_per_block_h; y++)
-            {
-                for (vx_int32 x = 0; x < cells_per_block_w; x++)
-                {
-                    for (vx_int32 k = 0; k < bins_num; k++)
-                    {
-                        vx_int32 bins_index = (blkH + y)*n_cellsx * bins_num + (blkW + x)*bins_num + k;
-                        vx_int32 block_index = blkH * num_blockW * bins_num + blkW * bins_num + k;
-                        float hist = min((*(bins_ref + bins_index) / sum), params.threshold);
-                        vx_int16 *features_ptr = features_ref + block_index;
-                        *features_ptr = *features_ptr + hist;
-                    }
-                }
-            }
-        }
+        job.mag_ref = mag_ref;
+        job.bins_ref = bins_ref;
+        job.features_ref = features_ref;
+        job.n_cellsx = n_cellsx;
+        job.num_blockW = num_blockW;
+        job.cells_per_block_w = cells_per_block_w;
+        job.cells_per_block_h = cells_per_block_h;
+        job.bins_num = bins_num;
+        job.threshold = params.threshold;
+        ct_parallel_for(0, num_blockH, hog_blocks_rows, &job);
     }
-    for (int i = 0; i < num_windowsW * num_windowsH * params.window_width / params.block_stride *
+
+    for (int i = 0; status == VX_SUCCESS && i < num_windowsW * num_windowsH * params.window_width / params.block_stride *
         params.window_height / params.block_stride *bins_num; i++)
     {
         vx_float32 features_ref_data = *(features_ref + i);
@@ -465,6 +560,7 @@ typedef struct {
     CT_Image(*generator)(const char* fileName, int width, int height);
     const char* fileName;
     vx_hog_t hog_params;
+    int width, height;
 } Arg_features;
 
 #define PARAMETERS_FEATURES \
@@ -473,6 +569,10 @@ typedef struct {
     ARG("case_hogfeature", hog_read_image, "lena_gray.bmp", {8, 8, 16, 16, 8, 6, 32, 32, 32, 0.2}), \
     ARG("case_hogfeature", hog_read_image, "lena_gray.bmp", {4, 4, 8, 8, 4, 6, 32, 32, 32, 0.2}), \
     ARG("case_hogfeature", hog_read_image, "lena_gray.bmp", {8, 8, 16, 16, 8, 6, 32, 32, 32, 0.1}), \
+    ARG_PRODUCTION_BEGIN(), \
+    ARG("case_hogfeature/sz=1920x1056", hog_tiled_image, "lena_gray.bmp", {8, 8, 16, 16, 8, 9, 32, 32, 32, 0.2}, 1920, 1056), \
+    ARG("case_hogfeature/sz=3840x2144", hog_tiled_image, "lena_gray.bmp", {8, 8, 16, 16, 8, 9, 32, 32, 32, 0.2}, 3840, 2144), \
+    ARG_PRODUCTION_END(), \
 
 TEST_WITH_ARG(HogFeatures, testGraphProcessing, Arg_features,
     PARAMETERS_FEATURES
@@ -493,7 +593,7 @@ TEST_WITH_ARG(HogFeatures, testGraphProcessing, Arg_features,
     vx_uint32 src_width;
     vx_uint32 src_height;
 
-    ASSERT_NO_FAILURE(src = arg_->generator(arg_->fileName, 0, 0));
+    ASSERT_NO_FAILURE(src = arg_->generator(arg_->fileName, arg_->width, arg_->height));
     src_width = src->width;
     src_height = src->height;
 
@@ -550,7 +650,7 @@ TEST_WITH_ARG(HogFeatures, testImmediateProcessing, Arg_features,
     vx_uint32 src_width;
     vx_uint32 src_height;
 
-    ASSERT_NO_FAILURE(src = arg_->generator(arg_->fileName, 0, 0));
+    ASSERT_NO_FAILURE(src = arg_->generator(arg_->fileName, arg_->width, arg_->height));
     src_width = src->width;
     src_height = src->height;
 
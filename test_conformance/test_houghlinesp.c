@@ -115,25 +115,161 @@ static vx_bool similar_lines(vx_line2d_t act, vx_line2d_t exp, vx_float32 eps)
         return vx_false_e;
     }
 }
-static vx_status countLine2dIntersection(const vx_line2d_t *expect_lines, const vx_line2d_t *actual_lines, vx_int32 exp_lines_num, vx_int32 actual_lines_num, vx_float32 eps)
+/*
+    Lines are bucketed by the polar form (theta, rho) of the infinite line through them,
+    so an actual line is compared only with the expected lines of the neighbouring buckets.
+    rho is measured along the normal of the center of the theta bin through the midpoint
+    of the line: unlike the exact normal it doesn't jump for small angle changes far from
+    the origin. similar_lines() also accepts short lines whose angles differ more than a
+    bucket, so a line without a match there is compared with all expected lines: the result
+    is the same as of the exhaustive comparison, but matched lines cost O(1) each.
+*/
+#define HOUGH_THETA_BINS    32
+#define HOUGH_RHO_BIN       8.0f
+
+typedef struct {
+    vx_int32     num_lines;
+    vx_line2d_t* lines;         // sorted by (theta, rho) bucket
+    vx_int32     num_rho_bins;
+    vx_float32   rho_min;
+    vx_int32*    bucket_start;  // HOUGH_THETA_BINS * num_rho_bins + 1 offsets into lines
+} houghlinesp_index;
+
+// direction of the line in [0, pi)
+static vx_int32 houghlinesp_theta_bin(const vx_line2d_t* line)
+{
+    vx_float64 theta = atan2(line->end_y - line->start_y, line->end_x - line->start_x);
+    vx_int32 t;
+    if (theta < 0)
+        theta += M_PI;
+    t = (vx_int32)(theta * HOUGH_THETA_BINS / M_PI);
+    return t < 0 ? 0 : (t >= HOUGH_THETA_BINS ? HOUGH_THETA_BINS - 1 : t);
+}
+
+static vx_float32 houghlinesp_rho(const vx_line2d_t* line, vx_int32 theta_bin)
+{
+    vx_float64 theta = (theta_bin + 0.5) * M_PI / HOUGH_THETA_BINS;
+    vx_float64 x = 0.5 * (line->start_x + line->end_x), y = 0.5 * (line->start_y + line->end_y);
+    return (vx_float32)(y * cos(theta) - x * sin(theta));
+}
+
+static vx_int32 houghlinesp_rho_bin(const houghlinesp_index* index, vx_float32 rho)
+{
+    return (vx_int32)floor((rho - index->rho_min) / HOUGH_RHO_BIN);
+}
+
+static void houghlinesp_release_index(houghlinesp_index* index)
+{
+    ct_free_mem(index->lines);
+    ct_free_mem(index->bucket_start);
+    index->lines = NULL;
+    index->bucket_start = NULL;
+    index->num_lines = 0;
+}
+
+// counting sort of the lines by bucket, the buckets cover the rho range of the given lines
+static vx_bool houghlinesp_build_index(const vx_line2d_t* lines, vx_int32 num_lines, houghlinesp_index* index)
+{
+    vx_float32 rho_max = 0;
+    vx_int32 num_buckets, i;
+    vx_int32* line_bucket;
+
+    // |rho| doesn't exceed |x| + |y| of the midpoint for any theta
+    for (i = 0; i < num_lines; i++)
+    {
+        vx_float32 x = 0.5f * (lines[i].start_x + lines[i].end_x), y = 0.5f * (lines[i].start_y + lines[i].end_y);
+        rho_max = CT_MAX(rho_max, (vx_float32)(fabs(x) + fabs(y)));
+    }
+
+    index->num_lines = num_lines;
+    index->rho_min = -rho_max;
+    index->num_rho_bins = (vx_int32)(2 * rho_max / HOUGH_RHO_BIN) + 1;
+    num_buckets = HOUGH_THETA_BINS * index->num_rho_bins;
+
+    index->lines = (vx_line2d_t*)ct_alloc_mem((num_lines > 0 ? num_lines : 1) * sizeof(vx_line2d_t));
+    index->bucket_start = (vx_int32*)ct_calloc(num_buckets + 1, sizeof(vx_int32));
+    line_bucket = (vx_int32*)ct_alloc_mem((num_lines > 0 ? num_lines : 1) * sizeof(vx_int32));
+    if (!index->lines || !index->bucket_start || !line_bucket)
+    {
+        ct_free_mem(line_bucket);
+        houghlinesp_release_index(index);
+        return vx_false_e;
+    }
+
+    for (i = 0; i < num_lines; i++)
+    {
+        vx_int32 t = houghlinesp_theta_bin(&lines[i]);
+        vx_int32 r = CT_MIN(CT_MAX(houghlinesp_rho_bin(index, houghlinesp_rho(&lines[i], t)), 0), index->num_rho_bins - 1);
+        line_bucket[i] = t * index->num_rho_bins + r;
+        index->bucket_start[line_bucket[i] + 1]++;
+    }
+    for (i = 0; i < num_buckets; i++)
+        index->bucket_start[i + 1] += index->bucket_start[i];
+    for (i = 0; i < num_lines; i++)
+        index->lines[index->bucket_start[line_bucket[i]]++] = lines[i];
+    // bucket_start now holds the ends of the buckets, shift them back
+    for (i = num_buckets; i > 0; i--)
+        index->bucket_start[i] = index->bucket_start[i - 1];
+    index->bucket_start[0] = 0;
+
+    ct_free_mem(line_bucket);
+    return vx_true_e;
+}
+
+static void houghlinesp_free_mem(void** ptr)
+{
+    ct_free_mem(*ptr);
+    *ptr = NULL;
+}
+
+// the index is released with the other test resources, also when the test fails
+static void houghlinesp_collect_index(houghlinesp_index* index)
+{
+    CT_RegisterForGarbageCollection(index->lines, houghlinesp_free_mem, CT_GC_OBJECT);
+    CT_RegisterForGarbageCollection(index->bucket_start, houghlinesp_free_mem, CT_GC_OBJECT);
+}
+
+// position of an expected line similar to act in index->lines, -1 if there is none
+static vx_int32 houghlinesp_find_similar(const houghlinesp_index* index, vx_line2d_t act, vx_float32 eps)
+{
+    vx_int32 tb = houghlinesp_theta_bin(&act), dt, dr, i;
+
+    for (dt = -1; dt <= 1; dt++)
+    {
+        // theta wraps around pi
+        vx_int32 t = (tb + dt + HOUGH_THETA_BINS) % HOUGH_THETA_BINS;
+        vx_int32 rb = houghlinesp_rho_bin(index, houghlinesp_rho(&act, t));
+
+        for (dr = -1; dr <= 1; dr++)
+        {
+            vx_int32 b;
+            if (rb + dr < 0 || rb + dr >= index->num_rho_bins)
+                continue;
+            b = t * index->num_rho_bins + rb + dr;
+            for (i = index->bucket_start[b]; i < index->bucket_start[b + 1]; i++)
+                if (similar_lines(act, index->lines[i], eps))
+                    return i;
+        }
+    }
+
+    for (i = 0; i < index->num_lines; i++)
+        if (similar_lines(act, index->lines[i], eps))
+            return i;
+
+    return -1;
+}
+
+static vx_status countLine2dIntersection(const houghlinesp_index *expect_index, const vx_line2d_t *actual_lines, vx_int32 actual_lines_num, vx_float32 eps)
 {
     vx_status status = VX_FAILURE;
+    vx_int32 exp_lines_num = expect_index->num_lines;
     vx_int32 count = 0;
     if (exp_lines_num && actual_lines_num)
     {
         for (vx_int32 x = 0; x < actual_lines_num; x++)
         {
-            vx_line2d_t act = actual_lines[x];
-            for (vx_int32 y = 0; y < exp_lines_num; y++)
-            {
-                vx_line2d_t exp = expect_lines[y];
-                vx_bool sim = similar_lines(act, exp, eps);
-                if (sim)
-                {
-                    count++;
-                    break;
-                }
-            }
+            if (houghlinesp_find_similar(expect_index, actual_lines[x], eps) >= 0)
+                count++;
         }
     }
     if ((vx_float32)count / (exp_lines_num < actual_lines_num ? exp_lines_num : actual_lines_num) >= 0.8)
@@ -141,60 +277,130 @@ static vx_status countLine2dIntersection(const vx_line2d_t *expect_lines, const
     return status;
 }
 
-static vx_status houghlinesp_check(vx_array lines_array, vx_scalar num_lines, const char* result_filename)
+// the index is parsed for every test and released with the other test resources
+static void houghlinesp_load_golden(const char* result_filename, houghlinesp_index* index)
 {
-    vx_status status = VX_FAILURE;
+    vx_line2d_t* exp_lines = NULL;
+    vx_int32 id = 0, capacity = 1;
     vx_size sz = 0;
-    void* buf = 0;
+    char* buf = 0;
+    char* pos;
+
+    ASSERT(strlen(result_filename) < MAXPATHLENGTH);
 
     char file[MAXPATHLENGTH];
     sz = snprintf(file, MAXPATHLENGTH, "%s/%s", ct_get_test_file_path(), result_filename);
     FILE* f = fopen(file, "rb");
-    ASSERT_(return VX_FAILURE, f);
+    ASSERT(f);
     fseek(f, 0, SEEK_END);
 
     sz = ftell(f);
     fseek(f, 0, SEEK_SET);
 
-    ASSERT_(return VX_FAILURE, buf = ct_alloc_mem(sz + 1));
-    ASSERT_(return VX_FAILURE, sz == fread(buf, 1, sz, f));
+    buf = (char*)ct_alloc_mem(sz + 1);
+    if (buf == NULL || sz != fread(buf, 1, sz, f))
+    {
+        fclose(f);
+        ct_free_mem(buf);
+        CT_FAIL("Can't read %s", file);
+    }
     fclose(f); f = NULL;
-    ((vx_int8*)buf)[sz] = 0;
+    buf[sz] = 0;
 
-    vx_size lines_array_stride = 0;
-    void *lines_array_ptr = NULL;
-    vx_map_id lines_array_map_id;
-    vx_size lines_array_length;
-    vxQueryArray(lines_array, VX_ARRAY_NUMITEMS, &lines_array_length, sizeof(lines_array_length));
-    vxMapArrayRange(lines_array, 0, lines_array_length, &lines_array_map_id, &lines_array_stride, &lines_array_ptr, VX_READ_ONLY, VX_MEMORY_TYPE_HOST, VX_NOGAP_X);
-    vx_line2d_t *lines_array_p = (vx_line2d_t *)lines_array_ptr;
-    vx_line2d_t *exp_lines = 0;
-    ASSERT_(return VX_FAILURE, exp_lines = ct_alloc_mem(sizeof(vx_line2d_t) * MAX_NUM_EXP_LINES));
-
-    vx_int32 id = 0;
-    char * pos = buf;
-    char * next = 0;
-    while (pos && (next = strchr(pos, '\n')))
+    // one line per text line at most
+    for (pos = buf; *pos; pos++)
+        capacity += *pos == '\n';
+    exp_lines = (vx_line2d_t*)ct_alloc_mem(capacity * sizeof(vx_line2d_t));
+    if (!exp_lines)
+    {
+        ct_free_mem(buf);
+        CT_FAIL("Can't parse %s", file);
+    }
+
+    for (pos = buf; pos && *pos; pos = strchr(pos, '\n'), pos = pos ? pos + 1 : NULL)
     {
-        
         vx_float32 x1, y1, x2, y2;
         vx_int32 line_id;
 
-        *next = 0;
-        (void)sscanf(pos, "%d %f %f %f %f", &line_id, &x1, &y1, &x2, &y2);
+        if (sscanf(pos, "%d %f %f %f %f", &line_id, &x1, &y1, &x2, &y2) != 5)
+            continue;
+
         exp_lines[id].start_x = x1;
         exp_lines[id].start_y = y1;
         exp_lines[id].end_x = x2;
         exp_lines[id].end_y = y2;
-        pos = next + 1;
         id++;
     }
-    vx_int32 exp_lines_num = id + 1;
-    status = countLine2dIntersection(exp_lines, lines_array_p, exp_lines_num, lines_array_length, 2.0f);
+    ct_free_mem(buf);
+
+    if (!houghlinesp_build_index(exp_lines, id, index))
+    {
+        ct_free_mem(exp_lines);
+        CT_FAIL("Can't parse %s", file);
+    }
+    ct_free_mem(exp_lines);
+
+    houghlinesp_collect_index(index);
+}
+
+// fraction of the expected lines which have a similar actual line
+static vx_float32 houghlinesp_recall(const houghlinesp_index* expect_index, const vx_line2d_t* actual_lines, vx_int32 actual_lines_num, vx_float32 eps)
+{
+    vx_uint8* matched;
+    vx_int32 x, i, count = 0;
+
+    if (expect_index->num_lines == 0)
+        return 1;
+
+    matched = (vx_uint8*)ct_calloc(expect_index->num_lines, sizeof(vx_uint8));
+    if (!matched)
+        return 0;
+
+    for (x = 0; x < actual_lines_num; x++)
+    {
+        i = houghlinesp_find_similar(expect_index, actual_lines[x], eps);
+        if (i >= 0 && !matched[i])
+        {
+            matched[i] = 1;
+            count++;
+        }
+    }
+
+    ct_free_mem(matched);
+    return (vx_float32)count / expect_index->num_lines;
+}
+
+// 'recall' (optional) receives houghlinesp_recall() of the detected lines
+static vx_status houghlinesp_check_lines(vx_array lines_array, const houghlinesp_index* expect_index, vx_float32* recall)
+{
+    vx_status status = VX_FAILURE;
+    vx_size lines_array_stride = 0;
+    void *lines_array_ptr = NULL;
+    vx_map_id lines_array_map_id;
+    vx_size lines_array_length = 0;
+
+    VX_CALL_RET(vxQueryArray(lines_array, VX_ARRAY_NUMITEMS, &lines_array_length, sizeof(lines_array_length)));
+    if (lines_array_length == 0)
+        return VX_FAILURE;
+
+    VX_CALL_RET(vxMapArrayRange(lines_array, 0, lines_array_length, &lines_array_map_id, &lines_array_stride, &lines_array_ptr, VX_READ_ONLY, VX_MEMORY_TYPE_HOST, VX_NOGAP_X));
+    status = countLine2dIntersection(expect_index, (const vx_line2d_t *)lines_array_ptr, (vx_int32)lines_array_length, 2.0f);
+    if (recall)
+        *recall = houghlinesp_recall(expect_index, (const vx_line2d_t *)lines_array_ptr, (vx_int32)lines_array_length, 2.0f);
     vxUnmapArrayRange(lines_array, lines_array_map_id);
     return status;
 }
 
+static vx_status houghlinesp_check(vx_array lines_array, vx_scalar num_lines, const char* result_filename)
+{
+    houghlinesp_index expect_index;
+    (void)num_lines;
+
+    ASSERT_NO_FAILURE_(return VX_FAILURE, houghlinesp_load_golden(result_filename, &expect_index));
+
+    return houghlinesp_check_lines(lines_array, &expect_index, NULL);
+}
+
 typedef struct {
     const char* testName;
     CT_Image(*generator)(const char* fileName, int width, int height);
@@ -302,7 +508,151 @@ TEST_WITH_ARG(Houghlinesp, testImmediateProcessing, Arg,
     ASSERT(src_image == 0);
 }
 
+static void houghlinesp_draw_line(CT_Image image, vx_int32 x0, vx_int32 y0, vx_int32 x1, vx_int32 y1)
+{
+    vx_int32 dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    vx_int32 dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    vx_int32 err = dx + dy;
+
+    for (;;)
+    {
+        *CT_IMAGE_DATA_PTR_8U(image, x0, y0) = 255;
+        if (x0 == x1 && y0 == y1)
+            break;
+        if (2 * err >= dy)
+        {
+            err += dy;
+            x0 += sx;
+        }
+        if (2 * err <= dx)
+        {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+#define HOUGH_SYNTHETIC_MARGIN 6
+// the segments are isolated and well above the detection thresholds, almost all must be found
+#define HOUGH_SYNTHETIC_MIN_RECALL 0.9f
+
+// one segment of random direction through the center of every cell x cell block,
+// blocks are separated by margins so segments never touch each other
+static CT_Image houghlinesp_generate_lines(uint64_t* rng, vx_uint32 width, vx_uint32 height, vx_uint32 cell,
+                                           vx_line2d_t* lines, vx_int32* num_lines)
+{
+    CT_Image image = NULL;
+    vx_float32 half = (vx_float32)(cell / 2 - HOUGH_SYNTHETIC_MARGIN);
+    vx_uint32 cx, cy;
+    vx_int32 n = 0;
+
+    ASSERT_(return NULL, cell > 2 * HOUGH_SYNTHETIC_MARGIN);
+    ASSERT_NO_FAILURE_(return NULL, image = ct_allocate_image(width, height, VX_DF_IMAGE_U8));
+    ct_memset(image->data.y, 0, (size_t)image->stride * height);
+
+    for (cy = 0; cy + cell <= height; cy += cell)
+    {
+        for (cx = 0; cx + cell <= width; cx += cell)
+        {
+            vx_float64 angle = CT_RNG_NEXT_INT(*rng, 0, 180) * M_PI / 180;
+            vx_int32 dx = (vx_int32)floor(half * cos(angle) + 0.5);
+            vx_int32 dy = (vx_int32)floor(half * sin(angle) + 0.5);
+            vx_int32 x = (vx_int32)(cx + cell / 2), y = (vx_int32)(cy + cell / 2);
+
+            houghlinesp_draw_line(image, x - dx, y - dy, x + dx, y + dy);
+
+            lines[n].start_x = (vx_float32)(x - dx);
+            lines[n].start_y = (vx_float32)(y - dy);
+            lines[n].end_x = (vx_float32)(x + dx);
+            lines[n].end_y = (vx_float32)(y + dy);
+            n++;
+        }
+    }
+
+    *num_lines = n;
+    return image;
+}
+
+typedef struct {
+    const char* testName;
+    vx_uint32 width, height;
+    vx_uint32 cell;
+} synthetic_arg;
+
+TEST_WITH_ARG(Houghlinesp, testSyntheticLines, synthetic_arg,
+    ARG("640x480", 640, 480, 48),
+    ARG_PRODUCTION_BEGIN(),
+    ARG("1920x1080", 1920, 1080, 48),
+    ARG("3840x2160", 3840, 2160, 48),
+    ARG_PRODUCTION_END()
+)
+{
+    vx_context context = context_->vx_context_;
+    vx_image src_image = 0;
+    vx_graph graph = 0;
+    vx_node node = 0;
+    vx_array lines_array = 0;
+    vx_scalar num_lines = 0;
+    vx_size numlines = 0;
+    CT_Image src = NULL;
+    vx_hough_lines_p_t param_lines_p = {1, M_PI/180, 15, 20, 5, M_PI, 0};
+    vx_line2d_t* exp_lines = NULL;
+    vx_int32 exp_lines_num = 0;
+    houghlinesp_index index;
+    vx_status status;
+    vx_float32 recall = 0;
+    int64_t time_start;
+    double node_ms, check_ms;
+
+    exp_lines = (vx_line2d_t*)ct_alloc_mem((arg_->width / arg_->cell) * (arg_->height / arg_->cell) * sizeof(vx_line2d_t));
+    ASSERT(exp_lines);
+    ASSERT_NO_FAILURE_({ ct_free_mem(exp_lines); return; },
+        src = houghlinesp_generate_lines(&CT()->seed_, arg_->width, arg_->height, arg_->cell, exp_lines, &exp_lines_num));
+    if (!houghlinesp_build_index(exp_lines, exp_lines_num, &index))
+    {
+        ct_free_mem(exp_lines);
+        FAIL("Can't index %d lines", exp_lines_num);
+    }
+    ct_free_mem(exp_lines);
+    houghlinesp_collect_index(&index);
+
+    ASSERT_VX_OBJECT(src_image = ct_image_to_vx_image(src, context), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(lines_array = vxCreateArray(context, VX_TYPE_LINE_2D, exp_lines_num * 8), VX_TYPE_ARRAY);
+    ASSERT_VX_OBJECT(num_lines = vxCreateScalar(context, VX_TYPE_SIZE, &numlines), VX_TYPE_SCALAR);
+    ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+    ASSERT_VX_OBJECT(node = vxHoughLinesPNode(graph, src_image, &param_lines_p, lines_array, num_lines), VX_TYPE_NODE);
+
+    VX_CALL(vxVerifyGraph(graph));
+    time_start = CT_getTickCount();
+    VX_CALL(vxProcessGraph(graph));
+    node_ms = CT_getElapsedMs(time_start);
+    time_start = CT_getTickCount();
+
+    status = houghlinesp_check_lines(lines_array, &index, &recall);
+    check_ms = CT_getElapsedMs(time_start);
+
+    VX_CALL(vxCopyScalar(num_lines, &numlines, VX_READ_ONLY, VX_MEMORY_TYPE_HOST));
+    CT_TIME_PRINTF("    %d expected lines, %d detected, recall %.3f: node %.2f ms, check %.2f ms\n",
+                   exp_lines_num, (int)numlines, recall, node_ms, check_ms);
+    ASSERT(status == VX_SUCCESS);
+    if (recall < HOUGH_SYNTHETIC_MIN_RECALL)
+        FAIL("Only %.1f%% of %d generated lines are detected", recall * 100, exp_lines_num);
+
+    VX_CALL(vxReleaseNode(&node));
+    VX_CALL(vxReleaseGraph(&graph));
+    VX_CALL(vxReleaseArray(&lines_array));
+    VX_CALL(vxReleaseScalar(&num_lines));
+    VX_CALL(vxReleaseImage(&src_image));
+
+    ASSERT(node == 0);
+    ASSERT(graph == 0);
+    ASSERT(lines_array == 0);
+    ASSERT(num_lines == 0);
+    ASSERT(src_image == 0);
+}
+
 TESTCASE_TESTS(Houghlinesp, 
                testNodeCreation, 
                testGraphProcessing, 
-               testImmediateProcessing)
+               testImmediateProcessing,
+               testSyntheticLines)
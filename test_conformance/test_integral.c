@@ -57,6 +57,17 @@ static CT_Image integral_generate_random(const char* fileName, int width, int he
     return image;
 }
 
+// the same as integral_generate_random(), filled with ct_allocate_ct_image_random_keyed() for the production-size inputs
+static CT_Image integral_generate_random_keyed(const char* fileName, int width, int height)
+{
+    CT_Image image;
+
+    ASSERT_NO_FAILURE_(return 0,
+            image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+
+    return image;
+}
+
 static CT_Image integral_read_image(const char* fileName, int width, int height)
 {
     CT_Image image = NULL;
@@ -122,7 +133,10 @@ typedef struct {
 
 #define PARAMETERS \
     CT_GENERATE_PARAMETERS("randomInput", ADD_SIZE_SMALL_SET, ARG, integral_generate_random, NULL), \
-    CT_GENERATE_PARAMETERS("lena", ADD_SIZE_NONE, ARG, integral_read_image, "lena.bmp")
+    CT_GENERATE_PARAMETERS("lena", ADD_SIZE_NONE, ARG, integral_read_image, "lena.bmp"), \
+    ARG_PRODUCTION_BEGIN(), \
+    CT_GENERATE_PARAMETERS("randomInput", ADD_SIZE_PRODUCTION_SET, ARG, integral_generate_random_keyed, NULL), \
+    ARG_PRODUCTION_END()
 
 TEST_WITH_ARG(Integral, testGraphProcessing, Arg,
     PARAMETERS
@@ -0,0 +1,50 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_engine/test.h"
+#include "test_engine/test_kernel_trace.h"
+
+// matching of --changed_kernels lists, the selection itself needs a recorded kernel map
+TESTCASE(KernelTrace, CT_VoidContext, 0, 0)
+
+TEST(KernelTrace, testChangedKernelsSeparators)
+{
+    const char* box = "org.khronos.openvx.box_3x3";
+
+    ASSERT(ct_kernel_trace_is_changed(box, "box_3x3"));
+    ASSERT(ct_kernel_trace_is_changed(box, "org.khronos.openvx.box_3x3"));
+
+    // ',' and ':' are both accepted, also mixed in one list
+    ASSERT(ct_kernel_trace_is_changed(box, "median_3x3,box_3x3"));
+    ASSERT(ct_kernel_trace_is_changed(box, "median_3x3:box_3x3"));
+    ASSERT(ct_kernel_trace_is_changed(box, "median_3x3:org.khronos.openvx.sobel_3x3,box_3x3"));
+    ASSERT(ct_kernel_trace_is_changed(box, "box_3x3,median_3x3:sobel_3x3"));
+
+    // empty items are skipped
+    ASSERT(ct_kernel_trace_is_changed(box, ",:box_3x3,"));
+    ASSERT(!ct_kernel_trace_is_changed(box, ""));
+    ASSERT(!ct_kernel_trace_is_changed(box, ",:"));
+
+    // names match as a whole, other separators are part of the name
+    ASSERT(!ct_kernel_trace_is_changed(box, "box"));
+    ASSERT(!ct_kernel_trace_is_changed(box, "box_3x3x"));
+    ASSERT(!ct_kernel_trace_is_changed(box, "openvx.box_3x3"));
+    ASSERT(!ct_kernel_trace_is_changed(box, "median_3x3;box_3x3"));
+    ASSERT(!ct_kernel_trace_is_changed(box, "median_3x3 box_3x3"));
+}
+
+TESTCASE_TESTS(KernelTrace, testChangedKernelsSeparators)
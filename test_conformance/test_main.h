@@ -19,6 +19,9 @@ TESTCASE(Graph)
 TESTCASE(GraphCallback)
 TESTCASE(GraphDelay)
 TESTCASE(GraphROI)
+TESTCASE(GraphROITiled)
+TESTCASE(GraphConcurrency)
+TESTCASE(GraphScaling)
 
 TESTCASE(Array)
 TESTCASE(ObjectArray)
@@ -28,6 +31,7 @@ TESTCASE(vxCreateImageFromChannel)
 
 TESTCASE(vxCopyImagePatch)
 TESTCASE(vxMapImagePatch)
+TESTCASE(ImageBandwidth)
 
 TESTCASE(vxuConvertDepth)
 TESTCASE(vxConvertDepth)
@@ -104,6 +108,8 @@ TESTCASE(UserNode)
 
 TESTCASE(Logging)
 TESTCASE(SmokeTest)
+TESTCASE(KernelTrace)
+TESTCASE(CTImage)
 
 TESTCASE(Scalar)
 
@@ -18,6 +18,7 @@
 #include "test_engine/test.h"
 #include <VX/vx.h>
 #include <VX/vxu.h>
+#include <string.h>
 
 typedef struct
 {
@@ -218,4 +219,542 @@ TEST_WITH_ARG(MatchTemplate,  testImmediateProcessing, method_type_arg,
     ASSERT(vx_source_image == 0);
     ASSERT(vx_result_image == 0);}
 
-TESTCASE_TESTS(MatchTemplate, testNodeCreation, testGraphProcessing, testImmediateProcessing)
+/*
+    Reference comparison map of all VX_COMPARE_* methods.
+
+    The correlation term sum(T * I) of CCORR/L2 and their normalized variants is computed
+    directly for small templates and with tiled FFT (overlap-save) for large ones; the
+    window sums of I^2 come from an integral image. L1 and HAMMING are computed directly,
+    rows are subsampled when the direct computation would be too slow.
+*/
+#define MATCH_TEMPLATE_FFT_MIN_AREA     1024        // templates from 32x32 use FFT correlation
+#define MATCH_TEMPLATE_DIRECT_BUDGET    (1 << 30)   // max multiply-adds of the direct reference
+#define MATCH_TEMPLATE_ACCEPTANCE       0.99        // share of pixels within the tolerance
+
+static int match_template_uses_ccorr(vx_enum method)
+{
+    return method == VX_COMPARE_CCORR || method == VX_COMPARE_CCORR_NORM ||
+           method == VX_COMPARE_L2 || method == VX_COMPARE_L2_NORM;
+}
+
+typedef struct
+{
+    CT_Image src, tmpl;
+    vx_enum  method;
+    uint32_t width, height;     // size of the comparison map
+    uint32_t row_step;          // only rows with y % row_step == 0 are computed
+    double*  result;            // raw sum(T * I) for correlation based methods
+} match_template_direct_job;
+
+static void match_template_direct_rows(void* job_, int begin, int end)
+{
+    match_template_direct_job* job = (match_template_direct_job*)job_;
+    CT_Image src = job->src, tmpl = job->tmpl;
+    int r;
+
+    for (r = begin; r < end; r++)
+    {
+        uint32_t y = (uint32_t)r * job->row_step, x, u, v;
+
+        for (x = 0; x < job->width; x++)
+        {
+            uint64_t sum = 0;
+
+            for (v = 0; v < tmpl->height; v++)
+            {
+                const uint8_t* t = CT_IMAGE_DATA_PTR_8U(tmpl, 0, v);
+                const uint8_t* i = CT_IMAGE_DATA_PTR_8U(src, x, y + v);
+
+                if (job->method == VX_COMPARE_HAMMING)
+                {
+                    for (u = 0; u < tmpl->width; u++)
+                    {
+                        uint32_t b = t[u] ^ i[u];
+                        b = b - ((b >> 1) & 0x55);
+                        b = (b & 0x33) + ((b >> 2) & 0x33);
+                        sum += (b + (b >> 4)) & 0x0F;
+                    }
+                }
+                else if (job->method == VX_COMPARE_L1)
+                {
+                    for (u = 0; u < tmpl->width; u++)
+                        sum += t[u] > i[u] ? t[u] - i[u] : i[u] - t[u];
+                }
+                else
+                {
+                    for (u = 0; u < tmpl->width; u++)
+                        sum += (uint32_t)t[u] * i[u];
+                }
+            }
+
+            job->result[(size_t)y * job->width + x] = (double)sum;
+        }
+    }
+}
+
+typedef struct
+{
+    int     n;          // power of two
+    double* cos_table;  // cos(2*pi*k/n), k < n/2
+    double* sin_table;
+} match_template_fft_plan;
+
+static void match_template_fft(const match_template_fft_plan* plan, double* re, double* im, int inverse)
+{
+    int n = plan->n, i, j, len;
+
+    for (i = 1, j = 0; i < n; i++)
+    {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+        {
+            double tr = re[i], ti = im[i];
+            re[i] = re[j]; im[i] = im[j];
+            re[j] = tr; im[j] = ti;
+        }
+    }
+
+    for (len = 2; len <= n; len <<= 1)
+    {
+        int half = len / 2, step = n / len;
+        for (i = 0; i < n; i += len)
+        {
+            for (j = 0; j < half; j++)
+            {
+                double wr = plan->cos_table[j * step];
+                double wi = inverse ? plan->sin_table[j * step] : -plan->sin_table[j * step];
+                int a = i + j, b = i + j + half;
+                double tr = re[b] * wr - im[b] * wi;
+                double ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr; im[b] = im[a] - ti;
+                re[a] += tr;        im[a] += ti;
+            }
+        }
+    }
+}
+
+// n x n transform of rows, then of columns gathered into col_re/col_im
+static void match_template_fft_2d(const match_template_fft_plan* plan, double* re, double* im, double* col_re, double* col_im, int inverse)
+{
+    int n = plan->n, x, y;
+
+    for (y = 0; y < n; y++)
+        match_template_fft(plan, re + (size_t)y * n, im + (size_t)y * n, inverse);
+
+    for (x = 0; x < n; x++)
+    {
+        for (y = 0; y < n; y++)
+        {
+            col_re[y] = re[(size_t)y * n + x];
+            col_im[y] = im[(size_t)y * n + x];
+        }
+        match_template_fft(plan, col_re, col_im, inverse);
+        for (y = 0; y < n; y++)
+        {
+            re[(size_t)y * n + x] = col_re[y];
+            im[(size_t)y * n + x] = col_im[y];
+        }
+    }
+}
+
+typedef struct
+{
+    CT_Image src;
+    uint32_t tw, th;
+    uint32_t width, height;     // size of the comparison map
+    uint32_t tiles_x;
+    match_template_fft_plan plan;
+    const double* tmpl_re;      // spectrum of the zero padded template
+    const double* tmpl_im;
+    double*  result;
+    int      failed;
+} match_template_fft_job;
+
+static void match_template_fft_tiles(void* job_, int begin, int end)
+{
+    match_template_fft_job* job = (match_template_fft_job*)job_;
+    int n = job->plan.n, tile;
+    size_t size = (size_t)n * n, k;
+    uint32_t step_x = n - job->tw + 1, step_y = n - job->th + 1;
+    double* re = (double*)ct_alloc_mem(size * sizeof(double));
+    double* im = (double*)ct_alloc_mem(size * sizeof(double));
+    double* col_re = (double*)ct_alloc_mem(n * sizeof(double));
+    double* col_im = (double*)ct_alloc_mem(n * sizeof(double));
+
+    if (re && im && col_re && col_im)
+    {
+        for (tile = begin; tile < end; tile++)
+        {
+            uint32_t ox = (tile % job->tiles_x) * step_x, oy = (tile / job->tiles_x) * step_y, x, y;
+
+            for (y = 0; y < (uint32_t)n; y++)
+            {
+                for (x = 0; x < (uint32_t)n; x++)
+                {
+                    int inside = ox + x < job->src->width && oy + y < job->src->height;
+                    re[(size_t)y * n + x] = inside ? *CT_IMAGE_DATA_PTR_8U(job->src, ox + x, oy + y) : 0;
+                    im[(size_t)y * n + x] = 0;
+                }
+            }
+
+            match_template_fft_2d(&job->plan, re, im, col_re, col_im, 0);
+
+            // I * conj(T) is the spectrum of the circular cross-correlation
+            for (k = 0; k < size; k++)
+            {
+                double a = re[k], b = im[k], c = job->tmpl_re[k], d = job->tmpl_im[k];
+                re[k] = a * c + b * d;
+                im[k] = b * c - a * d;
+            }
+
+            match_template_fft_2d(&job->plan, re, im, col_re, col_im, 1);
+
+            // correlation is integer, rounding removes the FFT error
+            for (y = 0; y < step_y && oy + y < job->height; y++)
+                for (x = 0; x < step_x && ox + x < job->width; x++)
+                    job->result[(size_t)(oy + y) * job->width + ox + x] = floor(re[(size_t)y * n + x] / size + 0.5);
+        }
+    }
+    else
+    {
+        ct_global_lock();
+        job->failed = 1;
+        ct_global_unlock();
+    }
+
+    ct_free_mem(re);
+    ct_free_mem(im);
+    ct_free_mem(col_re);
+    ct_free_mem(col_im);
+}
+
+static void match_template_fft_correlation(CT_Image src, CT_Image tmpl, uint32_t width, uint32_t height, double* result)
+{
+    match_template_fft_job job;
+    double *tmpl_re = NULL, *tmpl_im = NULL, *col_re = NULL, *col_im = NULL;
+    uint32_t tiles_y, x, y;
+    size_t size;
+    int n = 64, k;
+
+    // tiles of 4x the template keep most of every transform useful
+    while (n < 4 * (int)CT_MAX(tmpl->width, tmpl->height))
+        n *= 2;
+    size = (size_t)n * n;
+
+    job.src = src;
+    job.tw = tmpl->width;
+    job.th = tmpl->height;
+    job.width = width;
+    job.height = height;
+    job.tiles_x = (width + n - tmpl->width) / (n - tmpl->width + 1);
+    tiles_y = (height + n - tmpl->height) / (n - tmpl->height + 1);
+    job.plan.n = n;
+    job.plan.cos_table = (double*)ct_alloc_mem(n / 2 * sizeof(double));
+    job.plan.sin_table = (double*)ct_alloc_mem(n / 2 * sizeof(double));
+    job.result = result;
+    job.failed = 0;
+
+    tmpl_re = (double*)ct_alloc_mem(size * sizeof(double));
+    tmpl_im = (double*)ct_alloc_mem(size * sizeof(double));
+    col_re = (double*)ct_alloc_mem(n * sizeof(double));
+    col_im = (double*)ct_alloc_mem(n * sizeof(double));
+
+    if (job.plan.cos_table && job.plan.sin_table && tmpl_re && tmpl_im && col_re && col_im)
+    {
+        for (k = 0; k < n / 2; k++)
+        {
+            job.plan.cos_table[k] = cos(2 * M_PI * k / n);
+            job.plan.sin_table[k] = sin(2 * M_PI * k / n);
+        }
+
+        for (y = 0; y < (uint32_t)n; y++)
+        {
+            for (x = 0; x < (uint32_t)n; x++)
+            {
+                tmpl_re[(size_t)y * n + x] = x < tmpl->width && y < tmpl->height ? *CT_IMAGE_DATA_PTR_8U(tmpl, x, y) : 0;
+                tmpl_im[(size_t)y * n + x] = 0;
+            }
+        }
+        match_template_fft_2d(&job.plan, tmpl_re, tmpl_im, col_re, col_im, 0);
+
+        job.tmpl_re = tmpl_re;
+        job.tmpl_im = tmpl_im;
+        ct_parallel_for(0, (int)(job.tiles_x * tiles_y), match_template_fft_tiles, &job);
+    }
+    else
+    {
+        job.failed = 1;
+    }
+
+    ct_free_mem(job.plan.cos_table);
+    ct_free_mem(job.plan.sin_table);
+    ct_free_mem(tmpl_re);
+    ct_free_mem(tmpl_im);
+    ct_free_mem(col_re);
+    ct_free_mem(col_im);
+
+    ASSERT_(return, job.failed == 0);
+}
+
+/*
+    Fills result (width * height, width = src->width - tmpl->width + 1) with the comparison map.
+    Rows not multiple of *row_step and pixels with undefined normalization are NAN.
+*/
+static void match_template_reference(CT_Image src, CT_Image tmpl, vx_enum method, double* result, uint32_t* row_step)
+{
+    uint32_t width = src->width - tmpl->width + 1, height = src->height - tmpl->height + 1;
+    uint32_t stride = src->width + 1, x, y, u, v;
+    int use_fft = match_template_uses_ccorr(method) && tmpl->width * tmpl->height >= MATCH_TEMPLATE_FFT_MIN_AREA;
+    uint64_t* sum2 = NULL;
+    uint64_t tmpl_sum2 = 0;
+    size_t k;
+
+    ASSERT(src->format == VX_DF_IMAGE_U8 && tmpl->format == VX_DF_IMAGE_U8);
+    ASSERT(src->width >= tmpl->width && src->height >= tmpl->height);
+
+    for (k = 0; k < (size_t)width * height; k++)
+        result[k] = NAN;
+
+    *row_step = 1;
+    if (use_fft)
+    {
+        ASSERT_NO_FAILURE(match_template_fft_correlation(src, tmpl, width, height, result));
+    }
+    else
+    {
+        match_template_direct_job job;
+        uint64_t work = (uint64_t)width * height * tmpl->width * tmpl->height;
+
+        *row_step = (uint32_t)((work + MATCH_TEMPLATE_DIRECT_BUDGET - 1) / MATCH_TEMPLATE_DIRECT_BUDGET);
+
+        job.src = src;
+        job.tmpl = tmpl;
+        job.method = method;
+        job.width = width;
+        job.height = height;
+        job.row_step = *row_step;
+        job.result = result;
+        ct_parallel_for(0, (int)((height + *row_step - 1) / *row_step), match_template_direct_rows, &job);
+    }
+
+    if (!match_template_uses_ccorr(method) || method == VX_COMPARE_CCORR)
+        return;
+
+    // integral image of I^2, (src->width + 1) x (src->height + 1)
+    sum2 = (uint64_t*)ct_alloc_mem((size_t)stride * (src->height + 1) * sizeof(uint64_t));
+    ASSERT(sum2);
+    for (x = 0; x < stride; x++)
+        sum2[x] = 0;
+    for (y = 0; y < src->height; y++)
+    {
+        const uint8_t* row = CT_IMAGE_DATA_PTR_8U(src, 0, y);
+        uint64_t row_sum = 0;
+        sum2[(size_t)(y + 1) * stride] = 0;
+        for (x = 0; x < src->width; x++)
+        {
+            row_sum += (uint32_t)row[x] * row[x];
+            sum2[(size_t)(y + 1) * stride + x + 1] = sum2[(size_t)y * stride + x + 1] + row_sum;
+        }
+    }
+
+    for (v = 0; v < tmpl->height; v++)
+        for (u = 0; u < tmpl->width; u++)
+            tmpl_sum2 += (uint32_t)*CT_IMAGE_DATA_PTR_8U(tmpl, u, v) * *CT_IMAGE_DATA_PTR_8U(tmpl, u, v);
+
+    for (y = 0; y < height; y += *row_step)
+    {
+        const uint64_t* top = sum2 + (size_t)y * stride;
+        const uint64_t* bottom = sum2 + (size_t)(y + tmpl->height) * stride;
+
+        for (x = 0; x < width; x++)
+        {
+            double* r = &result[(size_t)y * width + x];
+            double ccorr = *r;
+            double src_sum2 = (double)(bottom[x + tmpl->width] - bottom[x] - top[x + tmpl->width] + top[x]);
+            double norm = sqrt((double)tmpl_sum2 * src_sum2);
+            double l2 = (double)tmpl_sum2 - 2 * ccorr + src_sum2;
+
+            if (method == VX_COMPARE_L2)
+                *r = l2;
+            else if (norm > 0)
+                *r = (method == VX_COMPARE_L2_NORM ? l2 : ccorr) / norm;
+            else
+                *r = NAN;
+        }
+    }
+
+    ct_free_mem(sum2);
+}
+
+/*
+    Raw methods (HAMMING, L1, L2, CCORR) are stored as is, saturated to S16. Normalized methods
+    need a fixed-point encoding: the scale is estimated from the unsaturated output pixels and
+    must be a power of two between 2^7 and 2^15. Every pixel is then checked against the scaled
+    and saturated reference.
+*/
+static void match_template_check(CT_Image dst, vx_enum method, const double* ref, uint32_t row_step)
+{
+    double sum_or = 0, sum_rr = 0, fitted, scale = 1;
+    uint32_t x, y, num_checked = 0, num_failed = 0;
+    int32_t first_x = -1, first_y = -1, first_value = 0, first_expected = 0;
+
+    if (method == VX_COMPARE_L2_NORM || method == VX_COMPARE_CCORR_NORM)
+    {
+        for (y = 0; y < dst->height; y += row_step)
+        {
+            for (x = 0; x < dst->width; x++)
+            {
+                double r = ref[(size_t)y * dst->width + x];
+                int32_t o = *CT_IMAGE_DATA_PTR_16S(dst, x, y);
+                if (!isnan(r) && o > INT16_MIN && o < INT16_MAX)
+                {
+                    sum_or += o * r;
+                    sum_rr += r * r;
+                }
+            }
+        }
+
+        fitted = sum_rr > 0 ? sum_or / sum_rr : 0;
+        if (!(fitted > 0))
+            CT_FAIL("output scale estimated from unsaturated pixels is not positive: %g", fitted);
+
+        scale = pow(2, floor(log2(fitted) + 0.5));
+        if (scale < 128 || scale > 32768 || fabs(fitted / scale - 1) > 0.01)
+            CT_FAIL("normalized output is not fixed-point with 7 to 15 fraction bits, estimated scale: %g", fitted);
+    }
+
+    for (y = 0; y < dst->height; y += row_step)
+    {
+        for (x = 0; x < dst->width; x++)
+        {
+            double r = ref[(size_t)y * dst->width + x];
+            int32_t o = *CT_IMAGE_DATA_PTR_16S(dst, x, y);
+            double e;
+            int32_t expected;
+
+            if (isnan(r))
+                continue;
+
+            e = r == 0 ? 0 : r * scale;
+            expected = (int32_t)floor(CT_MAX(INT16_MIN, CT_MIN(INT16_MAX, e)) + 0.5);
+
+            num_checked++;
+            if (abs(o - expected) > 1 + 0.01 * abs(expected))
+            {
+                if (num_failed++ == 0)
+                {
+                    first_x = x;
+                    first_y = y;
+                    first_value = o;
+                    first_expected = expected;
+                }
+            }
+        }
+    }
+
+    if (num_failed > (1 - MATCH_TEMPLATE_ACCEPTANCE) * num_checked)
+    {
+        CT_FAIL("%u of %u pixels differ from reference, first at (%d, %d): %d, expected %d",
+                num_failed, num_checked, first_x, first_y, first_value, first_expected);
+    }
+}
+
+typedef struct
+{
+    const char* name;
+    vx_enum type;
+    uint32_t width, height;
+    uint32_t template_width, template_height;
+} match_template_size_arg;
+
+#define MATCH_TEMPLATE_SIZE_ARG(method, w, h, tw, th) \
+    ARG(#method "/" #w "x" #h "/template=" #tw "x" #th, method, w, h, tw, th)
+
+// the S16 encoding of the raw maps is not fixed by the specification and they mostly saturate
+// on random data, so these methods are checked in the production tier only
+#define MATCH_TEMPLATE_RAW_METHODS(w, h, tw, th) \
+    MATCH_TEMPLATE_SIZE_ARG(VX_COMPARE_HAMMING, w, h, tw, th), \
+    MATCH_TEMPLATE_SIZE_ARG(VX_COMPARE_L1, w, h, tw, th), \
+    MATCH_TEMPLATE_SIZE_ARG(VX_COMPARE_L2, w, h, tw, th), \
+    MATCH_TEMPLATE_SIZE_ARG(VX_COMPARE_CCORR, w, h, tw, th)
+
+#define MATCH_TEMPLATE_NORMALIZED_METHODS(w, h, tw, th) \
+    MATCH_TEMPLATE_SIZE_ARG(VX_COMPARE_L2_NORM, w, h, tw, th), \
+    MATCH_TEMPLATE_SIZE_ARG(VX_COMPARE_CCORR_NORM, w, h, tw, th)
+
+#define MATCH_TEMPLATE_METHODS(w, h, tw, th) \
+    MATCH_TEMPLATE_RAW_METHODS(w, h, tw, th), \
+    MATCH_TEMPLATE_NORMALIZED_METHODS(w, h, tw, th)
+
+TEST_WITH_ARG(MatchTemplate, testReference, match_template_size_arg,
+        MATCH_TEMPLATE_NORMALIZED_METHODS(640, 480, 8, 8),
+        MATCH_TEMPLATE_NORMALIZED_METHODS(640, 480, 31, 17),
+        ARG_PRODUCTION_BEGIN(),
+        MATCH_TEMPLATE_RAW_METHODS(640, 480, 8, 8),
+        MATCH_TEMPLATE_RAW_METHODS(640, 480, 31, 17),
+        MATCH_TEMPLATE_METHODS(640, 480, 64, 64),
+        MATCH_TEMPLATE_METHODS(1920, 1080, 16, 16),
+        MATCH_TEMPLATE_METHODS(1920, 1080, 64, 64),
+        MATCH_TEMPLATE_METHODS(1920, 1080, 128, 128),
+        ARG_PRODUCTION_END())
+{
+    vx_context context = context_->vx_context_;
+    vx_graph graph = 0;
+    vx_node node = 0;
+    vx_image vx_template_image = 0, vx_source_image = 0, vx_result_image = 0;
+    CT_Image ct_template_image = NULL, ct_source_image = NULL, ct_result_image = NULL;
+    uint32_t result_width = arg_->width - arg_->template_width + 1;
+    uint32_t result_height = arg_->height - arg_->template_height + 1;
+    uint32_t y, row_step = 1;
+    double* ref = NULL;
+    int64_t time_start;
+    double node_ms, ref_ms;
+
+    ASSERT_NO_FAILURE(ct_source_image = ct_allocate_ct_image_random_keyed(arg_->width, arg_->height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+
+    // the template is cut from the source, so there is an exact match
+    ASSERT_NO_FAILURE(ct_template_image = ct_allocate_image(arg_->template_width, arg_->template_height, VX_DF_IMAGE_U8));
+    for (y = 0; y < arg_->template_height; y++)
+        memcpy(CT_IMAGE_DATA_PTR_8U(ct_template_image, 0, y),
+               CT_IMAGE_DATA_PTR_8U(ct_source_image, arg_->width / 3, arg_->height / 3 + y), arg_->template_width);
+
+    ASSERT_VX_OBJECT(vx_source_image = ct_image_to_vx_image(ct_source_image, context), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(vx_template_image = ct_image_to_vx_image(ct_template_image, context), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(vx_result_image = vxCreateImage(context, result_width, result_height, VX_DF_IMAGE_S16), VX_TYPE_IMAGE);
+
+    ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+    ASSERT_VX_OBJECT(node = vxMatchTemplateNode(graph, vx_source_image, vx_template_image, arg_->type, vx_result_image), VX_TYPE_NODE);
+    VX_CALL(vxVerifyGraph(graph));
+    time_start = CT_getTickCount();
+    VX_CALL(vxProcessGraph(graph));
+    node_ms = CT_getElapsedMs(time_start);
+
+    ASSERT_NO_FAILURE(ct_result_image = ct_image_from_vx_image(vx_result_image));
+
+    ref = (double*)ct_alloc_mem((size_t)result_width * result_height * sizeof(double));
+    ASSERT(ref);
+    time_start = CT_getTickCount();
+    ASSERT_NO_FAILURE_({ ct_free_mem(ref); return; }, match_template_reference(ct_source_image, ct_template_image, arg_->type, ref, &row_step));
+    ref_ms = CT_getElapsedMs(time_start);
+    CT_TIME_PRINTF("    node: %.2f ms, reference: %.2f ms (%s, every %u row)\n", node_ms, ref_ms,
+                   match_template_uses_ccorr(arg_->type) && arg_->template_width * arg_->template_height >= MATCH_TEMPLATE_FFT_MIN_AREA ? "fft" : "direct",
+                   row_step);
+
+    ASSERT_NO_FAILURE_({ ct_free_mem(ref); return; }, match_template_check(ct_result_image, arg_->type, ref, row_step));
+    ct_free_mem(ref);
+
+    VX_CALL(vxReleaseNode(&node));
+    VX_CALL(vxReleaseGraph(&graph));
+    VX_CALL(vxReleaseImage(&vx_template_image));
+    VX_CALL(vxReleaseImage(&vx_source_image));
+    VX_CALL(vxReleaseImage(&vx_result_image));
+
+    ASSERT(vx_template_image == 0);
+    ASSERT(vx_source_image == 0);
+    ASSERT(vx_result_image == 0);
+}
+
+TESTCASE_TESTS(MatchTemplate, testNodeCreation, testGraphProcessing, testImmediateProcessing, testReference)
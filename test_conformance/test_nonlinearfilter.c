@@ -73,6 +73,7 @@ static CT_Image generate_random(const char* fileName, int width, int height)
     return image;
 }
 
+// straightforward reference, used to cross-check the histogram based implementation
 static int vx_uint8_compare(const void *p1, const void *p2)
 {
     vx_uint8 a = *(vx_uint8 *)p1;
@@ -117,7 +118,7 @@ static void filter_calculate(vx_enum function, CT_Image src, vx_coordinates2d_t*
     }
 }
 
-void filter_create_reference_image(vx_enum function, CT_Image src, vx_coordinates2d_t* origin, vx_size cols, vx_size rows, vx_uint8* mask, CT_Image* pdst, vx_border_t* border)
+static void filter_create_qsort_reference_image(vx_enum function, CT_Image src, vx_coordinates2d_t* origin, vx_size cols, vx_size rows, vx_uint8* mask, CT_Image* pdst, vx_border_t* border)
 {
     CT_Image dst = NULL;
 
@@ -147,6 +148,121 @@ void filter_create_reference_image(vx_enum function, CT_Image src, vx_coordinate
     *pdst = dst;
 }
 
+typedef struct {
+    vx_int32 dx, dy;
+} filter_offset;
+
+typedef struct {
+    vx_int32 count;     // number of non-zero mask elements
+    vx_int32 rank;      // index of the output value in the sorted window
+    filter_offset all[MASK_SIZE_MAX * MASK_SIZE_MAX];       // window of x = 0
+    vx_int32 num_removed;
+    filter_offset removed[MASK_SIZE_MAX * MASK_SIZE_MAX];   // leave the window on x -> x + 1, relative to x
+    vx_int32 num_added;
+    filter_offset added[MASK_SIZE_MAX * MASK_SIZE_MAX];     // enter the window on x -> x + 1, relative to x + 1
+} filter_window;
+
+/*
+    Sliding 256-bin histogram (Huang). The histogram is updated by the mask pixels which leave and enter
+    the window, the output value of rank 'rank' is tracked incrementally: 'less' is the number of
+    values in the window below 'value'.
+*/
+static void filter_calculate_row(const uint8_t* src, int32_t stride, void* dst_, uint32_t width, void* user_data)
+{
+    const filter_window* w = (const filter_window*)user_data;
+    uint8_t* dst = (uint8_t*)dst_;
+    int32_t hist[256] = { 0 };
+    int32_t value = 0, less = 0;
+    uint32_t x;
+    int i;
+
+    for (i = 0; i < w->count; i++)
+        hist[src[w->all[i].dy * stride + w->all[i].dx]]++;
+
+    for (x = 0; ; )
+    {
+        while (less > w->rank)
+        {
+            value--;
+            less -= hist[value];
+        }
+        while (less + hist[value] <= w->rank)
+        {
+            less += hist[value];
+            value++;
+        }
+        dst[x] = (uint8_t)value;
+
+        if (++x >= width)
+            break;
+
+        for (i = 0; i < w->num_removed; i++)
+        {
+            uint8_t v = src[w->removed[i].dy * stride + (int32_t)x - 1 + w->removed[i].dx];
+            hist[v]--;
+            if (v < value)
+                less--;
+        }
+        for (i = 0; i < w->num_added; i++)
+        {
+            uint8_t v = src[w->added[i].dy * stride + (int32_t)x + w->added[i].dx];
+            hist[v]++;
+            if (v < value)
+                less++;
+        }
+    }
+}
+
+static void filter_window_init(filter_window* w, vx_enum function, vx_coordinates2d_t* origin, vx_int32 cols, vx_int32 rows, vx_uint8* mask)
+{
+    vx_int32 i, j;
+
+    w->count = w->num_removed = w->num_added = 0;
+
+    for (j = 0; j < rows; ++j)
+    {
+        for (i = 0; i < cols; ++i)
+        {
+            filter_offset offset;
+
+            if (!mask[j * cols + i])
+                continue;
+
+            offset.dx = i - (vx_int32)origin->x;
+            offset.dy = j - (vx_int32)origin->y;
+
+            w->all[w->count++] = offset;
+            if (i == 0 || !mask[j * cols + i - 1])
+                w->removed[w->num_removed++] = offset;
+            if (i == cols - 1 || !mask[j * cols + i + 1])
+                w->added[w->num_added++] = offset;
+        }
+    }
+
+    switch (function)
+    {
+    case VX_NONLINEAR_FILTER_MIN: w->rank = 0; break;
+    case VX_NONLINEAR_FILTER_MAX: w->rank = w->count - 1; break;
+    default: w->rank = w->count / 2; break;
+    }
+}
+
+void filter_create_reference_image(vx_enum function, CT_Image src, vx_coordinates2d_t* origin, vx_size cols, vx_size rows, vx_uint8* mask, CT_Image* pdst, vx_border_t* border)
+{
+    CT_Image dst = NULL;
+    filter_window window;
+
+    CT_ASSERT(src->format == VX_DF_IMAGE_U8);
+    ASSERT(cols <= MASK_SIZE_MAX && rows <= MASK_SIZE_MAX);
+
+    filter_window_init(&window, function, origin, (vx_int32)cols, (vx_int32)rows, mask);
+    ASSERT(window.count > 0);
+
+    ASSERT_NO_FAILURE(dst = ct_filter_image_8u(src, *border, MASK_SIZE_MAX - 1, VX_DF_IMAGE_U8, filter_calculate_row, &window));
+
+    *pdst = dst;
+}
+
 static void pattern_check(vx_uint8* mask, vx_size cols, vx_size rows, vx_enum pattern)
 {
     vx_size x, y;
@@ -409,4 +525,63 @@ TEST_WITH_ARG(NonLinearFilter, testGraphProcessingWithNondefaultOrginMatrix, Fil
     ASSERT(dst_image == 0);
     ASSERT(src_image == 0);
 }
-TESTCASE_TESTS(NonLinearFilter, testNodeCreation, testGraphProcessing, testImmediateProcessing, testGraphProcessingWithNondefaultOrginMatrix)
+#define EQUIVALENCE_ITERATIONS 200
+
+// the histogram reference against the qsort one, on random masks, origins, borders and small images
+TEST(NonLinearFilter, testReferenceEquivalence)
+{
+    static const vx_enum functions[] = { VX_NONLINEAR_FILTER_MIN, VX_NONLINEAR_FILTER_MAX, VX_NONLINEAR_FILTER_MEDIAN };
+    static const vx_enum border_modes[] = { VX_BORDER_UNDEFINED, VX_BORDER_REPLICATE, VX_BORDER_CONSTANT };
+    uint64_t rng;
+    int iter;
+
+    CT_RNG_INIT(rng, CT()->seed_);
+
+    for (iter = 0; iter < EQUIVALENCE_ITERATIONS; iter++)
+    {
+        vx_int32 cols = CT_RNG_NEXT_INT(rng, 1, MASK_SIZE_MAX + 1), rows = CT_RNG_NEXT_INT(rng, 1, MASK_SIZE_MAX + 1);
+        vx_int32 width = CT_RNG_NEXT_INT(rng, MASK_SIZE_MAX, 40), height = CT_RNG_NEXT_INT(rng, MASK_SIZE_MAX, 40);
+        // a narrow range of values gives many equal values in the window
+        vx_int32 num_values = CT_RNG_NEXT_BOOL(rng) ? 4 : 256;
+        vx_enum function = functions[CT_RNG_NEXT_INT(rng, 0, 3)];
+        vx_uint8 mask[MASK_SIZE_MAX * MASK_SIZE_MAX];
+        vx_coordinates2d_t origin;
+        vx_border_t border;
+        CT_Image src = NULL, dst = NULL, dst_qsort = NULL;
+        vx_int32 i, count = 0;
+
+        for (i = 0; i < cols * rows; i++)
+        {
+            mask[i] = CT_RNG_NEXT_BOOL(rng) ? 255 : 0;
+            count += mask[i] != 0;
+        }
+        if (count == 0)
+            mask[CT_RNG_NEXT_INT(rng, 0, cols * rows)] = 255;
+
+        origin.x = CT_RNG_NEXT_INT(rng, 0, cols);
+        origin.y = CT_RNG_NEXT_INT(rng, 0, rows);
+        border.mode = border_modes[CT_RNG_NEXT_INT(rng, 0, 3)];
+        border.constant_value.U8 = (vx_uint8)CT_RNG_NEXT_INT(rng, 0, num_values);
+
+        ASSERT_NO_FAILURE(src = ct_allocate_ct_image_random(width, height, VX_DF_IMAGE_U8, &rng, 0, num_values));
+        ASSERT_NO_FAILURE(filter_create_reference_image(function, src, &origin, cols, rows, mask, &dst, &border));
+        ASSERT_NO_FAILURE(filter_create_qsort_reference_image(function, src, &origin, cols, rows, mask, &dst_qsort, &border));
+
+        if (border.mode == VX_BORDER_UNDEFINED)
+        {
+            ct_adjust_roi(dst, origin.x, origin.y, cols - origin.x - 1, rows - origin.y - 1);
+            ct_adjust_roi(dst_qsort, origin.x, origin.y, cols - origin.x - 1, rows - origin.y - 1);
+        }
+
+        EXPECT_EQ_CTIMAGE(dst_qsort, dst);
+        if (CT_HasFailure())
+        {
+            printf("=== %dx%d mask, origin (%d, %d), function %d, border %d, %dx%d image ===\n",
+                   cols, rows, origin.x, origin.y, function, border.mode, width, height);
+            return;
+        }
+    }
+}
+
+TESTCASE_TESTS(NonLinearFilter, testNodeCreation, testGraphProcessing, testImmediateProcessing, testGraphProcessingWithNondefaultOrginMatrix,
+               testReferenceEquivalence)
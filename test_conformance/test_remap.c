@@ -124,9 +124,6 @@ TEST(Remap, testNodeCreation)
 #define VX_MAP_SCALE_ROTATE  2
 #define VX_MAP_RANDOM        3
 
-#define VX_NN_AREA_SIZE         1.5
-#define VX_BILINEAR_TOLERANCE   1
-
 static CT_Image remap_read_image_8u(const char* fileName, int width, int height)
 {
     CT_Image image = NULL;
@@ -148,6 +145,17 @@ static CT_Image remap_generate_random(const char* fileName, int width, int heigh
     return image;
 }
 
+// the same as remap_generate_random(), filled with ct_allocate_ct_image_random_keyed() for the production-size inputs
+static CT_Image remap_generate_random_keyed(const char* fileName, int width, int height)
+{
+    CT_Image image;
+
+    ASSERT_NO_FAILURE_(return 0,
+            image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+
+    return image;
+}
+
 #define RND_FLT(low, high)      (vx_float32)CT_RNG_NEXT_REAL(CT()->seed_, low, high);
 
 static vx_remap remap_generate_map(vx_context context, int src_width, int src_height, int dst_width, int dst_height, int type)
@@ -251,98 +259,37 @@ static vx_remap remap_generate_map(vx_context context, int src_width, int src_he
 }
 
 
-static int remap_check_pixel(CT_Image input, CT_Image output, int x, int y, vx_float32 _x0,
-     vx_float32 _y0, vx_enum interp_type, vx_border_t border, vx_remap map, vx_bool do_report)
+static void remap_validate_coords(CT_Image input, CT_Image output, vx_enum interp_type, vx_border_t border,
+                                  const vx_coordinates2df_t* coords, vx_size stride_y)
 {
-    vx_float64 x0, y0, xlower, ylower, s, t;
-    vx_int32 xi, yi;
-    int candidate;
-    vx_uint8 res = *CT_IMAGE_DATA_PTR_8U(output, x, y);
+    CT_GeomMapping mapping = { CT_GEOM_MAPPING_TABLE, NULL, NULL, 0 };
+    CT_GeomResult result;
 
-    x0 = (vx_float64)_x0;
-    y0 = (vx_float64)_y0;
+    mapping.table = coords;
+    mapping.table_stride = stride_y;
 
     if (VX_INTERPOLATION_NEAREST_NEIGHBOR == interp_type)
     {
-        for (yi = (vx_int32)ceil(y0 - VX_NN_AREA_SIZE); (vx_float64)yi <= y0 + VX_NN_AREA_SIZE; yi++)
-        {
-            for (xi = (vx_int32)ceil(x0 - VX_NN_AREA_SIZE); (vx_float64)xi <= x0 + VX_NN_AREA_SIZE; xi++)
-            {
-                if (0 <= xi && 0 <= yi && xi < (vx_int32)input->width && yi < (vx_int32)input->height)
-                {
-                    candidate = *CT_IMAGE_DATA_PTR_8U(input, xi, yi);
-                }
-                else if (VX_BORDER_CONSTANT == border.mode)
-                {
-                    candidate = border.constant_value.U8;
-                }
-                else if (VX_BORDER_REPLICATE == border.mode)
-                {
-                    candidate = CT_IMAGE_DATA_REPLICATE_8U(input, xi, yi);
-                }
-                else
-                {
-                    candidate = -1;
-                }
-                if (candidate == -1 || candidate == res)
-                    return 0;
-            }
-        }
-        if (do_report)
-            CT_FAIL_(return 1, "Check failed for pixel (%d, %d): %d", x, y, (int)res);
-        else
-            return 1;
+        ASSERT_NO_FAILURE(ct_geom_validate(input, output, &mapping, border, ct_geom_check_nearest, NULL, &result));
+        if (result.num_failed > 0)
+            CT_FAIL_(return, "Check failed for %d pixels, first at (%d, %d): %d",
+                    (int)result.num_failed, result.first_x, result.first_y, (int)result.first_value);
     }
     else if (VX_INTERPOLATION_BILINEAR == interp_type)
     {
-        xlower = floor(x0);
-        ylower = floor(y0);
-
-        s = x0 - xlower;
-        t = y0 - ylower;
-
-        xi = (vx_int32)xlower;
-        yi = (vx_int32)ylower;
-
-        candidate = -1;
-        if (VX_BORDER_UNDEFINED == border.mode)
-        {
-            if (xi >= 0 && yi >= 0 && xi < (vx_int32)input->width - 1 && yi < (vx_int32)input->height - 1)
-            {
-                candidate = (int)((1. - s) * (1. - t) * (vx_float64) *CT_IMAGE_DATA_PTR_8U(input, xi    , yi    ) +
-                                        s  * (1. - t) * (vx_float64) *CT_IMAGE_DATA_PTR_8U(input, xi + 1, yi    ) +
-                                  (1. - s) *       t  * (vx_float64) *CT_IMAGE_DATA_PTR_8U(input, xi    , yi + 1) +
-                                        s  *       t  * (vx_float64) *CT_IMAGE_DATA_PTR_8U(input, xi + 1, yi + 1));
-            }
-        }
-        else if (VX_BORDER_CONSTANT == border.mode)
-        {
-            candidate = (int)((1. - s) * (1. - t) * (vx_float64)CT_IMAGE_DATA_CONSTANT_8U(input, xi    , yi    , border.constant_value.U8) +
-                                    s  * (1. - t) * (vx_float64)CT_IMAGE_DATA_CONSTANT_8U(input, xi + 1, yi    , border.constant_value.U8) +
-                              (1. - s) *       t  * (vx_float64)CT_IMAGE_DATA_CONSTANT_8U(input, xi    , yi + 1, border.constant_value.U8) +
-                                    s  *       t  * (vx_float64)CT_IMAGE_DATA_CONSTANT_8U(input, xi + 1, yi + 1, border.constant_value.U8));
-        }
-        else if (VX_BORDER_REPLICATE == border.mode)
-        {
-            candidate = (int)((1. - s) * (1. - t) * (vx_float64)CT_IMAGE_DATA_REPLICATE_8U(input, xi    , yi    ) +
-                                    s  * (1. - t) * (vx_float64)CT_IMAGE_DATA_REPLICATE_8U(input, xi + 1, yi    ) +
-                              (1. - s) *       t  * (vx_float64)CT_IMAGE_DATA_REPLICATE_8U(input, xi    , yi + 1) +
-                                    s  *       t  * (vx_float64)CT_IMAGE_DATA_REPLICATE_8U(input, xi + 1, yi + 1));
-        }
-        if (candidate == -1 || (abs(candidate - res) <= VX_BILINEAR_TOLERANCE))
-            return 0;
-        return 1;
+        ASSERT_NO_FAILURE(ct_geom_validate(input, output, &mapping, border, ct_geom_check_bilinear, NULL, &result));
+        if (10 * result.num_failed > output->width * output->height)
+            CT_FAIL_(return, "Check failed for %d pixels, first at (%d, %d): %d (expected %d)",
+                    (int)result.num_failed, result.first_x, result.first_y, (int)result.first_value, (int)result.first_expected);
     }
-    if (do_report)
-        CT_FAIL_(return 1, "Interpolation type undefined");
     else
-        return 1;
+    {
+        CT_FAIL_(return, "Interpolation type undefined");
+    }
 }
 
 static void remap_validate(CT_Image input, CT_Image output, vx_enum interp_type, vx_border_t border, vx_remap map)
 {
-    vx_uint32 err_count = 0;
-
     ASSERT(output != NULL);
     ASSERT(output->format == VX_DF_IMAGE_U8);
     ASSERT(output->width > 0);
@@ -356,22 +303,10 @@ static void remap_validate(CT_Image input, CT_Image output, vx_enum interp_type,
         ASSERT(ptr_r);
         vxCopyRemapPatch(map, &rect, stride_y, ptr_r, VX_TYPE_COORDINATES2DF, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
 
-        uint32_t x, y;
-        for (y = 0; y < output->height; y++) {
-            for (x = 0; x < output->width; x++) {
-                uint8_t* dst_data = CT_IMAGE_DATA_PTR_8U(output, x, y); (void)dst_data;
-                {
-                    vx_coordinates2df_t *coord_ptr = &(ptr_r[y * stride + x]);
-                    ASSERT_NO_FAILURE(err_count += remap_check_pixel(input, output, x, y, coord_ptr->x, coord_ptr->y,
-                                                                     interp_type, border, map, vx_true_e));
-                }
-            }
-        }
+        remap_validate_coords(input, output, interp_type, border, ptr_r, stride_y);
+
         ct_free_mem(ptr_r);
     }
-
-    if (10 * err_count > output->width * output->height)
-        CT_FAIL_(return, "Check failed for %d pixels", err_count);
 }
 
 static vx_bool remap_is_equal(CT_Image input, CT_Image output, vx_enum interp_type, vx_border_t border, vx_remap map)
@@ -379,33 +314,28 @@ static vx_bool remap_is_equal(CT_Image input, CT_Image output, vx_enum interp_ty
     if( (output != NULL) &&
         (output->format == VX_DF_IMAGE_U8) &&
         (output->width > 0) &&
-        (output->height > 0))
+        (output->height > 0) &&
+        (interp_type == VX_INTERPOLATION_NEAREST_NEIGHBOR || interp_type == VX_INTERPOLATION_BILINEAR))
     {
         vx_rectangle_t rect = { 0, 0, output->width, output->height};
         vx_size stride = output->width;
         vx_size stride_y = sizeof(vx_coordinates2df_t) * (stride);
         vx_size size = stride * output->height;
         vx_coordinates2df_t *ptr_r = ct_calloc(size, sizeof(vx_coordinates2df_t));
+        CT_GeomMapping mapping = { CT_GEOM_MAPPING_TABLE, NULL, NULL, 0 };
+        CT_GeomResult result;
         ASSERT_(return vx_false_e, ptr_r);
         vxCopyRemapPatch(map, &rect, stride_y, ptr_r, VX_TYPE_COORDINATES2DF, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
 
-        uint32_t x, y;
-        for (y = 0; y < output->height; y++) {
-            for (x = 0; x < output->width; x++) {
-                uint8_t* dst_data = CT_IMAGE_DATA_PTR_8U(output, x, y); (void)dst_data;
-                {
-                    vx_coordinates2df_t *coord_ptr = &(ptr_r[y * stride + x]);
-                    if (0 != remap_check_pixel(input, output, x, y, coord_ptr->x, coord_ptr->y,
-                                               interp_type, border, map, vx_false_e))
-                    {
-                        ct_free_mem(ptr_r);
-                        return vx_false_e;
-                    }
-                }
-            }
-        }
+        mapping.table = ptr_r;
+        mapping.table_stride = stride_y;
+        ASSERT_NO_FAILURE_({ ct_free_mem(ptr_r); return vx_false_e; },
+                ct_geom_validate(input, output, &mapping, border,
+                        interp_type == VX_INTERPOLATION_NEAREST_NEIGHBOR ? ct_geom_check_nearest : ct_geom_check_bilinear,
+                        NULL, &result));
+
         ct_free_mem(ptr_r);
-        return vx_true_e;
+        return result.num_failed == 0 ? vx_true_e : vx_false_e;
     }
     else
     {
@@ -494,7 +424,10 @@ typedef struct {
 
 #define REMAP_PARAMETERS \
     CT_GENERATE_PARAMETERS("random", ADD_SIZE_SMALL_SET, ADD_VX_BORDERS_REMAP_FULL, ADD_VX_BORDERS_NO_POLICY, ADD_VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR, ADD_VX_MAP_PARAM_REMAP_FULL, ARG, remap_generate_random, NULL), \
-    CT_GENERATE_PARAMETERS("lena", ADD_SIZE_SMALL_SET, ADD_VX_BORDERS_REMAP_FULL, ADD_VX_BORDERS_NO_POLICY, ADD_VX_INTERP_TYPE_REMAP, ADD_VX_MAP_PARAM_REMAP_FULL, ARG, remap_read_image_8u, "lena.bmp")
+    CT_GENERATE_PARAMETERS("lena", ADD_SIZE_SMALL_SET, ADD_VX_BORDERS_REMAP_FULL, ADD_VX_BORDERS_NO_POLICY, ADD_VX_INTERP_TYPE_REMAP, ADD_VX_MAP_PARAM_REMAP_FULL, ARG, remap_read_image_8u, "lena.bmp"), \
+    ARG_PRODUCTION_BEGIN(), \
+    CT_GENERATE_PARAMETERS("random", ADD_SIZE_PRODUCTION_SET, ADD_VX_BORDERS_REMAP_FULL, ADD_VX_BORDERS_NO_POLICY, ADD_VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR, ADD_VX_MAP_PARAM_REMAP_FULL, ARG, remap_generate_random_keyed, NULL), \
+    ARG_PRODUCTION_END()
 
 #define POLICY_PARAMETERS \
     CT_GENERATE_PARAMETERS("random", ADD_SIZE_SMALL_SET, ADD_VX_BORDERS_REMAP_SMALL, ADD_VX_BORDERS_POLICY, ADD_VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR, ADD_VX_MAP_PARAM_REMAP_SMALL, ARG, remap_generate_random, NULL)
@@ -759,8 +692,6 @@ TESTCASE(vxMapRemapPatch, CT_VXContext, ct_setup_vx_context, 0)
 
 static void remap_validate_for_map(CT_Image input, CT_Image output, vx_enum interp_type, vx_border_t border, vx_remap map)
 {
-    vx_uint32 err_count = 0;
-
     ASSERT(output != NULL);
     ASSERT(output->format == VX_DF_IMAGE_U8);
     ASSERT(output->width > 0);
@@ -773,27 +704,10 @@ static void remap_validate_for_map(CT_Image input, CT_Image output, vx_enum inte
         vx_map_id map_id;
         vxMapRemapPatch(map, &rect, &map_id, &map_stride_y, (void **)&ptr_r, VX_TYPE_COORDINATES2DF, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
 
-        uint32_t x, y;
-        for (y = 0; y < output->height; y++) {
-            for (x = 0; x < output->width; x++) {
-                uint8_t* dst_data = CT_IMAGE_DATA_PTR_8U(output, x, y); (void)dst_data;
-                {
-                    vx_coordinates2df_t *coord_ptr = (vx_coordinates2df_t *)(
-                                ((vx_uint8 *)ptr_r) +
-                                x*sizeof(vx_coordinates2df_t) +
-                                y * map_stride_y /* map in bytes */
-                                );
-                    ASSERT_NO_FAILURE(err_count += remap_check_pixel(input, output, x, y, coord_ptr->x, coord_ptr->y,
-                                                                     interp_type, border, map, vx_true_e));
-                }
-            }
-        }
+        remap_validate_coords(input, output, interp_type, border, ptr_r, map_stride_y /* map in bytes */);
 
         vxUnmapRemapPatch(map, map_id);
     }
-
-    if (10 * err_count > output->width * output->height)
-        CT_FAIL_(return, "Check failed for %d pixels", err_count);
 }
 
 TEST(vxMapRemapPatch, testMapRandomRemap)
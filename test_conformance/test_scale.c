@@ -59,6 +59,17 @@ static CT_Image scale_generate_random(const char* fileName, int width, int heigh
     return image;
 }
 
+// the same as scale_generate_random(), filled with ct_allocate_ct_image_random_keyed() for the production-size inputs
+static CT_Image scale_generate_random_keyed(const char* fileName, int width, int height)
+{
+    CT_Image image;
+
+    ASSERT_NO_FAILURE_(return 0,
+            image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+
+    return image;
+}
+
 static CT_Image _scale_generate_simple_gradient(int width, int height, int step_x, int step_y, int offset)
 {
     CT_Image image = NULL;
@@ -136,21 +147,20 @@ static vx_int32 ct_image_get_pixel_8u(CT_Image img, int x, int y, vx_border_t bo
     {
         return CT_IMAGE_DATA_REPLICATE_8U(img, x, y);
     }
-    else if (border.mode == VX_BORDER_CONSTANT)
+    else // if (border.mode == VX_BORDER_CONSTANT), checked by scale_validate()
     {
         return CT_IMAGE_DATA_CONSTANT_8U(img, x, y, border.constant_value.U8);
     }
-    else
-    {
-        CT_FAIL_(return -1, "Invalid border type");
-    }
 }
 
-static int scale_check_pixel(CT_Image src, CT_Image dst, int x, int y, vx_enum interpolation, vx_border_t border)
+// pixel checks are called by ct_geom_validate() from worker threads, they must not generate failures
+static int scale_check_pixel(const CT_GeomCheckContext* ctx, vx_float64 src_x, vx_float64 src_y, vx_int32 res, vx_int32* expected)
 {
-    vx_uint8 res = *CT_IMAGE_DATA_PTR_8U(dst, x, y);
-    vx_float32 x_src = (((vx_float32)x + 0.5f) * (vx_float32)src->width / (vx_float32)dst->width) - 0.5f;
-    vx_float32 y_src = (((vx_float32)y + 0.5f) * (vx_float32)src->height / (vx_float32)dst->height) - 0.5f;
+    CT_Image src = ctx->src;
+    vx_border_t border = ctx->border;
+    vx_enum interpolation = *(const vx_enum*)ctx->user_data;
+    vx_float32 x_src = (vx_float32)src_x;
+    vx_float32 y_src = (vx_float32)src_y;
     int x_min = (int)floorf(x_src), y_min = (int)floorf(y_src);
     if (interpolation == VX_INTERPOLATION_NEAREST_NEIGHBOR)
     {
@@ -159,13 +169,12 @@ static int scale_check_pixel(CT_Image src, CT_Image dst, int x, int y, vx_enum i
         {
             for (sx = -1; sx <= 1; sx++)
             {
-                vx_int32 candidate = 0;
-                ASSERT_NO_FAILURE_(return 0, candidate = ct_image_get_pixel_8u(src, x_min + sx, y_min + sy, border));
+                vx_int32 candidate = ct_image_get_pixel_8u(src, x_min + sx, y_min + sy, border);
                 if (candidate == -1 || candidate == res)
                     return 1;
             }
         }
-        CT_FAIL_(return 0, "Check failed for pixel (%d, %d): %d", x, y, (int)res);
+        return 0;
     }
     if (interpolation == VX_INTERPOLATION_BILINEAR)
     {
@@ -216,7 +225,8 @@ static int scale_check_pixel(CT_Image src, CT_Image dst, int x, int y, vx_enum i
             return 1;
         }
 
-        return 0; // don't generate failure, we will check num failed pixels later
+        *expected = ref;
+        return 0; // we will check num failed pixels later
     }
     if (interpolation == VX_INTERPOLATION_AREA)
     {
@@ -227,8 +237,7 @@ static int scale_check_pixel(CT_Image src, CT_Image dst, int x, int y, vx_enum i
         {
             for (sx = -2; sx <= 2; sx++)
             {
-                vx_int32 candidate = 0;
-                ASSERT_NO_FAILURE_(return 0, candidate = ct_image_get_pixel_8u(src, x_min + sx, y_min + sy, border));
+                vx_int32 candidate = ct_image_get_pixel_8u(src, x_min + sx, y_min + sy, border);
                 if (candidate == -1)
                     return 1;
                 if (v_min > candidate)
@@ -239,16 +248,18 @@ static int scale_check_pixel(CT_Image src, CT_Image dst, int x, int y, vx_enum i
             if (v_min <= res && v_max >= res)
                 return 1;
         }
-        CT_FAIL_(return 0, "Check failed for pixel (%d, %d): %d", x, y, (int)res);
+        return 0;
     }
-    CT_FAIL_(return 0, "NOT IMPLEMENTED");
+    return 0;
 }
 
-static int scale_check_pixel_exact(CT_Image src, CT_Image dst, int x, int y, vx_enum interpolation, vx_border_t border)
+static int scale_check_pixel_exact(const CT_GeomCheckContext* ctx, vx_float64 src_x, vx_float64 src_y, vx_int32 res, vx_int32* expected)
 {
-    vx_uint8 res = *CT_IMAGE_DATA_PTR_8U(dst, x, y);
-    vx_float32 x_src = (((vx_float32)x + 0.5f) * (vx_float32)src->width / (vx_float32)dst->width) - 0.5f;
-    vx_float32 y_src = (((vx_float32)y + 0.5f) * (vx_float32)src->height / (vx_float32)dst->height) - 0.5f;
+    CT_Image src = ctx->src;
+    vx_border_t border = ctx->border;
+    vx_enum interpolation = *(const vx_enum*)ctx->user_data;
+    vx_float32 x_src = (vx_float32)src_x;
+    vx_float32 y_src = (vx_float32)src_y;
     vx_float32 x_minf = floorf(x_src);
     vx_float32 y_minf = floorf(y_src);
     int x_min = (vx_int32)x_minf;
@@ -264,7 +275,8 @@ static int scale_check_pixel_exact(CT_Image src, CT_Image dst, int x, int y, vx_
         vx_int32 ref = ct_image_get_pixel_8u(src, x_ref, y_ref, border);
         if (ref == -1 || ref == res)
             return 1;
-        CT_FAIL_(return 0, "Check failed for pixel (%d, %d): %d (expected %d)", x, y, (int)res, (int)ref);
+        *expected = ref;
+        return 0;
     }
     if (interpolation == VX_INTERPOLATION_BILINEAR)
     {
@@ -315,49 +327,60 @@ static int scale_check_pixel_exact(CT_Image src, CT_Image dst, int x, int y, vx_
             return 1;
         }
 
-        CT_FAIL_(return 0, "Check failed for pixel (%d, %d): %d (expected %d)", x, y, (int)res, (int)ref);
+        *expected = ref;
+        return 0;
     }
-    if (interpolation == VX_INTERPOLATION_AREA)
+    if (interpolation == VX_INTERPOLATION_AREA) // integer upscale only, checked by scale_validate()
     {
-        vx_int32 ref;
-        ASSERT_(return 0, dst->width % src->width == 0 && dst->height % src->height == 0);
-        ref = ct_image_get_pixel_8u(src, x_ref, y_ref, border);
+        vx_int32 ref = ct_image_get_pixel_8u(src, x_ref, y_ref, border);
         if (ref == -1)
             return 1;
         if (ref == res)
             return 1;
-        CT_FAIL_(return 0, "Check failed for pixel (%d, %d): %d (expected %d)", x, y, (int)res, (int)ref);
+        *expected = ref;
+        return 0;
     }
-    CT_FAIL_(return 0, "NOT IMPLEMENTED");
+    return 0;
 }
 
 static void scale_validate(CT_Image src, CT_Image dst, vx_enum interpolation, vx_border_t border, int exact)
 {
-    int num_failed = 0;
+    CT_GeomMapping mapping = { CT_GEOM_MAPPING_SCALE, NULL, NULL, 0 };
+    CT_GeomResult result;
     if (src->width == dst->width && src->height == dst->height) // special case for scale=1.0
     {
         ASSERT_EQ_CTIMAGE(src, dst);
         return;
     }
-    CT_FILL_IMAGE_8U(, dst,
-            {
-                int check;
-                if (exact == 0)
-                    ASSERT_NO_FAILURE(check = scale_check_pixel(src, dst, x, y, interpolation, border));
-                else
-                    ASSERT_NO_FAILURE(check = scale_check_pixel_exact(src, dst, x, y, interpolation, border));
-                if (check == 0) {
-                    num_failed++;
-                }
-            });
-    if (interpolation == VX_INTERPOLATION_BILINEAR)
+    if (interpolation != VX_INTERPOLATION_NEAREST_NEIGHBOR &&
+        interpolation != VX_INTERPOLATION_BILINEAR &&
+        interpolation != VX_INTERPOLATION_AREA)
+        CT_FAIL_(return, "NOT IMPLEMENTED");
+    if (border.mode != VX_BORDER_UNDEFINED &&
+        border.mode != VX_BORDER_REPLICATE &&
+        border.mode != VX_BORDER_CONSTANT)
+        CT_FAIL_(return, "Invalid border type");
+    if (exact && interpolation == VX_INTERPOLATION_AREA)
+        ASSERT(dst->width % src->width == 0 && dst->height % src->height == 0);
+
+    ASSERT_NO_FAILURE(ct_geom_validate(src, dst, &mapping, border,
+            exact ? scale_check_pixel_exact : scale_check_pixel, &interpolation, &result));
+
+    if (interpolation == VX_INTERPOLATION_BILINEAR && exact == 0)
     {
         int total = dst->width * dst->height;
-        if (num_failed * 100 > total * 2) // 98% should be valid
+        if ((int)result.num_failed * 100 > total * 2) // 98% should be valid
         {
-            CT_FAIL("Check failed: %g (%d) pixels are wrong", (float)num_failed / total, num_failed);
+            CT_FAIL("Check failed: %g (%d) pixels are wrong, first at (%d, %d): %d (expected %d)",
+                    (float)result.num_failed / total, (int)result.num_failed,
+                    result.first_x, result.first_y, (int)result.first_value, (int)result.first_expected);
         }
     }
+    else if (result.num_failed > 0)
+    {
+        CT_FAIL("Check failed for %d pixels, first at (%d, %d): %d (expected %d)",
+                (int)result.num_failed, result.first_x, result.first_y, (int)result.first_value, (int)result.first_expected);
+    }
 }
 
 static void scale_check(CT_Image src, CT_Image dst, vx_enum interpolation, vx_border_t border, int exact)
@@ -521,6 +544,13 @@ void dst_size_generator_SCALE_NEAR_DOWN(int width, int height, int* dst_width, i
     SCALE_TEST(VX_INTERPOLATION_NEAREST_NEIGHBOR, scale_generate_random, "random", SCALE_NEAR_DOWN, 0, ADD_SIZE_SMALL_SET, ADD_VX_BORDERS, ARG, 0), \
     SCALE_TEST(VX_INTERPOLATION_BILINEAR,         scale_generate_random, "random", SCALE_NEAR_DOWN, 0, ADD_SIZE_SMALL_SET, ADD_VX_BORDERS, ARG, 0), \
     SCALE_TEST(VX_INTERPOLATION_AREA,             scale_generate_random, "random", SCALE_NEAR_DOWN, 0, ADD_SIZE_SMALL_SET, ADD_VX_BORDERS, ARG, 0), \
+    /* production sizes */ \
+    ARG_PRODUCTION_BEGIN(), \
+    SCALE_TEST(VX_INTERPOLATION_NEAREST_NEIGHBOR, scale_generate_random_keyed, "random", 2_1, 0, ADD_SIZE_PRODUCTION_SET, ADD_VX_BORDERS, ARG, 0), \
+    SCALE_TEST(VX_INTERPOLATION_BILINEAR,         scale_generate_random_keyed, "random", 2_1, 0, ADD_SIZE_PRODUCTION_SET, ADD_VX_BORDERS, ARG, 0), \
+    SCALE_TEST(VX_INTERPOLATION_BILINEAR,         scale_generate_random_keyed, "random", SCALE_PYRAMID_ORB, 0, ADD_SIZE_PRODUCTION_SET, ADD_VX_BORDERS, ARG, 0), \
+    SCALE_TEST(VX_INTERPOLATION_AREA,             scale_generate_random_keyed, "random", SCALE_NEAR_DOWN, 0, ADD_SIZE_PRODUCTION_SET, ADD_VX_BORDERS, ARG, 0), \
+    ARG_PRODUCTION_END(), \
 
 TEST_WITH_ARG(Scale, testGraphProcessing, Arg,
     PARAMETERS
@@ -67,6 +67,17 @@ static CT_Image sobel3x3_generate_random(const char* fileName, int width, int he
     return image;
 }
 
+// the same as sobel3x3_generate_random(), filled with ct_allocate_ct_image_random_keyed() for the production-size inputs
+static CT_Image sobel3x3_generate_random_keyed(const char* fileName, int width, int height)
+{
+    CT_Image image;
+
+    ASSERT_NO_FAILURE_(return 0,
+            image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+
+    return image;
+}
+
 static CT_Image sobel3x3_read_image(const char* fileName, int width, int height)
 {
     CT_Image image = NULL;
@@ -93,101 +104,43 @@ static int16_t sobel_y_get(int32_t *values)
     return (int16_t)res;
 }
 
-static void sobel3x3_calculate(CT_Image src, uint32_t x, uint32_t y, int16_t *sobel_x, int16_t *sobel_y)
-{
-    int32_t values[9] = {
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y - 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y - 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y - 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y - 0),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x - 1, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 0, y + 1),
-        (int32_t)*CT_IMAGE_DATA_PTR_8U(src, x + 1, y + 1)
-    };
-    *sobel_x = sobel_x_get(values);
-    *sobel_y = sobel_y_get(values);
-}
+typedef int16_t (*sobel_get_fn)(int32_t *values);
 
-static void sobel3x3_calculate_replicate(CT_Image src, uint32_t x_, uint32_t y_, int16_t *sobel_x, int16_t *sobel_y)
+static void sobel3x3_calculate_row(const uint8_t* src, int32_t stride, void* dst_, uint32_t width, void* user_data)
 {
-    int32_t x = (int)x_;
-    int32_t y = (int)y_;
-    int32_t values[9] = {
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y - 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y - 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y - 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y - 0),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x - 1, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 0, y + 1),
-        (int32_t)CT_IMAGE_DATA_REPLICATE_8U(src, x + 1, y + 1)
-    };
-    *sobel_x = sobel_x_get(values);
-    *sobel_y = sobel_y_get(values);
-}
+    int16_t* dst = (int16_t*)dst_;
+    sobel_get_fn sobel_get = *(sobel_get_fn*)user_data;
+    uint32_t x;
 
-static void sobel3x3_calculate_constant(CT_Image src, uint32_t x_, uint32_t y_, vx_uint32 constant_value, int16_t *sobel_x, int16_t *sobel_y)
-{
-    int32_t x = (int)x_;
-    int32_t y = (int)y_;
-    int32_t values[9] = {
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y - 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y - 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y - 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y - 0, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x - 1, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 0, y + 1, constant_value),
-        (int32_t)CT_IMAGE_DATA_CONSTANT_8U(src, x + 1, y + 1, constant_value)
-    };
-    *sobel_x = sobel_x_get(values);
-    *sobel_y = sobel_y_get(values);
+    for (x = 0; x < width; x++)
+    {
+        const uint8_t* s = src + x;
+        int32_t values[9] = {
+            (int32_t)s[-stride - 1],
+            (int32_t)s[-stride],
+            (int32_t)s[-stride + 1],
+            (int32_t)s[-1],
+            (int32_t)s[0],
+            (int32_t)s[1],
+            (int32_t)s[stride - 1],
+            (int32_t)s[stride],
+            (int32_t)s[stride + 1]
+        };
+        dst[x] = sobel_get(values);
+    }
 }
 
 
 void sobel3x3_create_reference_image(CT_Image src, vx_border_t border, CT_Image *p_dst_x, CT_Image *p_dst_y)
 {
     CT_Image dst_x = NULL, dst_y = NULL;
+    sobel_get_fn get_x = sobel_x_get, get_y = sobel_y_get;
 
     CT_ASSERT(src->format == VX_DF_IMAGE_U8);
+    ASSERT(border.mode == VX_BORDER_UNDEFINED || border.mode == VX_BORDER_REPLICATE || border.mode == VX_BORDER_CONSTANT);
 
-    dst_x = ct_allocate_image(src->width, src->height, VX_DF_IMAGE_S16);
-    dst_y = ct_allocate_image(src->width, src->height, VX_DF_IMAGE_S16);
-
-    if (border.mode == VX_BORDER_UNDEFINED)
-    {
-        CT_FILL_IMAGE_16S(return, dst_x,
-                if (x >= 1 && y >= 1 && x < src->width - 1 && y < src->height - 1)
-                {
-                    int16_t* dst_y_data = CT_IMAGE_DATA_PTR_16S(dst_y, x, y);
-                    sobel3x3_calculate(src, x, y, dst_data, dst_y_data);
-                });
-    }
-    else if (border.mode == VX_BORDER_REPLICATE)
-    {
-        CT_FILL_IMAGE_16S(return, dst_x,
-                {
-                    int16_t* dst_y_data = CT_IMAGE_DATA_PTR_16S(dst_y, x, y);
-                    sobel3x3_calculate_replicate(src, x, y, dst_data, dst_y_data);
-                });
-    }
-    else if (border.mode == VX_BORDER_CONSTANT)
-    {
-        vx_uint32 constant_value = border.constant_value.U32;
-        CT_FILL_IMAGE_16S(return, dst_x,
-                {
-                    int16_t* dst_y_data = CT_IMAGE_DATA_PTR_16S(dst_y, x, y);
-                    sobel3x3_calculate_constant(src, x, y, constant_value, dst_data, dst_y_data);
-                });
-    }
-    else
-    {
-        ASSERT_(return, 0);
-    }
+    ASSERT_NO_FAILURE(dst_x = ct_filter_image_8u(src, border, 1, VX_DF_IMAGE_S16, sobel3x3_calculate_row, &get_x));
+    ASSERT_NO_FAILURE(dst_y = ct_filter_image_8u(src, border, 1, VX_DF_IMAGE_S16, sobel3x3_calculate_row, &get_y));
 
     *p_dst_x = dst_x;
     *p_dst_y = dst_y;
@@ -241,7 +194,10 @@ typedef struct {
 
 #define SOBEL_PARAMETERS \
     CT_GENERATE_PARAMETERS("randomInput", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_SMALL_SET, ARG, sobel3x3_generate_random, NULL), \
-    CT_GENERATE_PARAMETERS("lena", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_NONE, ARG, sobel3x3_read_image, "lena.bmp")
+    CT_GENERATE_PARAMETERS("lena", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_NONE, ARG, sobel3x3_read_image, "lena.bmp"), \
+    ARG_PRODUCTION_BEGIN(), \
+    CT_GENERATE_PARAMETERS("randomInput", ADD_VX_BORDERS_REQUIRE_UNDEFINED_ONLY, ADD_SIZE_PRODUCTION_SET, ARG, sobel3x3_generate_random_keyed, NULL), \
+    ARG_PRODUCTION_END()
 
 TEST_WITH_ARG(Sobel3x3, testGraphProcessing, Filter_Arg,
     SOBEL_PARAMETERS
@@ -28,6 +28,9 @@
 #define VX_KERNEL_CONFORMANCE_TEST_OWN_USER (VX_KERNEL_BASE(VX_ID_DEFAULT, 0) + 2)
 #define VX_KERNEL_CONFORMANCE_TEST_OWN_USER_NAME "org.khronos.openvx.test.own_user"
 
+#define VX_KERNEL_CONFORMANCE_TEST_OWN_DISPATCH (VX_KERNEL_BASE(VX_ID_DEFAULT, 0) + 3)
+#define VX_KERNEL_CONFORMANCE_TEST_OWN_DISPATCH_NAME "org.khronos.openvx.test.own_dispatch"
+
 TESTCASE(UserNode, CT_VXContext, ct_setup_vx_context, 0)
 
 typedef enum _own_params_e
@@ -1056,9 +1059,187 @@ TEST(UserNode, testOutDelay)
     VX_CALL(vxRemoveKernel(kernel));
 }
 
+/*
+    Dispatch overhead: a chain of trivial user nodes, each one reads a VX_TYPE_UINT32 scalar
+    and writes the value + 1 to the next scalar. The callbacks only count invocations, so the
+    measured times are the framework cost of validation, initialization and dispatch per node.
+*/
+
+static vx_uint32 dispatch_validator_count = 0;
+static vx_uint32 dispatch_initialize_count = 0;
+static vx_uint32 dispatch_deinitialize_count = 0;
+static vx_uint32 dispatch_kernel_count = 0;
+static vx_size dispatch_kernel_alloc_size = 0;
+
+static vx_status VX_CALLBACK own_DispatchValidator(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_meta_format metas[])
+{
+    vx_enum scalar_type = VX_TYPE_UINT32;
+    dispatch_validator_count++;
+    return vxSetMetaFormatAttribute(metas[OWN_PARAM_OUTPUT], VX_SCALAR_TYPE, &scalar_type, sizeof(scalar_type));
+}
+
+static vx_status VX_CALLBACK own_DispatchKernel(vx_node node, const vx_reference *parameters, vx_uint32 num)
+{
+    vx_uint32 value = 0;
+    vx_status status;
+    dispatch_kernel_count++;
+    status = vxCopyScalar((vx_scalar)parameters[OWN_PARAM_INPUT], &value, VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
+    value++;
+    if (status == VX_SUCCESS)
+        status = vxCopyScalar((vx_scalar)parameters[OWN_PARAM_OUTPUT], &value, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
+    return status;
+}
+
+static vx_status VX_CALLBACK own_DispatchInitialize(vx_node node, const vx_reference *parameters, vx_uint32 num)
+{
+    vx_status status = VX_SUCCESS;
+    dispatch_initialize_count++;
+    if (dispatch_kernel_alloc_size > 0)
+    {
+        vx_size size = dispatch_kernel_alloc_size;
+        void* ptr = ct_calloc(1, size);
+        if (ptr == NULL)
+            return VX_ERROR_NO_MEMORY;
+        status = vxSetNodeAttribute(node, VX_NODE_LOCAL_DATA_SIZE, &size, sizeof(size));
+        if (status == VX_SUCCESS)
+            status = vxSetNodeAttribute(node, VX_NODE_LOCAL_DATA_PTR, &ptr, sizeof(ptr));
+        if (status != VX_SUCCESS)
+            ct_free_mem(ptr);
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK own_DispatchDeinitialize(vx_node node, const vx_reference *parameters, vx_uint32 num)
+{
+    vx_status status = VX_SUCCESS;
+    dispatch_deinitialize_count++;
+    if (dispatch_kernel_alloc_size > 0)
+    {
+        vx_size size = 0;
+        void* ptr = NULL;
+        status = vxQueryNode(node, VX_NODE_LOCAL_DATA_PTR, &ptr, sizeof(ptr));
+        ct_free_mem(ptr);
+        ptr = NULL;
+        if (status == VX_SUCCESS)
+            status = vxSetNodeAttribute(node, VX_NODE_LOCAL_DATA_SIZE, &size, sizeof(size));
+        if (status == VX_SUCCESS)
+            status = vxSetNodeAttribute(node, VX_NODE_LOCAL_DATA_PTR, &ptr, sizeof(ptr));
+    }
+    return status;
+}
+
+typedef struct {
+    const char* name;
+    int num_nodes;
+    vx_size local_size;
+    vx_bool is_kernel_alloc;
+} dispatch_arg;
+
+// steady-state processing is repeated only with --benchmark
+#define DISPATCH_STEADY_ITERATIONS 10
+
+#define ADD_DISPATCH_NODES(testArgName, nextmacro, ...) \
+    CT_EXPAND(nextmacro(testArgName "NODES=1", __VA_ARGS__, 1)), \
+    CT_EXPAND(nextmacro(testArgName "NODES=10", __VA_ARGS__, 10)), \
+    CT_EXPAND(nextmacro(testArgName "NODES=100", __VA_ARGS__, 100)), \
+    CT_EXPAND(nextmacro(testArgName "NODES=1000", __VA_ARGS__, 1000))
+
+#define ADD_DISPATCH_LOCAL_SIZE_AND_ALLOC(testArgName, nextmacro, ...) \
+    CT_EXPAND(nextmacro(testArgName "/LOCAL_SIZE=0", __VA_ARGS__, 0, vx_false_e)), \
+    CT_EXPAND(nextmacro(testArgName "/LOCAL_SIZE=4096/ALLOC=AUTO", __VA_ARGS__, 4096, vx_false_e)), \
+    CT_EXPAND(nextmacro(testArgName "/LOCAL_SIZE=4096/ALLOC=KERNEL", __VA_ARGS__, 4096, vx_true_e))
+
+#define DISPATCH_PARAMETERS \
+    CT_GENERATE_PARAMETERS("", ADD_DISPATCH_NODES, ADD_DISPATCH_LOCAL_SIZE_AND_ALLOC, ARG)
+
+TEST_WITH_ARG(UserNode, testDispatchOverhead, dispatch_arg, DISPATCH_PARAMETERS)
+{
+    vx_context context = context_->vx_context_;
+    vx_kernel kernel = 0;
+    vx_graph graph = 0;
+    vx_scalar* scalars = NULL;
+    vx_size auto_size = arg_->is_kernel_alloc ? 0 : arg_->local_size;
+    vx_uint32 value = 0;
+    int num_nodes = arg_->num_nodes, i;
+    int iterations = ct_check_benchmark() ? DISPATCH_STEADY_ITERATIONS : 0;
+    int64_t time_start;
+    double verify_ms, first_ms, steady_ms, release_ms;
+
+    dispatch_validator_count = dispatch_initialize_count = dispatch_deinitialize_count = dispatch_kernel_count = 0;
+    dispatch_kernel_alloc_size = arg_->is_kernel_alloc ? arg_->local_size : 0;
+
+    ASSERT_VX_OBJECT(kernel = vxAddUserKernel(
+        context,
+        VX_KERNEL_CONFORMANCE_TEST_OWN_DISPATCH_NAME,
+        VX_KERNEL_CONFORMANCE_TEST_OWN_DISPATCH,
+        own_DispatchKernel,
+        2,
+        own_DispatchValidator,
+        own_DispatchInitialize,
+        own_DispatchDeinitialize), VX_TYPE_KERNEL);
+    VX_CALL(vxAddParameterToKernel(kernel, OWN_PARAM_INPUT, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
+    VX_CALL(vxAddParameterToKernel(kernel, OWN_PARAM_OUTPUT, VX_OUTPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
+    VX_CALL(vxSetKernelAttribute(kernel, VX_KERNEL_LOCAL_DATA_SIZE, &auto_size, sizeof(auto_size)));
+    VX_CALL(vxFinalizeKernel(kernel));
+
+    scalars = (vx_scalar*)ct_alloc_mem((num_nodes + 1) * sizeof(vx_scalar));
+    ASSERT(scalars);
+    for (i = 0; i <= num_nodes; i++)
+        ASSERT_VX_OBJECT(scalars[i] = vxCreateScalar(context, VX_TYPE_UINT32, &value), VX_TYPE_SCALAR);
+
+    ASSERT_VX_OBJECT(graph = vxCreateGraph(context), VX_TYPE_GRAPH);
+    for (i = 0; i < num_nodes; i++)
+    {
+        vx_node node = 0;
+        ASSERT_VX_OBJECT(node = vxCreateGenericNode(graph, kernel), VX_TYPE_NODE);
+        VX_CALL(vxSetParameterByIndex(node, OWN_PARAM_INPUT, (vx_reference)scalars[i]));
+        VX_CALL(vxSetParameterByIndex(node, OWN_PARAM_OUTPUT, (vx_reference)scalars[i + 1]));
+        VX_CALL(vxReleaseNode(&node));
+    }
+
+    time_start = CT_getTickCount();
+    VX_CALL(vxVerifyGraph(graph));
+    verify_ms = CT_getElapsedMs(time_start);
+    time_start = CT_getTickCount();
+    VX_CALL(vxProcessGraph(graph));
+    first_ms = CT_getElapsedMs(time_start);
+    time_start = CT_getTickCount();
+    for (i = 0; i < iterations; i++)
+        VX_CALL(vxProcessGraph(graph));
+    steady_ms = iterations > 0 ? CT_getElapsedMs(time_start) / iterations : first_ms;
+
+    ASSERT_EQ_INT(num_nodes, dispatch_validator_count);
+    ASSERT_EQ_INT(num_nodes, dispatch_initialize_count);
+    ASSERT_EQ_INT(num_nodes * (iterations + 1), dispatch_kernel_count);
+
+    VX_CALL(vxCopyScalar(scalars[num_nodes], &value, VX_READ_ONLY, VX_MEMORY_TYPE_HOST));
+    ASSERT_EQ_INT(num_nodes, value);
+
+    time_start = CT_getTickCount();
+    VX_CALL(vxReleaseGraph(&graph));
+    release_ms = CT_getElapsedMs(time_start);
+    if (ct_check_benchmark())
+        CT_TIME_PRINTF("    nodes=%d: verify %.3f ms (%.2f us/node), first process %.3f ms, "
+                       "steady process %.3f ms (%.2f us/node), release %.3f ms (%.2f us/node)\n",
+                       num_nodes, verify_ms, verify_ms * 1000. / num_nodes, first_ms,
+                       steady_ms, steady_ms * 1000. / num_nodes, release_ms, release_ms * 1000. / num_nodes);
+
+    ASSERT_EQ_INT(num_nodes, dispatch_deinitialize_count);
+
+    /* user kernel should be removed only after all references to it released */
+    VX_CALL(vxRemoveKernel(kernel));
+
+    for (i = 0; i <= num_nodes; i++)
+        VX_CALL(vxReleaseScalar(&scalars[i]));
+    ct_free_mem(scalars);
+
+    ASSERT(graph == 0);
+}
+
 TESTCASE_TESTS(UserNode,
         testUserKernel,
         testUserKernelObjectArray,
         testRemoveKernel,
-        testOutDelay
+        testOutDelay,
+        testDispatchOverhead
         )
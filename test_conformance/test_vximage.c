@@ -3904,6 +3904,256 @@ TEST_WITH_ARG(vxCreateImageFromChannel, testChannelFromHandle, CreateImageFromCh
 }
 
 
+/* ***************************************************************************
+//  Host <-> framework data movement bandwidth
+*/
+TESTCASE(ImageBandwidth, CT_VXContext, ct_setup_vx_context, 0)
+
+typedef struct
+{
+    const char* testName;
+    const char* fileName;
+    int width;
+    int height;
+    vx_df_image format;
+
+} Bandwidth_Arg;
+
+#undef PARAMETERS
+#define PARAMETERS \
+    CT_GENERATE_PARAMETERS("bandwidth", ADD_SIZE_SMALL_SET, ADD_IMAGE_FORMAT, ARG, NULL), \
+    ARG_PRODUCTION_BEGIN(), \
+    CT_GENERATE_PARAMETERS("bandwidth", ADD_SIZE_PRODUCTION_SET, ADD_IMAGE_FORMAT, ARG, NULL), \
+    ARG_PRODUCTION_END()
+
+/* with --benchmark every operation is repeated until about this amount of data is moved, otherwise it runs once */
+#define BANDWIDTH_TARGET_BYTES ((size_t)64 << 20)
+#define BANDWIDTH_MAX_ITERATIONS 1000
+
+typedef enum
+{
+    BANDWIDTH_MAP_READ = 0,
+    BANDWIDTH_MAP_READ_NOGAP_X,
+    BANDWIDTH_MAP_WRITE,
+    BANDWIDTH_MAP_WRITE_NOGAP_X,
+    BANDWIDTH_COPY_IN,
+    BANDWIDTH_COPY_OUT,
+    BANDWIDTH_SWAP_HANDLE,
+    BANDWIDTH_NUM_OPERATIONS
+
+} OWN_BANDWIDTH_OPERATION; /* executed in this order: reads are checked before the image is overwritten */
+
+static const char* own_bandwidth_operation_name[BANDWIDTH_NUM_OPERATIONS] =
+{
+    "map-read", "map-read/NOGAP_X", "map-write", "map-write/NOGAP_X", "copy-in", "copy-out", "swap-handle"
+};
+
+/*
+// Maps every plane of the whole image, reads (sums) or writes (fills) each row of the patch and unmaps it.
+// For read access the row contents are also compared with the host copy of the image in 'ptrs'/'addr' layout.
+*/
+static void own_bandwidth_map(vx_image image, vx_uint32 nplanes, vx_enum usage, vx_uint32 flags,
+    void* ptrs[], vx_imagepatch_addressing_t user_addr[], int check, vx_uint32* checksum)
+{
+    vx_uint32 p, y;
+    vx_uint32 width = 0, height = 0;
+    vx_rectangle_t rect;
+
+    VX_CALL(vxQueryImage(image, VX_IMAGE_WIDTH, &width, sizeof(width)));
+    VX_CALL(vxQueryImage(image, VX_IMAGE_HEIGHT, &height, sizeof(height)));
+    rect.start_x = 0;
+    rect.start_y = 0;
+    rect.end_x = width;
+    rect.end_y = height;
+
+    for (p = 0; p < nplanes; p++)
+    {
+        vx_map_id map_id;
+        vx_imagepatch_addressing_t addr = VX_IMAGEPATCH_ADDR_INIT;
+        vx_uint8* base = NULL;
+        vx_uint32 rows, row_bytes;
+
+        VX_CALL(vxMapImagePatch(image, &rect, p, &map_id, &addr, (void**)&base, usage, VX_MEMORY_TYPE_HOST, flags));
+
+        rows = addr.dim_y / addr.step_y;
+        row_bytes = addr.dim_x / addr.step_x * addr.stride_x;
+
+        /* without gaps the mapped pixels are as dense as in the user layout */
+        if (flags & VX_NOGAP_X)
+            EXPECT_EQ_INT(user_addr[p].stride_x, addr.stride_x);
+
+        for (y = 0; y < rows; y++)
+        {
+            vx_uint8* row = base + (size_t)y * addr.stride_y;
+
+            if (usage == VX_READ_ONLY)
+            {
+                vx_uint32 x, sum = 0;
+                for (x = 0; x < row_bytes; x++)
+                    sum += row[x];
+                *checksum += sum;
+
+                if (check)
+                {
+                    const vx_uint8* user_row = (const vx_uint8*)ptrs[p] + (size_t)y * user_addr[p].stride_y;
+                    vx_uint32 cols = addr.dim_x / addr.step_x;
+                    vx_int32 pixel_bytes = user_addr[p].stride_x;
+
+                    for (x = 0; x < cols; x++)
+                    {
+                        if (memcmp(row + (size_t)x * addr.stride_x, user_row + (size_t)x * pixel_bytes, pixel_bytes) != 0)
+                        {
+                            CT_ADD_FAILURE("Mapped plane %u differs from the written data at (%u, %u)\n", p, x, y);
+                            check = 0;
+                            break;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                memset(row, (int)(y & 0xff), row_bytes);
+            }
+        }
+
+        VX_CALL(vxUnmapImagePatch(image, map_id));
+    }
+}
+
+static void own_bandwidth_copy(vx_image image, vx_uint32 nplanes, vx_enum usage, void* ptrs[], vx_imagepatch_addressing_t addr[])
+{
+    vx_uint32 p;
+    vx_uint32 width = 0, height = 0;
+    vx_rectangle_t rect;
+
+    VX_CALL(vxQueryImage(image, VX_IMAGE_WIDTH, &width, sizeof(width)));
+    VX_CALL(vxQueryImage(image, VX_IMAGE_HEIGHT, &height, sizeof(height)));
+    rect.start_x = 0;
+    rect.start_y = 0;
+    rect.end_x = width;
+    rect.end_y = height;
+
+    for (p = 0; p < nplanes; p++)
+        VX_CALL(vxCopyImagePatch(image, &rect, p, &addr[p], ptrs[p], usage, VX_MEMORY_TYPE_HOST));
+}
+
+TEST_WITH_ARG(ImageBandwidth, testBandwidth, Bandwidth_Arg, PARAMETERS)
+{
+    vx_context context = context_->vx_context_;
+    vx_image image = 0, handle_image = 0;
+    vx_uint32 nplanes = 0, p;
+    vx_imagepatch_addressing_t addr[VX_PLANE_MAX] =
+    {
+        VX_IMAGEPATCH_ADDR_INIT,
+        VX_IMAGEPATCH_ADDR_INIT,
+        VX_IMAGEPATCH_ADDR_INIT,
+        VX_IMAGEPATCH_ADDR_INIT
+    };
+    void* data_ptrs[VX_PLANE_MAX] = { 0, 0, 0, 0 };
+    void* read_ptrs[VX_PLANE_MAX] = { 0, 0, 0, 0 };
+    void* swap_ptrs[2][VX_PLANE_MAX] = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+    void* prev_ptrs[VX_PLANE_MAX] = { 0, 0, 0, 0 };
+    vx_pixel_value_t val;
+    vx_uint32 checksum = 0;
+    size_t image_bytes = 0;
+    int iterations, op, i;
+    /* the odd production size is rounded down to the chroma subsampling of the format */
+    int width  = arg_->width  & ~(own_get_channel_subsampling_x(arg_->format, VX_CHANNEL_U) - 1);
+    int height = arg_->height & ~(own_get_channel_subsampling_y(arg_->format, VX_CHANNEL_U) - 1);
+
+    /* host copies of the image in the user layout used by vxCopyImagePatch and vxCreateImageFromHandle */
+    val.reserved[0] = 0x11; val.reserved[1] = 0x22; val.reserved[2] = 0x33; val.reserved[3] = 0x44;
+    ASSERT_NO_FAILURE(own_allocate_image_ptrs(arg_->format, width, height, &nplanes, data_ptrs, addr, &val));
+    ASSERT_NO_FAILURE(own_allocate_image_ptrs(arg_->format, width, height, &nplanes, read_ptrs, addr, &val));
+    ASSERT_NO_FAILURE(own_allocate_image_ptrs(arg_->format, width, height, &nplanes, swap_ptrs[0], addr, &val));
+    ASSERT_NO_FAILURE(own_allocate_image_ptrs(arg_->format, width, height, &nplanes, swap_ptrs[1], addr, &val));
+
+    for (p = 0; p < nplanes; p++)
+    {
+        size_t plane_bytes = (size_t)addr[p].stride_y * addr[p].dim_y;
+        uint64_t seed;
+        size_t k;
+        CT_RNG_INIT(seed, CT()->seed_ + p);
+        for (k = 0; k < plane_bytes; k++)
+            ((vx_uint8*)data_ptrs[p])[k] = (vx_uint8)CT_RNG_NEXT_INT(seed, 0, 256);
+        image_bytes += plane_bytes;
+    }
+
+    iterations = 1;
+    if (ct_check_benchmark())
+        iterations = (int)CT_MAX(1, CT_MIN((size_t)BANDWIDTH_MAX_ITERATIONS, BANDWIDTH_TARGET_BYTES / image_bytes));
+
+    ASSERT_VX_OBJECT(image = vxCreateImage(context, width, height, arg_->format), VX_TYPE_IMAGE);
+    ASSERT_VX_OBJECT(handle_image = vxCreateImageFromHandle(context, arg_->format, addr, swap_ptrs[0], VX_MEMORY_TYPE_HOST), VX_TYPE_IMAGE);
+
+    /* copy-in first, so that the read operations can be checked against data_ptrs */
+    ASSERT_NO_FAILURE(own_bandwidth_copy(image, nplanes, VX_WRITE_ONLY, data_ptrs, addr));
+
+    for (op = 0; op < BANDWIDTH_NUM_OPERATIONS; op++)
+    {
+        int64_t time_start = CT_getTickCount();
+        double time_ms;
+        for (i = 0; i < iterations; i++)
+        {
+            switch (op)
+            {
+            case BANDWIDTH_MAP_READ:
+                ASSERT_NO_FAILURE(own_bandwidth_map(image, nplanes, VX_READ_ONLY, 0, data_ptrs, addr, i == 0, &checksum));
+                break;
+            case BANDWIDTH_MAP_READ_NOGAP_X:
+                ASSERT_NO_FAILURE(own_bandwidth_map(image, nplanes, VX_READ_ONLY, VX_NOGAP_X, data_ptrs, addr, i == 0, &checksum));
+                break;
+            case BANDWIDTH_MAP_WRITE:
+                ASSERT_NO_FAILURE(own_bandwidth_map(image, nplanes, VX_WRITE_ONLY, 0, NULL, addr, 0, &checksum));
+                break;
+            case BANDWIDTH_MAP_WRITE_NOGAP_X:
+                ASSERT_NO_FAILURE(own_bandwidth_map(image, nplanes, VX_WRITE_ONLY, VX_NOGAP_X, NULL, addr, 0, &checksum));
+                break;
+            case BANDWIDTH_COPY_IN:
+                ASSERT_NO_FAILURE(own_bandwidth_copy(image, nplanes, VX_WRITE_ONLY, data_ptrs, addr));
+                break;
+            case BANDWIDTH_COPY_OUT:
+                ASSERT_NO_FAILURE(own_bandwidth_copy(image, nplanes, VX_READ_ONLY, read_ptrs, addr));
+                break;
+            case BANDWIDTH_SWAP_HANDLE:
+                VX_CALL(vxSwapImageHandle(handle_image, swap_ptrs[(i + 1) % 2], prev_ptrs, nplanes));
+                for (p = 0; p < nplanes; p++)
+                    ASSERT_EQ_PTR(swap_ptrs[i % 2][p], prev_ptrs[p]);
+                break;
+            }
+        }
+        time_ms = CT_getElapsedMs(time_start);
+        if (ct_check_benchmark())
+            CT_TIME_PRINTF("    %-18s %8.3f GB/s, %10.2f us/image\n", own_bandwidth_operation_name[op],
+                           time_ms > 0 ? (double)image_bytes * iterations / (time_ms * 1e6) : 0., time_ms * 1000. / iterations);
+    }
+
+    /* the last operation writing the image was copy-in of data_ptrs */
+    for (p = 0; p < nplanes; p++)
+    {
+        size_t plane_bytes = (size_t)addr[p].stride_y * addr[p].dim_y;
+        EXPECT_EQ_INT(0, memcmp(data_ptrs[p], read_ptrs[p], plane_bytes));
+    }
+
+    /* reclaim the handle that is in the image now */
+    VX_CALL(vxSwapImageHandle(handle_image, NULL, prev_ptrs, nplanes));
+
+    VX_CALL(vxReleaseImage(&handle_image));
+    VX_CALL(vxReleaseImage(&image));
+
+    for (p = 0; p < nplanes; p++)
+    {
+        ct_free_mem(data_ptrs[p]);
+        ct_free_mem(read_ptrs[p]);
+        ct_free_mem(swap_ptrs[0][p]);
+        ct_free_mem(swap_ptrs[1][p]);
+    }
+
+    ASSERT(image == 0);
+    ASSERT(handle_image == 0);
+} /* testBandwidth() */
+
+
 TESTCASE_TESTS(Image,
     testRngImageCreation,
     testVirtualImageCreation,
@@ -3937,3 +4187,5 @@ TESTCASE_TESTS(vxCreateImageFromChannel,
     testChannelFromRandomImage,
     testChannelFromHandle)
 
+TESTCASE_TESTS(ImageBandwidth,
+    testBandwidth)
@@ -44,6 +44,17 @@ static CT_Image own_generate_random(const char* fileName, int width, int height)
     return image;
 }
 
+// the same as own_generate_random(), filled with ct_allocate_ct_image_random_keyed() for the production-size inputs
+static CT_Image own_generate_random_keyed(const char* fileName, int width, int height)
+{
+    CT_Image image;
+
+    ASSERT_NO_FAILURE_(return 0,
+            image = ct_allocate_ct_image_random_keyed(width, height, VX_DF_IMAGE_U8, &CT()->seed_, 0, 256));
+
+    return image;
+}
+
 
 TESTCASE(WarpPerspective, CT_VXContext, ct_setup_vx_context, 0)
 
@@ -118,9 +129,6 @@ enum CT_PerspectiveMatrixType {
     VX_MATRIX_RANDOM
 };
 
-#define VX_NN_AREA_SIZE         1.5
-#define VX_BILINEAR_TOLERANCE   1
-
 static CT_Image warp_perspective_read_image_8u(const char* fileName, int width, int height)
 {
     CT_Image image = NULL;
@@ -235,91 +243,31 @@ static vx_matrix warp_perspective_create_matrix(vx_context context, vx_float32 *
     return matrix;
 }
 
-static int warp_perspective_check_pixel(CT_Image input, CT_Image output, int x, int y, vx_enum interp_type, vx_border_t border, vx_float32 *m)
+static void warp_perspective_validate(CT_Image input, CT_Image output, vx_enum interp_type, vx_border_t border, vx_float32* m)
 {
-    vx_float64 x0, y0, z0, xlower, ylower, s, t;
-    vx_int32 xi, yi;
-    int candidate;
-    vx_uint8 res = *CT_IMAGE_DATA_PTR_8U(output, x, y);
-
-    x0 = (vx_float64)m[3 * 0 + 0] * (vx_float64)x + (vx_float64)m[3 * 1 + 0] * (vx_float64)y + (vx_float64)m[3 * 2 + 0];
-    y0 = (vx_float64)m[3 * 0 + 1] * (vx_float64)x + (vx_float64)m[3 * 1 + 1] * (vx_float64)y + (vx_float64)m[3 * 2 + 1];
-    z0 = (vx_float64)m[3 * 0 + 2] * (vx_float64)x + (vx_float64)m[3 * 1 + 2] * (vx_float64)y + (vx_float64)m[3 * 2 + 2];
-    if (fabs(z0) < DBL_MIN)
-        return 0;
-
-    x0 = x0 / z0;
-    y0 = y0 / z0;
+    CT_GeomMapping mapping = { CT_GEOM_MAPPING_PERSPECTIVE, NULL, NULL, 0 };
+    CT_GeomResult result;
+
+    mapping.matrix = m;
+
     if (VX_INTERPOLATION_NEAREST_NEIGHBOR == interp_type)
     {
-        for (yi = (vx_int32)ceil(y0 - VX_NN_AREA_SIZE); (vx_float64)yi <= y0 + VX_NN_AREA_SIZE; yi++)
-        {
-            for (xi = (vx_int32)ceil(x0 - VX_NN_AREA_SIZE); (vx_float64)xi <= x0 + VX_NN_AREA_SIZE; xi++)
-            {
-                if (0 <= xi && 0 <= yi && xi < (vx_int32)input->width && yi < (vx_int32)input->height)
-                {
-                    candidate = *CT_IMAGE_DATA_PTR_8U(input, xi, yi);
-                }
-                else if (VX_BORDER_CONSTANT == border.mode)
-                {
-                    candidate = border.constant_value.U8;
-                }
-                else
-                {
-                    candidate = -1;
-                }
-                if (candidate == -1 || candidate == res)
-                    return 0;
-            }
-        }
-        CT_FAIL_(return 1, "Check failed for pixel (%d, %d): %d", x, y, (int)res);
+        ASSERT_NO_FAILURE(ct_geom_validate(input, output, &mapping, border, ct_geom_check_nearest, NULL, &result));
+        if (result.num_failed > 0)
+            CT_FAIL_(return, "Check failed for %d pixels, first at (%d, %d): %d",
+                    (int)result.num_failed, result.first_x, result.first_y, (int)result.first_value);
     }
     else if (VX_INTERPOLATION_BILINEAR == interp_type)
     {
-        xlower = floor(x0);
-        ylower = floor(y0);
-
-        s = x0 - xlower;
-        t = y0 - ylower;
-
-        xi = (vx_int32)xlower;
-        yi = (vx_int32)ylower;
-
-        candidate = -1;
-        if (VX_BORDER_UNDEFINED == border.mode)
-        {
-            if (xi >= 0 && yi >= 0 && xi < (vx_int32)input->width - 1 && yi < (vx_int32)input->height - 1)
-            {
-                candidate = (int)((1. - s) * (1. - t) * (vx_float64) *CT_IMAGE_DATA_PTR_8U(input, xi    , yi    ) +
-                                        s  * (1. - t) * (vx_float64) *CT_IMAGE_DATA_PTR_8U(input, xi + 1, yi    ) +
-                                  (1. - s) *       t  * (vx_float64) *CT_IMAGE_DATA_PTR_8U(input, xi    , yi + 1) +
-                                        s  *       t  * (vx_float64) *CT_IMAGE_DATA_PTR_8U(input, xi + 1, yi + 1));
-            }
-        }
-        else if (VX_BORDER_CONSTANT == border.mode)
-        {
-            candidate = (int)((1. - s) * (1. - t) * (vx_float32)CT_IMAGE_DATA_CONSTANT_8U(input, xi    , yi    , border.constant_value.U8) +
-                                    s  * (1. - t) * (vx_float32)CT_IMAGE_DATA_CONSTANT_8U(input, xi + 1, yi    , border.constant_value.U8) +
-                              (1. - s) *       t  * (vx_float32)CT_IMAGE_DATA_CONSTANT_8U(input, xi    , yi + 1, border.constant_value.U8) +
-                                    s  *       t  * (vx_float32)CT_IMAGE_DATA_CONSTANT_8U(input, xi + 1, yi + 1, border.constant_value.U8));
-        }
-        if (candidate == -1 || (abs(candidate - res) <= VX_BILINEAR_TOLERANCE))
-            return 0;
-        return 1;
+        ASSERT_NO_FAILURE(ct_geom_validate(input, output, &mapping, border, ct_geom_check_bilinear, NULL, &result));
+        if (10 * result.num_failed > output->width * output->height)
+            CT_FAIL_(return, "Check failed for %d pixels, first at (%d, %d): %d (expected %d)",
+                    (int)result.num_failed, result.first_x, result.first_y, (int)result.first_value, (int)result.first_expected);
+    }
+    else
+    {
+        CT_FAIL_(return, "Interpolation type undefined");
     }
-    CT_FAIL_(return 1, "Interpolation type undefined");
-}
-
-static void warp_perspective_validate(CT_Image input, CT_Image output, vx_enum interp_type, vx_border_t border, vx_float32 *m)
-{
-    vx_uint32 err_count = 0;
-
-    CT_FILL_IMAGE_8U(, output,
-            {
-                ASSERT_NO_FAILURE(err_count += warp_perspective_check_pixel(input, output, x, y, interp_type, border, m));
-            });
-    if (10 * err_count > output->width * output->height)
-        CT_FAIL_(return, "Check failed for %d pixels", err_count);
 }
 
 static void warp_perspective_check(CT_Image input, CT_Image output, vx_enum interp_type, vx_border_t border, vx_float32* m)
@@ -379,7 +327,10 @@ typedef struct {
 
 #define PARAMETERS \
     CT_GENERATE_PARAMETERS("random", ADD_SIZE_SMALL_SET, ADD_VX_BORDERS_WARP_PERSPECTIVE, ADD_VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR, ADD_VX_MATRIX_PARAM_WARP_PERSPECTIVE, ARG, own_generate_random, NULL, 128, 128), \
-    CT_GENERATE_PARAMETERS("lena", ADD_SIZE_SMALL_SET, ADD_VX_BORDERS_WARP_PERSPECTIVE, ADD_VX_INTERP_TYPE_WARP_PERSPECTIVE, ADD_VX_MATRIX_PARAM_WARP_PERSPECTIVE, ARG, own_read_image_8u, "lena.bmp", 0, 0)
+    CT_GENERATE_PARAMETERS("lena", ADD_SIZE_SMALL_SET, ADD_VX_BORDERS_WARP_PERSPECTIVE, ADD_VX_INTERP_TYPE_WARP_PERSPECTIVE, ADD_VX_MATRIX_PARAM_WARP_PERSPECTIVE, ARG, own_read_image_8u, "lena.bmp", 0, 0), \
+    ARG_PRODUCTION_BEGIN(), \
+    CT_GENERATE_PARAMETERS("random", ADD_SIZE_PRODUCTION_SET, ADD_VX_BORDERS_WARP_PERSPECTIVE, ADD_VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR, ADD_VX_MATRIX_PARAM_WARP_PERSPECTIVE, ARG, own_generate_random_keyed, NULL, 1920, 1080), \
+    ARG_PRODUCTION_END()
 
 
 TEST_WITH_ARG(WarpPerspective, testGraphProcessing, Arg,
@@ -90,6 +90,9 @@ int squares[] = {CT_FOREACHN(MULBYN, (10,), 0, 1, 2, 3, 4, 5)};
 
 #include "test_utils.h"
 #include "test_image.h"
+#include "test_parallel.h"
+#include "test_geometry.h"
+#include "test_ref_cache.h"
 
 typedef struct CT_TestCaseEntry* (*CT_RegisterTestCaseFN)();
 
@@ -173,6 +176,13 @@ extern char CT_EXTENDED_ARG_END[];
 #define ARG_EXTENDED_BEGIN() CT_ARG(CT_EXTENDED_ARG_BEGIN,)
 #define ARG_EXTENDED_END() CT_ARG(CT_EXTENDED_ARG_END,)
 
+extern char CT_PRODUCTION_ARG_BEGIN[];
+extern char CT_PRODUCTION_ARG_END[];
+
+// production-size parameters, enabled by --size_tier=production|all
+#define ARG_PRODUCTION_BEGIN() CT_ARG(CT_PRODUCTION_ARG_BEGIN,)
+#define ARG_PRODUCTION_END() CT_ARG(CT_PRODUCTION_ARG_END,)
+
 typedef struct CT_VoidContext_ {
     int dummy; // nothing, just make MSVC happy
 } CT_VoidContext;
@@ -196,6 +206,21 @@ int  CT_HasFailure();
 
 void CT_DumpMessage(const char* message, ...);
 
+// monotonic time source of the test engine, available for performance measurements in tests
+// (always zero without CT_TEST_TIME)
+int64_t CT_getTickCount(void);
+double CT_getTickFrequency(void);
+// milliseconds elapsed since the CT_getTickCount() value 'time_start'
+double CT_getElapsedMs(int64_t time_start);
+
+#ifdef CT_TEST_TIME
+#define CT_TEST_TIME_ENABLED 1
+#else
+#define CT_TEST_TIME_ENABLED 0
+#endif
+// printf() for benchmark results (measured times, memory footprint), does nothing without CT_TEST_TIME
+#define CT_TIME_PRINTF(...) do { if (CT_TEST_TIME_ENABLED) printf(__VA_ARGS__); } while (0)
+
 typedef void (*CT_ObjectDestructor)(void **);
 typedef enum CT_GCType { CT_GC_ALL=0, CT_GC_OBJECT=1, CT_GC_IMAGE=2 } CT_GCType;
 void CT_RegisterForGarbageCollection(void *object, CT_ObjectDestructor collector, CT_GCType type);
@@ -317,6 +342,13 @@ void CT_CollectGarbage(int type);
     CT_EXPAND(nextmacro(testArgName "/sz=256x256", __VA_ARGS__, 256, 256)), \
     CT_EXPAND(nextmacro(testArgName "/sz=640x480", __VA_ARGS__, 640, 480))
 
+// should be placed between ARG_PRODUCTION_BEGIN() and ARG_PRODUCTION_END()
+#define ADD_SIZE_PRODUCTION_SET(testArgName, nextmacro, ...) \
+    CT_EXPAND(nextmacro(testArgName "/sz=1920x1080", __VA_ARGS__, 1920, 1080)), \
+    CT_EXPAND(nextmacro(testArgName "/sz=3840x2160", __VA_ARGS__, 3840, 2160)), \
+    CT_EXPAND(nextmacro(testArgName "/sz=4096x4096", __VA_ARGS__, 4096, 4096)), \
+    CT_EXPAND(nextmacro(testArgName "/sz=1917x1079", __VA_ARGS__, 1917, 1079))
+
 #define ADD_SIZE_16x16(testArgName, nextmacro, ...) \
     CT_EXPAND(nextmacro(testArgName "/sz=16x16", __VA_ARGS__, 16, 16))
 
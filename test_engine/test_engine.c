@@ -35,9 +35,16 @@
 #endif
 
 #include "test.h"
+#include "test_kernel_trace.h"
+#include "test_filter.h"
 
 char CT_EXTENDED_ARG_BEGIN[] = {'\0'};
 char CT_EXTENDED_ARG_END[] = {'\0'};
+char CT_PRODUCTION_ARG_BEGIN[] = {'\0'};
+char CT_PRODUCTION_ARG_END[] = {'\0'};
+
+#define CT_ARG_FLAG_EXTENDED   1
+#define CT_ARG_FLAG_PRODUCTION 2
 
 #ifdef _MSC_VER
 #  undef setenv
@@ -62,7 +69,7 @@ int setenv(const char* name, const char* value, int overwite);
 #include <windows.h> // QueryPerformanceFrequency / QueryPerformanceCounter
 #endif
 
-static int64_t CT_getTickCount(void)
+int64_t CT_getTickCount(void)
 {
 #if defined WIN32 || defined _WIN32 || defined WINCE
     LARGE_INTEGER counter;
@@ -82,7 +89,7 @@ static int64_t CT_getTickCount(void)
 #endif
 }
 
-static double CT_getTickFrequency(void)
+double CT_getTickFrequency(void)
 {
 #if defined WIN32 || defined _WIN32 || defined WINCE
     LARGE_INTEGER freq;
@@ -113,8 +120,28 @@ static int g_timeShow =
         0
 #endif
         ;
+#else
+// no monotonic time source, measurements in tests are zero
+int64_t CT_getTickCount(void)
+{
+    return 0;
+}
+
+double CT_getTickFrequency(void)
+{
+    return 1.;
+}
 #endif
 
+double CT_getElapsedMs(int64_t time_start)
+{
+    return (CT_getTickCount() - time_start) * 1000. / CT_getTickFrequency();
+}
+
+static int g_memShow = 0;
+
+#define CT_MB(bytes) ((double)(bytes) / (1024. * 1024.))
+
 #define CT_LOGF(...)            \
     do {                        \
         printf(__VA_ARGS__);    \
@@ -276,60 +303,16 @@ static void print_version(const char* version_str)
 }
 
 
-static int isNameMatches(const char* str, const char *pattern)
-{
-    switch (*pattern)
-    {
-    case '?':
-        return (*str != '\0' && isNameMatches(str + 1, pattern + 1) != 0) ? 1 : 0;
-    case '*':
-        return ((*str != '\0' && isNameMatches(str + 1, pattern) != 0) ||
-                isNameMatches(str, pattern + 1) != 0) ? 1 : 0;
-    case '\0': case ':': case '\n':
-        return (*str == '\0' || *str == '/') ? 1 : 0;
-    default:
-        return (*pattern == *str &&
-                isNameMatches(str + 1, pattern + 1) != 0) ? 1 : 0;
-    }
-}
-
+static CT_Filter*  g_compiled_filter = NULL;
+static CT_NameSet* g_filter_names = NULL; // --filter_file
 
-// accepts filters like gtest with some changes for "negative" tests
-static int filterTestName(const char* test_name, const char* fullFilter)
+// accepts filters like gtest with some changes for "negative" tests (see test_filter.h)
+static int filterTestName(const char* test_name)
 {
-    const char *cur_pattern = fullFilter;
-    int result = 0;
-    if (fullFilter == NULL)
-    {
-        result = 1; // no filter
-    }
-    else
-    {
-        for (;;)
-        {
-            int negative = 0;
-            if (*cur_pattern == '-')
-            {
-                negative = 1;
-                cur_pattern++;
-            }
-            if (result == 0 || negative == 1)
-            {
-                if (isNameMatches(test_name, cur_pattern) != 0)
-                {
-                    if (negative)
-                        return 0;
-                    result = 1;
-                }
-            }
-
-            cur_pattern = strchr(cur_pattern, ':');
+    int result = ct_filter_match(g_compiled_filter, test_name);
 
-            if (cur_pattern == NULL)
-                break;
-            cur_pattern++;
-        }
-    }
+    if (result && g_filter_names)
+        result = ct_name_set_contains(g_filter_names, test_name);
 
     if (result && !g_option_run_disabled_tests && strstr(test_name, "DISABLED") != NULL)
     {
@@ -376,37 +359,185 @@ static void get_test_name(char* buf, int bufsz, struct CT_TestCaseEntry* testcas
         snprintf(buf, bufsz, "%s.%s", testcase->name_, test_name);
 }
 
-static int update_extended_flag(void* parg, int* extended_flag)
+static int update_arg_flags(void* parg, int* arg_flags)
 {
     if (parg)
     {
-        if (*(const char**)parg == CT_EXTENDED_ARG_BEGIN)
+        const char* name = *(const char**)parg;
+        if (name == CT_EXTENDED_ARG_BEGIN)
         {
-            *extended_flag = 1;
+            *arg_flags |= CT_ARG_FLAG_EXTENDED;
             return 1;
         }
-        else if (*(const char**)parg == CT_EXTENDED_ARG_END)
+        else if (name == CT_EXTENDED_ARG_END)
         {
-            *extended_flag = 0;
+            *arg_flags &= ~CT_ARG_FLAG_EXTENDED;
+            return 1;
+        }
+        else if (name == CT_PRODUCTION_ARG_BEGIN)
+        {
+            *arg_flags |= CT_ARG_FLAG_PRODUCTION;
+            return 1;
+        }
+        else if (name == CT_PRODUCTION_ARG_END)
+        {
+            *arg_flags &= ~CT_ARG_FLAG_PRODUCTION;
             return 1;
         }
     }
     return 0;
 }
 
-static int run_test(struct CT_TestCaseEntry* testcase, struct CT_TestEntry* test, int param_idx, int run_tests, int* extended_flag)
+static int is_arg_enabled(void* parg, int arg_flags)
+{
+    int size_tier = ct_get_size_tier();
+
+    if ((arg_flags & CT_ARG_FLAG_EXTENDED) && !ct_check_any_size())
+        return 0;
+
+    if (arg_flags & CT_ARG_FLAG_PRODUCTION)
+        return size_tier != CT_SIZE_TIER_DEFAULT;
+
+    // the production tier runs production sizes only, tests without parameters are not affected
+    return !(parg && size_tier == CT_SIZE_TIER_PRODUCTION);
+}
+
+/*
+    Flat index of the enabled tests (parameter markers and parameters of other size tiers are not
+    there), built once at startup. The names are formatted only here, the run loop and --list_tests
+    walk the array in registration order, the sorted copy gives O(log n) lookup by name.
+*/
+typedef struct CT_TestIndexEntry
+{
+    struct CT_TestCaseEntry* testcase;
+    struct CT_TestEntry*     test;
+    int                      param_idx;
+    char*                    name;
+    int                      candidate; // may pass the filter, see select_filter_candidates()
+} CT_TestIndexEntry;
+
+static CT_TestIndexEntry*  g_test_index = NULL;
+static CT_TestIndexEntry** g_test_index_sorted = NULL;
+static int                 g_test_index_size = 0;
+static int                 g_test_index_capacity = 0;
+
+static int add_test_to_index(struct CT_TestCaseEntry* testcase, struct CT_TestEntry* test, int param_idx)
 {
     char test_name[1024];
-    void *parg = get_test_params(test, param_idx);
-    get_test_name(test_name, sizeof(test_name), testcase, test, parg, param_idx);
+    CT_TestIndexEntry* entry;
+
+    if (g_test_index_size == g_test_index_capacity)
+    {
+        int capacity = g_test_index_capacity ? g_test_index_capacity * 2 : 4096;
+        CT_TestIndexEntry* index = (CT_TestIndexEntry*)realloc(g_test_index, capacity * sizeof(CT_TestIndexEntry));
+        if (index == NULL)
+            return 0;
+        g_test_index = index;
+        g_test_index_capacity = capacity;
+    }
 
-    if (update_extended_flag(parg, extended_flag))
+    get_test_name(test_name, sizeof(test_name), testcase, test, get_test_params(test, param_idx), param_idx);
+
+    entry = &g_test_index[g_test_index_size];
+    entry->testcase = testcase;
+    entry->test = test;
+    entry->param_idx = param_idx;
+    entry->candidate = 1;
+    entry->name = (char*)malloc(strlen(test_name) + 1);
+    if (entry->name == NULL)
         return 0;
+    strcpy(entry->name, test_name);
+    g_test_index_size++;
+    return 1;
+}
 
-    if (*extended_flag && !ct_check_any_size())
+static int compare_test_names(const void* a, const void* b)
+{
+    return strcmp((*(CT_TestIndexEntry* const*)a)->name, (*(CT_TestIndexEntry* const*)b)->name);
+}
+
+static int sort_test_index()
+{
+    int i;
+
+    g_test_index_sorted = (CT_TestIndexEntry**)malloc((g_test_index_size + 1) * sizeof(CT_TestIndexEntry*));
+    if (g_test_index_sorted == NULL)
         return 0;
+    for (i = 0; i < g_test_index_size; i++)
+        g_test_index_sorted[i] = &g_test_index[i];
+    qsort(g_test_index_sorted, g_test_index_size, sizeof(CT_TestIndexEntry*), compare_test_names);
+    return 1;
+}
+
+// position of the first test in the sorted index whose name is not less than the 'len' characters of 'prefix'
+static int find_test_in_index(const char* prefix, size_t len)
+{
+    int lo = 0, hi = g_test_index_size;
+
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (strncmp(g_test_index_sorted[mid]->name, prefix, len) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/*
+    A filter of plain test names (a single test run by run_tests.py, a list of failed tests) is
+    looked up in the sorted index instead of matching every name: a name matches such a pattern as
+    is or followed by the parameters ("Box3x3.Graph/0/..."), all of them start with the pattern.
+    filterTestName() is still called for the candidates, so the selection is the same.
+*/
+static void select_filter_candidates()
+{
+    const char* text;
+    size_t len;
+    int i, pos;
+
+    if (!ct_filter_is_literal(g_compiled_filter))
+        return;
+
+    for (i = 0; i < g_test_index_size; i++)
+        g_test_index[i].candidate = 0;
+
+    for (i = 0; ct_filter_get_pattern(g_compiled_filter, i, &text, &len); i++)
+    {
+        if (len == 0)
+            continue;
+        for (pos = find_test_in_index(text, len);
+             pos < g_test_index_size && strncmp(g_test_index_sorted[pos]->name, text, len) == 0; pos++)
+        {
+            const char* name = g_test_index_sorted[pos]->name;
+            if (name[len] == '\0' || name[len] == '/')
+                g_test_index_sorted[pos]->candidate = 1;
+        }
+    }
+}
+
+static void release_test_index()
+{
+    int i;
+
+    for (i = 0; i < g_test_index_size; i++)
+        free(g_test_index[i].name);
+    free(g_test_index);
+    free(g_test_index_sorted);
+    g_test_index = NULL;
+    g_test_index_sorted = NULL;
+    g_test_index_size = g_test_index_capacity = 0;
+}
+
+static int run_test(const CT_TestIndexEntry* entry, int run_tests)
+{
+    struct CT_TestCaseEntry* testcase = entry->testcase;
+    struct CT_TestEntry* test = entry->test;
+    const char* test_name = entry->name;
+    void *parg = get_test_params(test, entry->param_idx);
 
-    if (filterTestName(test_name, g_test_filter))
+    if (entry->candidate && filterTestName(test_name) && ct_kernel_trace_is_selected(test_name))
     {
         if (g_context.internal_->g_list_tests)
         {
@@ -416,6 +547,8 @@ static int run_test(struct CT_TestCaseEntry* testcase, struct CT_TestEntry* test
         else
         {
             char timestr[256] = {0};
+            char memstr[256] = {0};
+            size_t rss_start = 0;
 #ifdef CT_TEST_TIME
             int64_t timestart;
 #endif
@@ -439,7 +572,14 @@ static int run_test(struct CT_TestCaseEntry* testcase, struct CT_TestEntry* test
                 CT_LOGF("[ RUN %04d ] %s ...\n", run_tests+1, test_name);
             }
 
+            if (g_memShow)
+            {
+                rss_start = ct_get_rss_bytes(NULL);
+                ct_mem_stats_reset();
+            }
+
             g_has_running_test = 1; /* GO! */
+            ct_kernel_trace_begin_test();
 
 #ifdef CT_TEST_TIME
             timestart = CT_getTickCount();
@@ -464,23 +604,44 @@ static int run_test(struct CT_TestCaseEntry* testcase, struct CT_TestEntry* test
 
             // release automatic resources
             CT_CollectGarbage(CT_GC_ALL);
+            ct_mem_pool_reset();
 
             g_has_running_test = 0; /* FIN! */
+            ct_kernel_trace_end_test(test_name);
 
 #ifdef CT_TEST_TIME
             if (g_timeShow)
                 snprintf(timestr, sizeof(timestr), " (%.1f ms)", (CT_getTickCount() - timestart) * 1000. / g_tickFreq);
 #endif
 
-            CT_LOGF("[ %s ] %s%s\n",
-                (g_context.internal_->num_test_errors_) ? "!FAILED!" : "    DONE", test_name, timestr);
+            if (g_memShow)
+            {
+                CT_MemStats stats;
+                size_t rss_peak = 0, rss_end = ct_get_rss_bytes(&rss_peak);
+
+                ct_mem_get_stats(&stats);
+                snprintf(memstr, sizeof(memstr), " (mem: peak %.1f Mb, rss %.1f Mb)", CT_MB(stats.peak_bytes), CT_MB(rss_end));
+
+                if (stats.leaked_blocks > 0)
+                    CT_LOGF("[ WARNING  ] %s: %lld bytes in %lld block(s) allocated by the test are not released\n",
+                        test_name, (long long)stats.leaked_bytes, (long long)stats.leaked_blocks);
+
+                // <identifier> <test name> <bytes allocated> <blocks allocated> <peak bytes> <leaked bytes> <leaked blocks> <RSS at start> <RSS at end> <peak RSS of process>
+                CT_LOGF("#MEMORY: %s %llu %llu %llu %lld %lld %llu %llu %llu\n", test_name,
+                    (unsigned long long)stats.allocated_bytes, (unsigned long long)stats.allocated_blocks,
+                    (unsigned long long)stats.peak_bytes, (long long)stats.leaked_bytes, (long long)stats.leaked_blocks,
+                    (unsigned long long)rss_start, (unsigned long long)rss_end, (unsigned long long)rss_peak);
+            }
+
+            CT_LOGF("[ %s ] %s%s%s\n",
+                (g_context.internal_->num_test_errors_) ? "!FAILED!" : "    DONE", test_name, timestr, memstr);
 
             if (g_context.internal_->num_test_errors_)
             {
                 struct CT_FailedTestEntry* f = (struct CT_FailedTestEntry*)(ct_alloc_mem(sizeof(*f)));
                 f->testcase_ = testcase;
                 f->test_ = test;
-                f->param_idx_ = param_idx;
+                f->param_idx_ = entry->param_idx;
                 f->next_ = NULL;
 
                 if (g_context.internal_->g_failed_tests_end_)
@@ -498,6 +659,9 @@ static int run_test(struct CT_TestCaseEntry* testcase, struct CT_TestEntry* test
 int CT_main(int argc, char* argv[], const char* version_str)
 {
     const char* testid_str = 0;
+    const char* kernel_map = NULL;
+    const char* filter_file = NULL;
+    const char* changed_kernels = NULL;
     int arg;
     int total_tests = 0;
     int total_testcases = 0;
@@ -527,6 +691,7 @@ int CT_main(int argc, char* argv[], const char* version_str)
 #endif
 
     struct CT_TestCaseEntry* testcase = 0;
+    int test_pos = 0;
 
     for (arg = 1; arg < argc; arg++)
     {
@@ -540,6 +705,10 @@ int CT_main(int argc, char* argv[], const char* version_str)
             }
             g_test_filter = argStr + 9;
         }
+        else if (memcmp(argStr, "--filter_file=", 14) == 0)
+        {
+            filter_file = argStr + 14;
+        }
         else if (strcmp(argStr, "--verbose") == 0)
         {
             setenv("VX_ZONE_LIST", "0,1", 1);
@@ -552,10 +721,29 @@ int CT_main(int argc, char* argv[], const char* version_str)
         {
             g_option_run_disabled_tests = 1;
         }
+        else if (strcmp(argStr, "--benchmark") == 0)
+        {
+            ct_set_check_benchmark(1);
+        }
         else if (memcmp(argStr, "--check_any_size=", 17) == 0)
         {
             ct_set_check_any_size(atoi(argStr + 17) != 0);
         }
+        else if (memcmp(argStr, "--size_tier=", 12) == 0)
+        {
+            const char* tier = argStr + 12;
+            if (strcmp(tier, "default") == 0)
+                ct_set_size_tier(CT_SIZE_TIER_DEFAULT);
+            else if (strcmp(tier, "production") == 0)
+                ct_set_size_tier(CT_SIZE_TIER_PRODUCTION);
+            else if (strcmp(tier, "all") == 0)
+                ct_set_size_tier(CT_SIZE_TIER_ALL);
+            else
+            {
+                printf("ERROR: Unknown size tier %s\n", tier);
+                return 1;
+            }
+        }
         else if (memcmp(argStr, "--testid=", 9) == 0)
         {
             testid_str = argStr + 9;
@@ -576,16 +764,44 @@ int CT_main(int argc, char* argv[], const char* version_str)
             // nothing, ignore option
 #endif
         }
+        else if (memcmp(argStr, "--show_test_memory=", 19) == 0)
+        {
+            g_memShow = (atoi(argStr + 19) != 0);
+        }
+        else if (memcmp(argStr, "--ref_threads=", 14) == 0)
+        {
+            ct_set_num_threads(atoi(argStr + 14));
+        }
+        else if (memcmp(argStr, "--ref_cache=", 12) == 0)
+        {
+            ct_set_ref_cache_dir(argStr + 12);
+        }
+        else if (memcmp(argStr, "--kernel_map=", 13) == 0)
+        {
+            kernel_map = argStr + 13;
+        }
+        else if (memcmp(argStr, "--changed_kernels=", 18) == 0)
+        {
+            changed_kernels = argStr + 18;
+        }
         else if (memcmp(argStr, "--help", 7) == 0)
         {
             print_version(version_str);
             printf("Usage:\n");
-            printf("    %s [--filter=<filter>] [--run_disabled] [--global_context=0|1] [--check_any_size=0|1] [--show_test_duration=0|1] [--verbose] [--testid=<testid>] [--list_tests] [--quiet]\n", argv[0]);
+            printf("    %s [--filter=<filter>] [--filter_file=<file>] [--run_disabled] [--global_context=0|1] [--check_any_size=0|1] [--size_tier=default|production|all] [--benchmark] [--show_test_duration=0|1] [--show_test_memory=0|1] [--ref_threads=<n>] [--ref_cache=<dir>] [--kernel_map=<file> [--changed_kernels=<kernels>]] [--verbose] [--testid=<testid>] [--list_tests] [--quiet]\n", argv[0]);
             printf("\n");
             printf("   <filter> - is GTest like filter, list of patterns separated by colon ':'.\n");
             printf("              Filter-out tests with '-' pattern's prefix.\n");
             printf("              Negative patterns have higher priority than positive patterns.\n\n");
+            printf("   <file>   - with --filter_file: exact test names (as printed by --list_tests), one per line\n\n");
             printf("   <testid> - report custom identifier for tests run\n\n");
+            printf("   <n>      - number of threads for reference implementations (0 - number of CPUs, 1 - no threads)\n\n");
+            printf("   <dir>    - existing directory to keep reference results between runs (disabled by default)\n\n");
+            printf("   <file>   - kernels used by every test: recorded by the run without --changed_kernels,\n");
+            printf("              with --changed_kernels only the tests using any of <kernels> and new tests are run\n\n");
+            printf("   <kernels> - kernel names separated by ',', full (org.khronos.openvx.box_3x3) or short (box_3x3)\n\n");
+            printf("   --size_tier - image sizes to test: default (up to VGA), production (1080p, 4K and odd sizes only) or all\n\n");
+            printf("   --benchmark - repeat the measured operations of performance tests, otherwise they are executed once\n\n");
             return 0;
         }
         else
@@ -595,9 +811,41 @@ int CT_main(int argc, char* argv[], const char* version_str)
         }
     }
 
+    if (changed_kernels && !kernel_map)
+    {
+        printf("ERROR: --changed_kernels requires --kernel_map\n");
+        return 1;
+    }
+
     if (!g_context.internal_->g_quiet)
         print_version(version_str);
 
+    if (g_test_filter && (g_compiled_filter = ct_filter_compile(g_test_filter)) == NULL)
+    {
+        printf("ERROR: Not enough memory to compile filter\n");
+        return 1;
+    }
+    if (filter_file && (g_filter_names = ct_name_set_load(filter_file)) == NULL)
+    {
+        printf("ERROR: Can't read filter file %s\n", filter_file);
+        return 1;
+    }
+
+    if (kernel_map && changed_kernels)
+    {
+        int num_selected = 0, num_mapped = 0;
+        if (!ct_kernel_trace_load_selection(kernel_map, changed_kernels, &num_selected, &num_mapped))
+            return 1;
+        if (!g_context.internal_->g_quiet)
+            printf("Kernel map %s: %d of %d recorded test(s) use changed kernels %s, tests missing in the map are run as well\n\n",
+                   kernel_map, num_selected, num_mapped, changed_kernels);
+    }
+    else if (kernel_map)
+    {
+        if (!ct_kernel_trace_start_recording(kernel_map))
+            return 1;
+    }
+
     {
         struct CT_TestCaseEntry** ppLastTestCase = &g_firstTestCase;
         while (g_testcase_register_fns[total_testcases])
@@ -620,23 +868,21 @@ int CT_main(int argc, char* argv[], const char* version_str)
             *ppLastTest = testcase->test_register_fns_[test_id]();
             while (*ppLastTest)
             {
-                if (ppLastTest[0]->args_)
+                int arg_flags = 0;
+                struct CT_TestEntry* test = ppLastTest[0];
+                int narg = 0;
+                for (; narg < (test->args_ ? test->args_count_ : 1); narg++)
                 {
-                    int extended_flag = 0;
-                    struct CT_TestEntry* test = ppLastTest[0];
-                    int narg = 0;
-                    for (; narg < test->args_count_; narg++)
+                    void *parg = get_test_params(test, narg);
+                    if (update_arg_flags(parg, &arg_flags))
+                        continue;
+                    if (!is_arg_enabled(parg, arg_flags))
+                        continue;
+                    if (!add_test_to_index(testcase, test, narg))
                     {
-                        void *parg = get_test_params(test, narg);
-                        if (update_extended_flag(parg, &extended_flag))
-                            continue;
-                        if (extended_flag && !ct_check_any_size())
-                            continue;
-                        testcase_tests += 1;
+                        printf("ERROR: Not enough memory to build test index\n");
+                        return 1;
                     }
-                }
-                else
-                {
                     testcase_tests += 1;
                 }
                 ppLastTest[0]->testcase_ = testcase;
@@ -648,13 +894,24 @@ int CT_main(int argc, char* argv[], const char* version_str)
         testcase = testcase->next_;
     }
 
+    if (!sort_test_index())
+    {
+        printf("ERROR: Not enough memory to build test index\n");
+        return 1;
+    }
+    select_filter_candidates();
+
 
     if (!g_context.internal_->g_quiet)
     {
         printf("[ ======== ] Total %d tests from %d test cases\n", total_tests, total_testcases);
         if (g_test_filter)
             printf("Use test filter: %s\n\n", g_test_filter);
+        if (g_filter_names)
+            printf("Use test filter file: %s (%d test names)\n\n", filter_file, ct_name_set_size(g_filter_names));
         printf("Use global OpenVX context: %s\n\n", use_global_context ? "TRUE" : "FALSE");
+        if (ct_get_ref_cache_dir())
+            printf("Use reference cache: %s\n\n", ct_get_ref_cache_dir());
         printf("\n");
     }
 
@@ -662,34 +919,25 @@ int CT_main(int argc, char* argv[], const char* version_str)
     g_tickFreq = CT_getTickFrequency();
 #endif
 
-    if (use_global_context)
+    if (use_global_context && !g_context.internal_->g_list_tests)
         ct_create_global_vx_context();
 
 #ifdef CT_TEST_TIME
     timestart_all = CT_getTickCount();
 #endif
 
-    for (testcase = g_firstTestCase; testcase; testcase = testcase->next_)
+    for (test_pos = 0; test_pos < g_test_index_size; )
     {
         int run_tests = 0;
-        int extended_flag = 0;
-        struct CT_TestEntry* test = testcase->tests_;
 
 #ifdef CT_TEST_TIME
         int64_t timestart_testCase = CT_getTickCount();
 #endif
 
-        for(; test; test = test->next_)
-        {
-            if (!test->args_)
-                run_tests += run_test(testcase, test, 0, run_tests, &extended_flag);
-            else
-            {
-                int narg = 0;
-                for (; narg < test->args_count_; narg++)
-                    run_tests += run_test(testcase, test, narg, run_tests, &extended_flag);
-            }
-        }
+        // tests of a test case are contiguous in the index
+        testcase = g_test_index[test_pos].testcase;
+        for (; test_pos < g_test_index_size && g_test_index[test_pos].testcase == testcase; test_pos++)
+            run_tests += run_test(&g_test_index[test_pos], run_tests);
 
         if (run_tests)
         {
@@ -774,6 +1022,12 @@ int CT_main(int argc, char* argv[], const char* version_str)
             printf("[ FAILED   ] %d test(s)\n", g_context.internal_->g_num_failed_tests_);
         }
         printf("[ DISABLED ] %d test(s)\n", g_context.internal_->g_num_disabled_tests_);
+        if (ct_get_ref_cache_dir())
+        {
+            int hits = 0, misses = 0;
+            ct_ref_cache_get_stats(&hits, &misses);
+            printf("[ REFCACHE ] %d reference result(s) loaded, %d computed\n", hits, misses);
+        }
 
         //================ OpenVX Specific ===================
         printf("\n");
@@ -810,10 +1064,11 @@ int CT_main(int argc, char* argv[], const char* version_str)
     }
     fflush(stdout);
     ct_release_global_vx_context();
+    ct_kernel_trace_stop_recording();
 
     if (testid_str == 0)
     {
-        if (g_test_filter)
+        if (g_test_filter || filter_file || changed_kernels)
             testid_str = "FILTERED";
         else
             testid_str = "ALL";
@@ -850,5 +1105,11 @@ int CT_main(int argc, char* argv[], const char* version_str)
         fflush(g_context.internal_->g_quiet ? stderr : stdout);
     }
 
+    ct_filter_release(&g_compiled_filter);
+    ct_name_set_release(&g_filter_names);
+    release_test_index();
+    ct_parallel_shutdown();
+    ct_mem_pool_release();
+
     return (g_context.internal_->g_num_failed_tests_ > 0) ? 1 : 0;
 }
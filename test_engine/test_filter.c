@@ -0,0 +1,328 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "test_filter.h"
+
+typedef struct {
+    const char* text;
+    size_t      len;
+    size_t      prefix_len; // literal characters before the first wildcard
+    int         negative;
+} CT_FilterPattern;
+
+struct CT_Filter {
+    CT_FilterPattern* patterns;
+    int               count;
+};
+
+CT_Filter* ct_filter_compile(const char* filter)
+{
+    CT_Filter* compiled = NULL;
+    const char* cur = filter;
+    int count = 1;
+
+    if (filter == NULL)
+        return NULL;
+
+    for (; *cur; cur++)
+        count += *cur == ':';
+
+    compiled = (CT_Filter*)malloc(sizeof(*compiled));
+    if (compiled == NULL)
+        return NULL;
+    compiled->patterns = (CT_FilterPattern*)malloc(count * sizeof(CT_FilterPattern));
+    if (compiled->patterns == NULL)
+    {
+        free(compiled);
+        return NULL;
+    }
+    compiled->count = count;
+
+    // the filter string is owned by the caller (argv) and stays alive
+    for (cur = filter, count = 0; count < compiled->count; count++)
+    {
+        CT_FilterPattern* p = &compiled->patterns[count];
+        p->negative = *cur == '-';
+        if (p->negative)
+            cur++;
+        p->text = cur;
+        p->len = strcspn(cur, ":\n"); // '\n' ends the pattern, the rest up to ':' is ignored
+        p->prefix_len = strcspn(cur, "*?:\n");
+        cur = strchr(cur, ':');
+        cur = cur ? cur + 1 : "";
+    }
+
+    return compiled;
+}
+
+void ct_filter_release(CT_Filter** filter)
+{
+    if (filter && *filter)
+    {
+        free((*filter)->patterns);
+        free(*filter);
+        *filter = NULL;
+    }
+}
+
+int ct_filter_is_literal(const CT_Filter* filter)
+{
+    int i;
+
+    if (filter == NULL)
+        return 0;
+    for (i = 0; i < filter->count; i++)
+    {
+        if (filter->patterns[i].negative || filter->patterns[i].prefix_len != filter->patterns[i].len)
+            return 0;
+    }
+    return 1;
+}
+
+int ct_filter_get_pattern(const CT_Filter* filter, int i, const char** text, size_t* len)
+{
+    if (filter == NULL || i < 0 || i >= filter->count)
+        return 0;
+    *text = filter->patterns[i].text;
+    *len = filter->patterns[i].len;
+    return 1;
+}
+
+/*
+    Wildcard matching with backtracking to the last '*' only: a later '*' can absorb everything an
+    earlier one could, so the earlier stars never need to be revisited. The end of the pattern
+    matches the end of the name or a '/' (the name of a parameterized test without the parameters).
+*/
+static int ct_filter_pattern_match(const CT_FilterPattern* p, const char* str)
+{
+    const char* pat = p->text;
+    size_t s = 0, i = 0, star_i = (size_t)-1, star_s = 0;
+
+    if (strncmp(str, pat, p->prefix_len) != 0)
+        return 0;
+    if (p->prefix_len == p->len)
+        return str[p->len] == '\0' || str[p->len] == '/';
+
+    s = i = p->prefix_len;
+    for (;;)
+    {
+        if (i < p->len && pat[i] == '*')
+        {
+            star_i = i++;
+            star_s = s;
+            continue;
+        }
+        if (i == p->len)
+        {
+            if (str[s] == '\0' || str[s] == '/')
+                return 1;
+        }
+        else if (str[s] != '\0' && (pat[i] == '?' || pat[i] == str[s]))
+        {
+            i++;
+            s++;
+            continue;
+        }
+
+        if (star_i == (size_t)-1 || str[star_s] == '\0')
+            return 0;
+        i = star_i + 1;
+        s = ++star_s;
+    }
+}
+
+int ct_filter_match(const CT_Filter* filter, const char* test_name)
+{
+    int i, result = 0;
+
+    if (filter == NULL)
+        return 1;
+
+    // positive patterns are checked until the first match, negative ones always win
+    for (i = 0; i < filter->count; i++)
+    {
+        const CT_FilterPattern* p = &filter->patterns[i];
+        if ((result == 0 || p->negative) && ct_filter_pattern_match(p, test_name))
+        {
+            if (p->negative)
+                return 0;
+            result = 1;
+        }
+    }
+
+    return result;
+}
+
+//============================================================================
+
+struct CT_NameSet {
+    char** slots;    // NULL - empty slot
+    size_t capacity; // power of 2
+    int    size;
+};
+
+static uint64_t ct_name_hash(const char* str)
+{
+    uint64_t hval = 0xCBF29CE484222325ULL;
+    while (*str)
+    {
+        hval ^= (uint64_t)(unsigned char)*str++;
+        hval *= 0x100000001B3ULL;
+    }
+    return hval;
+}
+
+static char** ct_name_set_find(char** slots, size_t capacity, const char* name)
+{
+    size_t i = (size_t)ct_name_hash(name) & (capacity - 1);
+    while (slots[i] && strcmp(slots[i], name) != 0)
+        i = (i + 1) & (capacity - 1);
+    return &slots[i];
+}
+
+CT_NameSet* ct_name_set_create()
+{
+    CT_NameSet* set = (CT_NameSet*)malloc(sizeof(*set));
+    if (set == NULL)
+        return NULL;
+    set->capacity = 1024;
+    set->size = 0;
+    set->slots = (char**)calloc(set->capacity, sizeof(char*));
+    if (set->slots == NULL)
+    {
+        free(set);
+        return NULL;
+    }
+    return set;
+}
+
+int ct_name_set_add(CT_NameSet* set, const char* name)
+{
+    char** slot;
+
+    if (2 * ((size_t)set->size + 1) > set->capacity)
+    {
+        size_t i, capacity = set->capacity * 2;
+        char** slots = (char**)calloc(capacity, sizeof(char*));
+        if (slots == NULL)
+            return -1;
+        for (i = 0; i < set->capacity; i++)
+        {
+            if (set->slots[i])
+                *ct_name_set_find(slots, capacity, set->slots[i]) = set->slots[i];
+        }
+        free(set->slots);
+        set->slots = slots;
+        set->capacity = capacity;
+    }
+
+    slot = ct_name_set_find(set->slots, set->capacity, name);
+    if (*slot)
+        return 0;
+    *slot = (char*)malloc(strlen(name) + 1);
+    if (*slot == NULL)
+        return -1;
+    strcpy(*slot, name);
+    set->size++;
+    return 1;
+}
+
+int ct_name_set_contains(const CT_NameSet* set, const char* name)
+{
+    return set && *ct_name_set_find(set->slots, set->capacity, name) != NULL;
+}
+
+int ct_name_set_size(const CT_NameSet* set)
+{
+    return set ? set->size : 0;
+}
+
+void ct_name_set_release(CT_NameSet** set)
+{
+    size_t i;
+
+    if (set == NULL || *set == NULL)
+        return;
+    for (i = 0; i < (*set)->capacity; i++)
+        free((*set)->slots[i]);
+    free((*set)->slots);
+    free(*set);
+    *set = NULL;
+}
+
+int ct_read_line(FILE* f, char** buf, size_t* buf_size)
+{
+    size_t len = 0;
+    int c;
+
+    while ((c = fgetc(f)) != EOF && c != '\n')
+    {
+        if (len + 1 >= *buf_size)
+        {
+            size_t new_size = *buf_size ? *buf_size * 2 : 1024;
+            char* new_buf = (char*)realloc(*buf, new_size);
+            if (new_buf == NULL)
+                return 0;
+            *buf = new_buf;
+            *buf_size = new_size;
+        }
+        (*buf)[len++] = (char)c;
+    }
+
+    if (c == EOF && len == 0)
+        return 0;
+    if (*buf == NULL)
+    {
+        *buf = (char*)malloc(1);
+        *buf_size = 1;
+        if (*buf == NULL)
+            return 0;
+    }
+    if (len > 0 && (*buf)[len - 1] == '\r')
+        len--;
+    (*buf)[len] = 0;
+    return 1;
+}
+
+CT_NameSet* ct_name_set_load(const char* file_name)
+{
+    FILE* f = fopen(file_name, "r");
+    CT_NameSet* set = NULL;
+    char* line = NULL;
+    size_t line_size = 0;
+
+    if (f == NULL)
+        return NULL;
+
+    set = ct_name_set_create();
+    while (set && ct_read_line(f, &line, &line_size))
+    {
+        if (line[0] == '#' || line[0] == '\0')
+            continue;
+        if (ct_name_set_add(set, line) < 0)
+            ct_name_set_release(&set);
+    }
+
+    free(line);
+    fclose(f);
+    return set;
+}
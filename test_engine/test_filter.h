@@ -0,0 +1,59 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VX_CT_FILTER_H__
+#define __VX_CT_FILTER_H__
+
+#include <stdio.h>
+
+/*
+    Test name selection (test engine internals, used by CT_main).
+
+    CT_Filter is a --filter string compiled once: ':'-separated patterns with '*' and '?'
+    wildcards, '-' prefix makes the pattern negative. A pattern matches the whole name or the part
+    before any '/' (so "Box3x3.Graph" matches all its parameters). Patterns are matched without
+    recursion, in O(name * pattern) at worst, patterns without wildcards are plain comparisons.
+
+    CT_NameSet is a hash set of exact test names (--filter_file, kernel maps).
+*/
+
+typedef struct CT_Filter CT_Filter;
+
+CT_Filter* ct_filter_compile(const char* filter); // NULL filter matches everything
+int        ct_filter_match(const CT_Filter* filter, const char* test_name);
+void       ct_filter_release(CT_Filter** filter);
+
+// 1 if all the patterns are positive and have no wildcards, i.e. the filter is a list of test names
+int        ct_filter_is_literal(const CT_Filter* filter);
+// returns 0 past the last pattern, 'text' is not zero-terminated
+int        ct_filter_get_pattern(const CT_Filter* filter, int i, const char** text, size_t* len);
+
+typedef struct CT_NameSet CT_NameSet;
+
+CT_NameSet* ct_name_set_create();
+int         ct_name_set_add(CT_NameSet* set, const char* name); // 1 - added, 0 - already there, -1 - no memory
+int         ct_name_set_contains(const CT_NameSet* set, const char* name);
+int         ct_name_set_size(const CT_NameSet* set);
+void        ct_name_set_release(CT_NameSet** set);
+
+// reads the whole line (without the '\n' or "\r\n") into the growing malloc() buffer, returns 0 at the end of file
+int ct_read_line(FILE* f, char** buf, size_t* buf_size);
+
+// names from the file, one per line, empty lines and lines starting with '#' are skipped
+CT_NameSet* ct_name_set_load(const char* file_name);
+
+#endif // __VX_CT_FILTER_H__
@@ -0,0 +1,243 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <float.h>
+#include <math.h>
+
+#include "test.h"
+#include "test_geometry.h"
+
+static vx_int32 ct_geom_get_pixel(const CT_GeomCheckContext* ctx, vx_int32 x, vx_int32 y)
+{
+    CT_Image src = ctx->src;
+
+    if (0 <= x && 0 <= y && x < (vx_int32)src->width && y < (vx_int32)src->height)
+        return *CT_IMAGE_DATA_PTR_8U(src, x, y);
+
+    if (ctx->border.mode == VX_BORDER_CONSTANT)
+        return ctx->border.constant_value.U8;
+
+    if (ctx->border.mode == VX_BORDER_REPLICATE)
+    {
+        x = CT_MAX(0, CT_MIN(x, (vx_int32)src->width - 1));
+        y = CT_MAX(0, CT_MIN(y, (vx_int32)src->height - 1));
+        return *CT_IMAGE_DATA_PTR_8U(src, x, y);
+    }
+
+    return -1; // undefined
+}
+
+int ct_geom_check_nearest(const CT_GeomCheckContext* ctx, vx_float64 x0, vx_float64 y0, vx_int32 value, vx_int32* expected)
+{
+    vx_int32 xi, yi;
+
+    for (yi = (vx_int32)ceil(y0 - CT_GEOM_NN_AREA_SIZE); (vx_float64)yi <= y0 + CT_GEOM_NN_AREA_SIZE; yi++)
+    {
+        for (xi = (vx_int32)ceil(x0 - CT_GEOM_NN_AREA_SIZE); (vx_float64)xi <= x0 + CT_GEOM_NN_AREA_SIZE; xi++)
+        {
+            vx_int32 candidate = ct_geom_get_pixel(ctx, xi, yi);
+            if (candidate == -1 || candidate == value)
+                return 1;
+        }
+    }
+
+    *expected = ct_geom_get_pixel(ctx, (vx_int32)floor(x0 + 0.5), (vx_int32)floor(y0 + 0.5));
+    return 0;
+}
+
+int ct_geom_check_bilinear(const CT_GeomCheckContext* ctx, vx_float64 x0, vx_float64 y0, vx_int32 value, vx_int32* expected)
+{
+    CT_Image src = ctx->src;
+    vx_float64 xlower = floor(x0), ylower = floor(y0);
+    vx_float64 s = x0 - xlower, t = y0 - ylower;
+    vx_int32 xi = (vx_int32)xlower, yi = (vx_int32)ylower;
+    vx_int32 candidate = -1;
+
+    if (0 <= xi && 0 <= yi && xi < (vx_int32)src->width - 1 && yi < (vx_int32)src->height - 1)
+    {
+        const uint8_t* p = CT_IMAGE_DATA_PTR_8U(src, xi, yi);
+        candidate = (vx_int32)((1. - s) * (1. - t) * (vx_float64)p[0] +
+                                     s  * (1. - t) * (vx_float64)p[1] +
+                               (1. - s) *       t  * (vx_float64)p[src->stride] +
+                                     s  *       t  * (vx_float64)p[src->stride + 1]);
+    }
+    else if (ctx->border.mode != VX_BORDER_UNDEFINED)
+    {
+        candidate = (vx_int32)((1. - s) * (1. - t) * (vx_float64)ct_geom_get_pixel(ctx, xi    , yi    ) +
+                                     s  * (1. - t) * (vx_float64)ct_geom_get_pixel(ctx, xi + 1, yi    ) +
+                               (1. - s) *       t  * (vx_float64)ct_geom_get_pixel(ctx, xi    , yi + 1) +
+                                     s  *       t  * (vx_float64)ct_geom_get_pixel(ctx, xi + 1, yi + 1));
+    }
+
+    if (candidate == -1 || abs(candidate - value) <= CT_GEOM_BILINEAR_TOLERANCE)
+        return 1;
+
+    *expected = candidate;
+    return 0;
+}
+
+typedef struct {
+    CT_Image              dst;
+    const CT_GeomMapping* mapping;
+    const vx_float32*     scale_x; // CT_GEOM_MAPPING_SCALE source coordinates of columns and rows
+    const vx_float32*     scale_y;
+    CT_GeomPixelCheck     check;
+    CT_GeomCheckContext   ctx;
+    CT_GeomResult*        result;
+} CT_GeomJob;
+
+static void ct_geom_validate_rows(void* job_, int begin, int end)
+{
+    CT_GeomJob* job = (CT_GeomJob*)job_;
+    const CT_GeomMapping* mapping = job->mapping;
+    const vx_float32* m = mapping->matrix;
+    CT_Image dst = job->dst;
+    CT_GeomResult local;
+    int x, y;
+
+    local.num_checked = local.num_failed = 0;
+    local.first_x = local.first_y = -1;
+    local.first_value = local.first_expected = -1;
+
+    for (y = begin; y < end; y++)
+    {
+        const uint8_t* dst_row = CT_IMAGE_DATA_PTR_8U(dst, 0, y);
+        const vx_coordinates2df_t* table_row = NULL;
+        vx_float64 row_x = 0, row_y = 0, row_z = 1;
+
+        switch (mapping->type)
+        {
+        case CT_GEOM_MAPPING_AFFINE:
+            row_x = (vx_float64)m[2 * 1 + 0] * (vx_float64)y + (vx_float64)m[2 * 2 + 0];
+            row_y = (vx_float64)m[2 * 1 + 1] * (vx_float64)y + (vx_float64)m[2 * 2 + 1];
+            break;
+        case CT_GEOM_MAPPING_PERSPECTIVE:
+            row_x = (vx_float64)m[3 * 1 + 0] * (vx_float64)y + (vx_float64)m[3 * 2 + 0];
+            row_y = (vx_float64)m[3 * 1 + 1] * (vx_float64)y + (vx_float64)m[3 * 2 + 1];
+            row_z = (vx_float64)m[3 * 1 + 2] * (vx_float64)y + (vx_float64)m[3 * 2 + 2];
+            break;
+        case CT_GEOM_MAPPING_TABLE:
+            table_row = (const vx_coordinates2df_t*)((const uint8_t*)mapping->table + (size_t)y * mapping->table_stride);
+            break;
+        default:
+            break;
+        }
+
+        for (x = 0; x < (int)dst->width; x++)
+        {
+            vx_float64 src_x = 0, src_y = 0;
+            vx_int32 value = dst_row[x], expected = -1;
+
+            switch (mapping->type)
+            {
+            case CT_GEOM_MAPPING_AFFINE:
+                src_x = row_x + (vx_float64)m[2 * 0 + 0] * (vx_float64)x;
+                src_y = row_y + (vx_float64)m[2 * 0 + 1] * (vx_float64)x;
+                break;
+            case CT_GEOM_MAPPING_PERSPECTIVE:
+            {
+                vx_float64 z = row_z + (vx_float64)m[3 * 0 + 2] * (vx_float64)x;
+                if (fabs(z) < DBL_MIN)
+                    continue; // point at infinity, nothing to check
+                src_x = (row_x + (vx_float64)m[3 * 0 + 0] * (vx_float64)x) / z;
+                src_y = (row_y + (vx_float64)m[3 * 0 + 1] * (vx_float64)x) / z;
+                break;
+            }
+            case CT_GEOM_MAPPING_SCALE:
+                src_x = job->scale_x[x];
+                src_y = job->scale_y[y];
+                break;
+            case CT_GEOM_MAPPING_TABLE:
+                src_x = table_row[x].x;
+                src_y = table_row[x].y;
+                break;
+            }
+
+            local.num_checked++;
+            if (!job->check(&job->ctx, src_x, src_y, value, &expected))
+            {
+                if (local.num_failed++ == 0)
+                {
+                    local.first_x = x;
+                    local.first_y = y;
+                    local.first_value = value;
+                    local.first_expected = expected;
+                }
+            }
+        }
+    }
+
+    ct_global_lock();
+    job->result->num_checked += local.num_checked;
+    if (local.num_failed > 0)
+    {
+        if (job->result->num_failed == 0 || local.first_y < job->result->first_y)
+        {
+            job->result->first_x = local.first_x;
+            job->result->first_y = local.first_y;
+            job->result->first_value = local.first_value;
+            job->result->first_expected = local.first_expected;
+        }
+        job->result->num_failed += local.num_failed;
+    }
+    ct_global_unlock();
+}
+
+void ct_geom_validate(CT_Image src, CT_Image dst, const CT_GeomMapping* mapping, vx_border_t border,
+                      CT_GeomPixelCheck check, void* user_data, CT_GeomResult* result)
+{
+    CT_GeomJob job;
+    vx_float32* scale_x = NULL;
+    vx_float32* scale_y = NULL;
+
+    ASSERT(src && dst && mapping && check && result);
+    ASSERT(src->format == VX_DF_IMAGE_U8 && dst->format == VX_DF_IMAGE_U8);
+    ASSERT(border.mode == VX_BORDER_UNDEFINED || border.mode == VX_BORDER_CONSTANT || border.mode == VX_BORDER_REPLICATE);
+    ASSERT((mapping->type != CT_GEOM_MAPPING_AFFINE && mapping->type != CT_GEOM_MAPPING_PERSPECTIVE) || mapping->matrix);
+    ASSERT(mapping->type != CT_GEOM_MAPPING_TABLE || mapping->table);
+
+    result->num_checked = result->num_failed = 0;
+    result->first_x = result->first_y = -1;
+    result->first_value = result->first_expected = -1;
+
+    if (mapping->type == CT_GEOM_MAPPING_SCALE)
+    {
+        uint32_t i;
+        scale_x = (vx_float32*)ct_alloc_mem(dst->width * sizeof(vx_float32));
+        scale_y = (vx_float32*)ct_alloc_mem(dst->height * sizeof(vx_float32));
+        ASSERT_({ ct_free_mem(scale_x); ct_free_mem(scale_y); return; }, scale_x && scale_y);
+        for (i = 0; i < dst->width; i++)
+            scale_x[i] = (((vx_float32)i + 0.5f) * (vx_float32)src->width / (vx_float32)dst->width) - 0.5f;
+        for (i = 0; i < dst->height; i++)
+            scale_y[i] = (((vx_float32)i + 0.5f) * (vx_float32)src->height / (vx_float32)dst->height) - 0.5f;
+    }
+
+    job.dst           = dst;
+    job.mapping       = mapping;
+    job.scale_x       = scale_x;
+    job.scale_y       = scale_y;
+    job.check         = check;
+    job.ctx.src       = src;
+    job.ctx.border    = border;
+    job.ctx.user_data = user_data;
+    job.result        = result;
+
+    ct_parallel_for(0, (int)dst->height, ct_geom_validate_rows, &job);
+
+    ct_free_mem(scale_x);
+    ct_free_mem(scale_y);
+}
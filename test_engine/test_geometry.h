@@ -0,0 +1,76 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VX_CT_GEOMETRY_H__
+#define __VX_CT_GEOMETRY_H__
+
+#include <VX/vx.h>
+#include "test_image.h"
+
+/*
+    Whole-image validation of geometric transformations (Scale, WarpAffine, WarpPerspective, Remap).
+
+    For every output pixel the source coordinate is computed by the mapping (affine and perspective
+    mappings are evaluated incrementally along the row, scale coordinates are separable and computed
+    once per column/row), then the pixel check function decides if the output value is acceptable.
+    Rows are processed in parallel, failures are aggregated into CT_GeomResult instead of being
+    reported per pixel.
+*/
+
+typedef enum CT_GeomMappingType_ {
+    CT_GEOM_MAPPING_AFFINE,      // matrix: 2x3 vx_float32 matrix of vxWarpAffine (m[2 * col + row])
+    CT_GEOM_MAPPING_PERSPECTIVE, // matrix: 3x3 vx_float32 matrix of vxWarpPerspective (m[3 * col + row])
+    CT_GEOM_MAPPING_SCALE,       // pixel centers of source and destination are aligned, as in vxScaleImage
+    CT_GEOM_MAPPING_TABLE        // table: source coordinates of every output pixel, table_stride in bytes
+} CT_GeomMappingType;
+
+typedef struct CT_GeomMapping_ {
+    CT_GeomMappingType         type;
+    const vx_float32*          matrix;
+    const vx_coordinates2df_t* table;
+    vx_size                    table_stride;
+} CT_GeomMapping;
+
+typedef struct CT_GeomCheckContext_ {
+    CT_Image    src;
+    vx_border_t border;
+    void*       user_data;
+} CT_GeomCheckContext;
+
+// returns non-zero if 'value' is acceptable for source coordinate (src_x, src_y), may set 'expected' for the report;
+// called from worker threads, see test_parallel.h for restrictions
+typedef int (*CT_GeomPixelCheck)(const CT_GeomCheckContext* ctx, vx_float64 src_x, vx_float64 src_y, vx_int32 value, vx_int32* expected);
+
+// standard tolerance models of warp and remap tests: nearest neighbor in 1.5 pixels area, bilinear +-1
+#define CT_GEOM_NN_AREA_SIZE         1.5
+#define CT_GEOM_BILINEAR_TOLERANCE   1
+
+int ct_geom_check_nearest(const CT_GeomCheckContext* ctx, vx_float64 src_x, vx_float64 src_y, vx_int32 value, vx_int32* expected);
+int ct_geom_check_bilinear(const CT_GeomCheckContext* ctx, vx_float64 src_x, vx_float64 src_y, vx_int32 value, vx_int32* expected);
+
+typedef struct CT_GeomResult_ {
+    uint32_t num_checked;
+    uint32_t num_failed;
+    int      first_x, first_y;    // first failed pixel in raster order
+    vx_int32 first_value;
+    vx_int32 first_expected;      // -1 if not provided by the check function
+} CT_GeomResult;
+
+void ct_geom_validate(CT_Image src, CT_Image dst, const CT_GeomMapping* mapping, vx_border_t border,
+                      CT_GeomPixelCheck check, void* user_data, CT_GeomResult* result);
+
+#endif // __VX_CT_GEOMETRY_H__
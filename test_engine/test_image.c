@@ -195,15 +195,18 @@ static CT_Image ct_allocate_image_hdr_impl(uint32_t width, uint32_t height, uint
     if (allocate_data)
     {
         uint8_t* bytes;
-        size_t memory_size = ct_image_data_size(width, height, format) + sizeof(uint32_t) * 2;
+        // room for the reference counter and the alignment, ct_alloc_mem() memory is not
+        // CT_MEM_ALIGNMENT aligned with CT_DISABLE_MEM_POOL
+        size_t memory_size = ct_image_data_size(width, height, format) + 2 * CT_MEM_ALIGNMENT;
 
         bytes = (uint8_t*)ct_alloc_mem(memory_size);
         CT_ASSERT_(return 0, bytes); // out of memory
         ct_memset(bytes, 153, memory_size); // fill with some "magic" value
         image->data_begin_ = bytes;
-        image->refcount_ = (uint32_t*)( (((size_t)bytes) + sizeof(uint32_t) - 1) & ~((size_t)(sizeof(uint32_t) - 1)) ); // align ptr to 4 bytes
+        image->refcount_ = (uint32_t*)bytes;
         *image->refcount_ = 1;
-        image->data.u32 = image->refcount_ + 1;
+        // keep pixel data aligned for vector loads
+        image->data.y = (uint8_t*)(((uintptr_t)bytes + sizeof(uint32_t) + CT_MEM_ALIGNMENT - 1) & ~(uintptr_t)(CT_MEM_ALIGNMENT - 1));
     }
 
     return image;
@@ -319,7 +322,8 @@ void ct_adjust_roi(CT_Image img, int left, int top, int right, int bottom)
     }
     else
     {
-        img->data.y = img->data.y + (img->stride * top + left) * ct_image_bits_per_pixel(img->format) / 8;
+        // signed, negative margins move the view into the padding of ct_image_make_padded() images
+        img->data.y = img->data.y + ((ptrdiff_t)img->stride * top + left) * (ptrdiff_t)ct_image_bits_per_pixel(img->format) / 8;
         img->roi.x  = (uint32_t)new_x;
         img->roi.y  = (uint32_t)new_y;
         img->width  = (uint32_t)new_width;
@@ -1081,11 +1085,14 @@ void ct_dump_image_info_ex(CT_Image image, int dump_width, int dump_height)
     }
 }
 
-void ct_fill_ct_image_random(CT_Image image, uint64_t* seed, int a, int b)
+// describes the image as planes of U8/U16/S16/U32/S32 elements, returns the element format
+static vx_df_image ct_random_fill_layout(CT_Image image, uint32_t* nplanes_, uint32_t width[3], uint32_t height[3], uint32_t stride[3])
 {
     vx_df_image format = image->format;
-    uint32_t p, x, y, nplanes=1, width[3] = {image->width, 0, 0}, height[3] = {image->height, 0, 0};
-    uint32_t stride[3] = {ct_stride_bytes(image), 0, 0};
+    uint32_t nplanes = 1;
+
+    width[0] = image->width; height[0] = image->height; stride[0] = ct_stride_bytes(image);
+    width[1] = width[2] = height[1] = height[2] = stride[1] = stride[2] = 0;
 
     if( format == VX_DF_IMAGE_RGB || format == VX_DF_IMAGE_RGBX || format == VX_DF_IMAGE_YUYV || format == VX_DF_IMAGE_UYVY )
     {
@@ -1110,6 +1117,15 @@ void ct_fill_ct_image_random(CT_Image image, uint64_t* seed, int a, int b)
         format = VX_DF_IMAGE_U8;
     }
 
+    *nplanes_ = nplanes;
+    return format;
+}
+
+void ct_fill_ct_image_random(CT_Image image, uint64_t* seed, int a, int b)
+{
+    uint32_t p, x, y, nplanes, width[3], height[3], stride[3];
+    vx_df_image format = ct_random_fill_layout(image, &nplanes, width, height, stride);
+
     ASSERT( format == VX_DF_IMAGE_U8 ||
             format == VX_DF_IMAGE_U16 || format == VX_DF_IMAGE_S16 ||
             format == VX_DF_IMAGE_U32 || format == VX_DF_IMAGE_S32);
@@ -1153,6 +1169,106 @@ CT_Image ct_allocate_ct_image_random(uint32_t width, uint32_t height,
     return image;
 }
 
+typedef struct {
+    uint8_t*    data[3];
+    uint32_t    width[3], height[3], stride[3];
+    uint64_t    first_index[3]; // counter of the first element of the plane
+    uint32_t    nplanes;
+    vx_df_image format;
+    uint64_t    key;
+    int         a, b;
+} ct_random_fill_job;
+
+static void ct_fill_ct_image_random_rows(void* job_, int begin, int end)
+{
+    ct_random_fill_job* job = (ct_random_fill_job*)job_;
+    int row;
+
+    // rows of all the planes are numbered continuously
+    for (row = begin; row < end; row++)
+    {
+        uint32_t p = 0, x, y = (uint32_t)row;
+        uint64_t index;
+        uint8_t* ptr;
+
+        while (y >= job->height[p])
+            y -= job->height[p++];
+        ptr = job->data[p] + (size_t)y * job->stride[p];
+        index = job->first_index[p] + (uint64_t)y * job->width[p];
+
+#undef CASE_FILL_ROW
+#define CASE_FILL_ROW(format, type, cast_macro) \
+        case format: \
+        { \
+            type* tptr = (type*)ptr; \
+            for (x = 0; x < job->width[p]; x++) \
+            { \
+                int val; \
+                CT_RNG_AT_INT(val, job->key, index + x, job->a, job->b); \
+                tptr[x] = cast_macro(val); \
+            } \
+        } \
+        break
+
+        switch (job->format)
+        {
+            CASE_FILL_ROW(VX_DF_IMAGE_U8, uint8_t, CT_CAST_U8);
+            CASE_FILL_ROW(VX_DF_IMAGE_U16, uint16_t, CT_CAST_U16);
+            CASE_FILL_ROW(VX_DF_IMAGE_S16, int16_t, CT_CAST_S16);
+            CASE_FILL_ROW(VX_DF_IMAGE_U32, uint32_t, CT_CAST_U32);
+            CASE_FILL_ROW(VX_DF_IMAGE_S32, int32_t, CT_CAST_S32);
+        default:
+            break;
+        }
+#undef CASE_FILL_ROW
+    }
+}
+
+void ct_fill_ct_image_random_keyed(CT_Image image, uint64_t* seed, int a, int b)
+{
+    ct_random_fill_job job;
+    uint32_t p, nrows = 0;
+    uint64_t rng;
+
+    ASSERT(image && seed && a < b);
+
+    job.format = ct_random_fill_layout(image, &job.nplanes, job.width, job.height, job.stride);
+    ASSERT( job.format == VX_DF_IMAGE_U8 ||
+            job.format == VX_DF_IMAGE_U16 || job.format == VX_DF_IMAGE_S16 ||
+            job.format == VX_DF_IMAGE_U32 || job.format == VX_DF_IMAGE_S32);
+
+    job.data[0] = image->data.y;
+    job.first_index[0] = 0;
+    for (p = 0; p < job.nplanes; p++)
+    {
+        if (p > 0)
+        {
+            job.data[p] = job.data[p - 1] + (size_t)job.height[p - 1] * job.stride[p - 1];
+            job.first_index[p] = job.first_index[p - 1] + (uint64_t)job.height[p - 1] * job.width[p - 1];
+        }
+        nrows += job.height[p];
+    }
+    for (; p < 3; p++)
+        job.height[p] = 0;
+    job.key = *seed;
+    job.a = a;
+    job.b = b;
+
+    ct_parallel_for(0, (int)nrows, ct_fill_ct_image_random_rows, &job);
+
+    CT_RNG_INIT(rng, *seed);
+    *seed = CT_RNG_NEXT(rng);
+}
+
+CT_Image ct_allocate_ct_image_random_keyed(uint32_t width, uint32_t height,
+                                           vx_df_image format, uint64_t* seed, int a, int b)
+{
+    CT_Image image = ct_allocate_image(width, height, format);
+    if(image)
+        ct_fill_ct_image_random_keyed(image, seed, a, b);
+    return image;
+}
+
 
 uint32_t ct_get_num_planes(vx_df_image format)
 {
@@ -1520,3 +1636,122 @@ int ct_image_read_rect_S32(CT_Image img, int32_t *dst, int32_t sx, int32_t sy, i
     }
     return res;
 }
+
+static void ct_image_fill_pixels(uint8_t* dst, const uint8_t* value, uint32_t count, uint32_t elem_size)
+{
+    uint32_t i;
+    if (elem_size == 1)
+    {
+        memset(dst, value[0], count);
+        return;
+    }
+    for (i = 0; i < count; i++, dst += elem_size)
+        memcpy(dst, value, elem_size);
+}
+
+CT_Image ct_image_make_padded(CT_Image img, vx_border_t border, uint32_t pad)
+{
+    CT_Image padded = NULL;
+    uint32_t y, width, height, elem_size, padded_width, padded_stride_bytes;
+    uint8_t constant_value[4] = { 0, 0, 0, 0 };
+    int replicate = (border.mode != VX_BORDER_CONSTANT);
+
+    ASSERT_(return NULL, img);
+    ASSERT_(return NULL, img->width > 0 && img->height > 0);
+
+    width = img->width;
+    height = img->height;
+
+    switch (img->format)
+    {
+        case VX_DF_IMAGE_U8:   constant_value[0] = border.constant_value.U8; break;
+        case VX_DF_IMAGE_U16:  memcpy(constant_value, &border.constant_value.U16, 2); break;
+        case VX_DF_IMAGE_S16:  memcpy(constant_value, &border.constant_value.S16, 2); break;
+        case VX_DF_IMAGE_U32:  memcpy(constant_value, &border.constant_value.U32, 4); break;
+        case VX_DF_IMAGE_S32:  memcpy(constant_value, &border.constant_value.S32, 4); break;
+        case VX_DF_IMAGE_RGB:  memcpy(constant_value, border.constant_value.RGB, 3); break;
+        case VX_DF_IMAGE_RGBX: memcpy(constant_value, border.constant_value.RGBX, 4); break;
+        default:
+            CT_FAIL_(return NULL, "Padding is not supported for this format");
+    }
+
+    elem_size = ct_image_bits_per_pixel(img->format) / 8;
+    padded_width = width + 2 * pad;
+
+    ASSERT_NO_FAILURE_(return NULL, padded = ct_allocate_image(padded_width, height + 2 * pad, img->format));
+    padded_stride_bytes = ct_stride_bytes(padded);
+
+    for (y = 0; y < height; y++)
+    {
+        const uint8_t* src_row = img->data.y + (size_t)y * ct_stride_bytes(img);
+        uint8_t* dst_row = padded->data.y + (size_t)(y + pad) * padded_stride_bytes;
+
+        memcpy(dst_row + pad * elem_size, src_row, width * elem_size);
+        ct_image_fill_pixels(dst_row, replicate ? src_row : constant_value, pad, elem_size);
+        ct_image_fill_pixels(dst_row + (pad + width) * elem_size,
+                             replicate ? src_row + (width - 1) * elem_size : constant_value, pad, elem_size);
+    }
+
+    for (y = 0; y < pad; y++)
+    {
+        uint8_t* top_row = padded->data.y + (size_t)y * padded_stride_bytes;
+        uint8_t* bottom_row = padded->data.y + (size_t)(pad + height + y) * padded_stride_bytes;
+
+        if (replicate)
+        {
+            memcpy(top_row, padded->data.y + (size_t)pad * padded_stride_bytes, padded_width * elem_size);
+            memcpy(bottom_row, padded->data.y + (size_t)(pad + height - 1) * padded_stride_bytes, padded_width * elem_size);
+        }
+        else
+        {
+            ct_image_fill_pixels(top_row, constant_value, padded_width, elem_size);
+            ct_image_fill_pixels(bottom_row, constant_value, padded_width, elem_size);
+        }
+    }
+
+    return ct_get_image_roi_(padded, pad, pad, width, height);
+}
+
+typedef struct {
+    CT_Image       src;
+    uint8_t*       dst;
+    uint32_t       dst_stride_bytes;
+    CT_FilterRowFn row_fn;
+    void*          user_data;
+} CT_FilterJob;
+
+static void ct_filter_rows(void* job_, int begin, int end)
+{
+    CT_FilterJob* job = (CT_FilterJob*)job_;
+    CT_Image src = job->src;
+    int y;
+
+    for (y = begin; y < end; y++)
+    {
+        job->row_fn(CT_IMAGE_DATA_PTR_8U(src, 0, y), (int32_t)src->stride,
+                    job->dst + (size_t)y * job->dst_stride_bytes, src->width, job->user_data);
+    }
+}
+
+CT_Image ct_filter_image_8u(CT_Image src, vx_border_t border, uint32_t radius, vx_df_image dst_format,
+                            CT_FilterRowFn row_fn, void* user_data)
+{
+    CT_Image padded = NULL, dst = NULL;
+    CT_FilterJob job;
+
+    ASSERT_(return NULL, src && row_fn);
+    ASSERT_(return NULL, src->format == VX_DF_IMAGE_U8);
+
+    ASSERT_NO_FAILURE_(return NULL, padded = ct_image_make_padded(src, border, radius));
+    ASSERT_NO_FAILURE_(return NULL, dst = ct_allocate_image(src->width, src->height, dst_format));
+
+    job.src              = padded;
+    job.dst              = dst->data.y;
+    job.dst_stride_bytes = ct_stride_bytes(dst);
+    job.row_fn           = row_fn;
+    job.user_data        = user_data;
+
+    ct_parallel_for(0, (int)src->height, ct_filter_rows, &job);
+
+    return dst;
+}
@@ -18,6 +18,7 @@
 #ifndef __VX_CT_IMAGE_H__
 #define __VX_CT_IMAGE_H__
 
+#include <stddef.h>
 #include <VX/vx.h>
 
 typedef enum CT_ImageCopyDirection_ {
@@ -99,6 +100,17 @@ uint8_t ct_image_data_constant_8u(CT_Image image, int32_t x, int32_t y, vx_uint3
 #define CT_IMAGE_DATA_PTR_RGB(image, x, y) &(image)->data.rgb[(y) * (image)->stride + (x)]
 #define CT_IMAGE_DATA_PTR_RGBX(image, x, y) &(image)->data.rgbx[(y) * (image)->stride + (x)]
 
+// variants for views returned by ct_image_make_padded(), accept negative coordinates
+#define CT_PADDED_OFFSET(image, x, y) ((ptrdiff_t)(y) * (ptrdiff_t)(image)->stride + (ptrdiff_t)(x))
+
+#define CT_IMAGE_DATA_PTR_PADDED_8U(image, x, y) &(image)->data.y[CT_PADDED_OFFSET(image, x, y)]
+#define CT_IMAGE_DATA_PTR_PADDED_16U(image, x, y) &(image)->data.u16[CT_PADDED_OFFSET(image, x, y)]
+#define CT_IMAGE_DATA_PTR_PADDED_16S(image, x, y) &(image)->data.s16[CT_PADDED_OFFSET(image, x, y)]
+#define CT_IMAGE_DATA_PTR_PADDED_32U(image, x, y) &(image)->data.u32[CT_PADDED_OFFSET(image, x, y)]
+#define CT_IMAGE_DATA_PTR_PADDED_32S(image, x, y) &(image)->data.s32[CT_PADDED_OFFSET(image, x, y)]
+#define CT_IMAGE_DATA_PTR_PADDED_RGB(image, x, y) &(image)->data.rgb[CT_PADDED_OFFSET(image, x, y)]
+#define CT_IMAGE_DATA_PTR_PADDED_RGBX(image, x, y) &(image)->data.rgbx[CT_PADDED_OFFSET(image, x, y)]
+
 
 #define CT_FILL_IMAGE_8U(ret_error, image, op) \
     ASSERT_(ret_error, image != NULL); \
@@ -188,8 +200,40 @@ void ct_dump_image_info_ex(CT_Image image, int dump_width, int dump_height);
 void ct_fill_ct_image_random(CT_Image image, uint64_t* seed, int a, int b);
 CT_Image ct_allocate_ct_image_random(uint32_t width, uint32_t height, vx_df_image format, uint64_t* rng, int a, int b);
 
+/*
+    Fills the image with CT_RNG_AT_INT() values keyed by *seed and the element index (plane by plane,
+    row by row), rows are generated in parallel. The content doesn't depend on the number of threads,
+    but differs from ct_fill_ct_image_random(), which is kept for the data with existing goldens.
+    *seed is advanced by one step, so the following images get different content.
+*/
+void ct_fill_ct_image_random_keyed(CT_Image image, uint64_t* seed, int a, int b);
+CT_Image ct_allocate_ct_image_random_keyed(uint32_t width, uint32_t height, vx_df_image format, uint64_t* seed, int a, int b);
+
 CT_Image ct_image_create_clone(CT_Image image);
 
 int ct_image_read_rect_S32(CT_Image img, int32_t *dst, int32_t sx, int32_t sy, int32_t ex, int32_t ey, vx_border_t border);
 
+/*
+    Materializes a copy of the image with 'pad' pixels of border on each side (VX_BORDER_CONSTANT fills
+    them with the constant value, other modes replicate the edge pixels) and returns the view of the
+    original area. Pixels in [-pad, width + pad) x [-pad, height + pad) of the view can be accessed
+    with CT_IMAGE_DATA_PTR_PADDED_* macros without any border checks; ct_adjust_roi() with negative
+    margins extends the view into the padding. Single-plane formats only.
+*/
+CT_Image ct_image_make_padded(CT_Image img, vx_border_t border, uint32_t pad);
+
+/*
+    Row-parallel 8u filter engine for reference implementations.
+
+    The source image is copied once with ct_image_make_padded() using 'radius' as padding
+    (VX_BORDER_UNDEFINED is handled as VX_BORDER_REPLICATE), then rows of the destination are computed
+    in parallel. row_fn receives the pointer to the first pixel of the source row and may access
+    src[dy * src_stride + x + dx] for any |dx|, |dy| <= radius without border checks.
+    row_fn is called from worker threads, see test_parallel.h for restrictions.
+*/
+typedef void (*CT_FilterRowFn)(const uint8_t* src, int32_t src_stride, void* dst, uint32_t width, void* user_data);
+
+CT_Image ct_filter_image_8u(CT_Image src, vx_border_t border, uint32_t radius, vx_df_image dst_format,
+                            CT_FilterRowFn row_fn, void* user_data);
+
 #endif // __VX_CT_IMAGE_H__
@@ -0,0 +1,277 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined CT_KERNEL_TRACE && defined __linux__
+#define _GNU_SOURCE // RTLD_NEXT
+#include <dlfcn.h>
+#define CT_KERNEL_TRACE_INTERPOSE 1
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "test_kernel_trace.h"
+#include "test_filter.h"
+
+#define CT_KERNEL_TRACE_MAX_KERNELS 64
+
+static FILE* g_trace_file = NULL;
+static int   g_trace_active = 0; // a test is running
+static int   g_trace_num_kernels = 0;
+static char  g_trace_kernels[CT_KERNEL_TRACE_MAX_KERNELS][VX_MAX_KERNEL_NAME];
+
+int ct_kernel_trace_is_supported()
+{
+#ifdef CT_KERNEL_TRACE_INTERPOSE
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+#ifdef CT_KERNEL_TRACE_INTERPOSE
+
+// the library may create nodes from its own threads, so the list is protected by the global lock
+static void ct_kernel_trace_add(const char* name)
+{
+    int i;
+
+    if (!name || !name[0])
+        return;
+
+    ct_global_lock();
+    if (g_trace_active)
+    {
+        for (i = 0; i < g_trace_num_kernels; i++)
+        {
+            if (strcmp(g_trace_kernels[i], name) == 0)
+                break;
+        }
+        if (i == g_trace_num_kernels && i < CT_KERNEL_TRACE_MAX_KERNELS)
+        {
+            strncpy(g_trace_kernels[i], name, VX_MAX_KERNEL_NAME - 1);
+            g_trace_kernels[i][VX_MAX_KERNEL_NAME - 1] = 0;
+            g_trace_num_kernels++;
+        }
+    }
+    ct_global_unlock();
+}
+
+static void ct_kernel_trace_add_kernel(vx_kernel kernel)
+{
+    vx_char name[VX_MAX_KERNEL_NAME] = { 0 };
+
+    if (g_trace_active && vxGetStatus((vx_reference)kernel) == VX_SUCCESS &&
+        vxQueryKernel(kernel, VX_KERNEL_NAME, name, sizeof(name)) == VX_SUCCESS)
+    {
+        name[VX_MAX_KERNEL_NAME - 1] = 0;
+        ct_kernel_trace_add(name);
+    }
+}
+
+#define CT_KERNEL_TRACE_REAL(type, fn) \
+    static type real_fn = NULL; \
+    if (real_fn == NULL) \
+        *(void**)&real_fn = dlsym(RTLD_NEXT, fn)
+
+typedef vx_kernel (VX_API_CALL *CT_GetKernelByEnumFN)(vx_context, vx_enum);
+typedef vx_kernel (VX_API_CALL *CT_GetKernelByNameFN)(vx_context, const vx_char*);
+typedef vx_node   (VX_API_CALL *CT_CreateGenericNodeFN)(vx_graph, vx_kernel);
+
+/*
+    These definitions in the executable take precedence over the library ones, including the
+    calls made by the library itself (vx*Node, vxu*), unless it is linked with -Bsymbolic.
+*/
+VX_API_ENTRY vx_kernel VX_API_CALL vxGetKernelByEnum(vx_context context, vx_enum kernel_e)
+{
+    vx_kernel kernel;
+    CT_KERNEL_TRACE_REAL(CT_GetKernelByEnumFN, "vxGetKernelByEnum");
+    if (real_fn == NULL)
+        return NULL;
+    kernel = real_fn(context, kernel_e);
+    ct_kernel_trace_add_kernel(kernel);
+    return kernel;
+}
+
+VX_API_ENTRY vx_kernel VX_API_CALL vxGetKernelByName(vx_context context, const vx_char* name)
+{
+    vx_kernel kernel;
+    CT_KERNEL_TRACE_REAL(CT_GetKernelByNameFN, "vxGetKernelByName");
+    if (real_fn == NULL)
+        return NULL;
+    kernel = real_fn(context, name);
+    ct_kernel_trace_add_kernel(kernel);
+    return kernel;
+}
+
+VX_API_ENTRY vx_node VX_API_CALL vxCreateGenericNode(vx_graph graph, vx_kernel kernel)
+{
+    CT_KERNEL_TRACE_REAL(CT_CreateGenericNodeFN, "vxCreateGenericNode");
+    if (real_fn == NULL)
+        return NULL;
+    ct_kernel_trace_add_kernel(kernel);
+    return real_fn(graph, kernel);
+}
+
+#endif // CT_KERNEL_TRACE_INTERPOSE
+
+int ct_kernel_trace_start_recording(const char* map_file)
+{
+    if (!ct_kernel_trace_is_supported())
+    {
+        printf("ERROR: Kernel recording is not supported by this build (configure with -DCT_KERNEL_TRACE=ON on Linux)\n");
+        return 0;
+    }
+
+    g_trace_file = fopen(map_file, "w");
+    if (g_trace_file == NULL)
+    {
+        printf("ERROR: Can't create kernel map %s\n", map_file);
+        return 0;
+    }
+    fprintf(g_trace_file, "# <test name>\\t<kernel name>...\n");
+    return 1;
+}
+
+void ct_kernel_trace_begin_test()
+{
+    if (g_trace_file == NULL)
+        return;
+
+    ct_global_lock();
+    g_trace_num_kernels = 0;
+    g_trace_active = 1;
+    ct_global_unlock();
+}
+
+void ct_kernel_trace_end_test(const char* test_name)
+{
+    int i;
+
+    if (g_trace_file == NULL)
+        return;
+
+    ct_global_lock();
+    g_trace_active = 0;
+    ct_global_unlock();
+
+    fputs(test_name, g_trace_file);
+    for (i = 0; i < g_trace_num_kernels; i++)
+        fprintf(g_trace_file, "\t%s", g_trace_kernels[i]);
+    fputc('\n', g_trace_file);
+    fflush(g_trace_file); // keep the map usable if the run crashes
+}
+
+void ct_kernel_trace_stop_recording()
+{
+    if (g_trace_file)
+        fclose(g_trace_file);
+    g_trace_file = NULL;
+}
+
+//============================================================================
+
+static CT_NameSet* g_mapped_tests = NULL;
+static CT_NameSet* g_selected_tests = NULL;
+
+int ct_kernel_trace_is_changed(const char* kernel, const char* changed_kernels)
+{
+    const char* short_name = strrchr(kernel, '.');
+    const char* item = changed_kernels;
+    short_name = short_name ? short_name + 1 : kernel;
+
+    while (*item)
+    {
+        size_t len = strcspn(item, ",:");
+        if (len > 0 && ((strlen(kernel) == len && memcmp(kernel, item, len) == 0) ||
+                        (strlen(short_name) == len && memcmp(short_name, item, len) == 0)))
+            return 1;
+        item += len;
+        if (*item)
+            item++;
+    }
+    return 0;
+}
+
+int ct_kernel_trace_load_selection(const char* map_file, const char* changed_kernels, int* num_selected, int* num_mapped)
+{
+    FILE* f = fopen(map_file, "r");
+    char* line = NULL;
+    size_t line_size = 0;
+    int ok = 1;
+
+    *num_selected = *num_mapped = 0;
+
+    if (f == NULL)
+    {
+        printf("ERROR: Can't read kernel map %s\n", map_file);
+        return 0;
+    }
+
+    g_mapped_tests = ct_name_set_create();
+    g_selected_tests = ct_name_set_create();
+    ok = g_mapped_tests && g_selected_tests;
+
+    while (ok && ct_read_line(f, &line, &line_size))
+    {
+        char* kernel = strchr(line, '\t');
+        int selected = 0;
+
+        if (line[0] == '#' || line[0] == 0)
+            continue;
+
+        if (kernel)
+            *kernel++ = 0;
+        while (kernel && !selected)
+        {
+            char* next = strchr(kernel, '\t');
+            if (next)
+                *next++ = 0;
+            selected = ct_kernel_trace_is_changed(kernel, changed_kernels);
+            kernel = next;
+        }
+
+        ok = ct_name_set_add(g_mapped_tests, line) >= 0 &&
+             (!selected || ct_name_set_add(g_selected_tests, line) >= 0);
+    }
+
+    free(line);
+    fclose(f);
+
+    if (!ok)
+    {
+        printf("ERROR: Not enough memory to load kernel map %s\n", map_file);
+        ct_name_set_release(&g_mapped_tests);
+        ct_name_set_release(&g_selected_tests);
+        return 0;
+    }
+
+    *num_mapped = ct_name_set_size(g_mapped_tests);
+    *num_selected = ct_name_set_size(g_selected_tests);
+    return 1;
+}
+
+int ct_kernel_trace_is_selected(const char* test_name)
+{
+    if (g_mapped_tests == NULL)
+        return 1; // selection is not enabled
+
+    // tests missing in the map are new ones
+    return !ct_name_set_contains(g_mapped_tests, test_name) || ct_name_set_contains(g_selected_tests, test_name);
+}
@@ -0,0 +1,49 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VX_CT_KERNEL_TRACE_H__
+#define __VX_CT_KERNEL_TRACE_H__
+
+/*
+    Incremental test selection (test engine internals, used by CT_main).
+
+    Recording (--kernel_map=<file>, builds with CT_KERNEL_TRACE only): vxGetKernelByEnum,
+    vxGetKernelByName and vxCreateGenericNode are interposed, so the kernels are seen even when
+    they are created inside the OpenVX library by vx*Node() and vxu*() functions. The names of
+    the kernels used by every executed test are written to the map, one test per line:
+
+        <test name>\t<kernel name>\t<kernel name>...
+
+    Selection (--kernel_map=<file> --changed_kernels=<list>): only the tests which used any of the
+    changed kernels and the tests missing in the map (new tests) are executed, on top of --filter.
+*/
+
+int  ct_kernel_trace_is_supported();
+
+int  ct_kernel_trace_start_recording(const char* map_file);
+void ct_kernel_trace_begin_test();
+void ct_kernel_trace_end_test(const char* test_name);
+void ct_kernel_trace_stop_recording();
+
+// 'changed_kernels' - list of kernel names separated by ',' or ':', a name matches the full
+// kernel name ("org.khronos.openvx.box_3x3") or its last component ("box_3x3")
+int  ct_kernel_trace_load_selection(const char* map_file, const char* changed_kernels, int* num_selected, int* num_mapped);
+int  ct_kernel_trace_is_selected(const char* test_name);
+// 1 if the kernel name matches any of the names in 'changed_kernels' (the list format as above)
+int  ct_kernel_trace_is_changed(const char* kernel, const char* changed_kernels);
+
+#endif // __VX_CT_KERNEL_TRACE_H__
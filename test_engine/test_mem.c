@@ -15,17 +15,263 @@
  * limitations under the License.
  */
 
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <VX/vx.h>
 
+#include "test_utils.h"
+#include "test_parallel.h"
+
+#if defined WIN32 || defined _WIN32 || defined WINCE
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#elif defined __MACH__ && defined __APPLE__
+#include <mach/mach.h>
+#include <sys/resource.h>
+#elif defined __linux || defined __linux__
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+/*
+    Memory pool: blocks are rounded up to size classes (64 * 2^n and 96 * 2^n bytes) and freed blocks
+    are kept in per-class free lists, so images of the same size are reused by the following tests
+    without going to the heap. Every block is CT_MEM_ALIGNMENT aligned. Blocks larger than the biggest
+    class bypass the pool. Define CT_DISABLE_MEM_POOL to use plain malloc/free (e.g. for memory checkers).
+*/
+
+#define CT_MEM_NUM_CLASSES  44                  // the biggest class is 96 * 2^21 bytes = 192Mb
+#define CT_MEM_CACHE_LIMIT  ((size_t)256 << 20) // free blocks kept by ct_mem_pool_reset()
+#define CT_MEM_MAGIC        0x4354424cu
+
+typedef struct CT_MemBlock_ {
+    struct CT_MemBlock_* next;
+    void*    raw;         // pointer returned by malloc
+    size_t   capacity;
+    size_t   size;        // requested size
+    int      size_class;  // -1 for blocks outside of the pool
+    uint32_t magic;
+} CT_MemBlock;
+
+static struct {
+    CT_MemBlock* free_list[CT_MEM_NUM_CLASSES];
+    size_t       cached_bytes;
+
+    // accounting of requested sizes
+    size_t       used_bytes;
+    size_t       used_blocks;
+    size_t       peak_bytes;
+    size_t       total_bytes;
+    size_t       total_blocks;
+    size_t       start_bytes;  // used_bytes at ct_mem_stats_reset()
+    size_t       start_blocks;
+} g_mem_pool;
+
+// called under ct_global_lock()
+static void ct_mem_account_alloc(size_t size)
+{
+    g_mem_pool.used_bytes += size;
+    g_mem_pool.used_blocks++;
+    g_mem_pool.total_bytes += size;
+    g_mem_pool.total_blocks++;
+    if (g_mem_pool.used_bytes > g_mem_pool.peak_bytes)
+        g_mem_pool.peak_bytes = g_mem_pool.used_bytes;
+}
+
+static size_t ct_mem_class_size(int size_class)
+{
+    return (size_t)((size_class & 1) ? 96 : 64) << (size_class >> 1);
+}
+
+static int ct_mem_size_class(size_t size)
+{
+    int size_class;
+    for (size_class = 0; size_class < CT_MEM_NUM_CLASSES; size_class++)
+    {
+        if (size <= ct_mem_class_size(size_class))
+            return size_class;
+    }
+    return -1;
+}
+
+#define CT_MEM_HEADER(ptr) ((CT_MemBlock*)((uint8_t*)(ptr) - CT_MEM_ALIGNMENT))
+
+static void* ct_mem_pool_alloc(size_t size)
+{
+    int size_class = ct_mem_size_class(size);
+    CT_MemBlock* block = NULL;
+    uint8_t* raw;
+    uint8_t* ptr;
+    size_t capacity;
+
+    if (size_class >= 0)
+    {
+        ct_global_lock();
+        block = g_mem_pool.free_list[size_class];
+        if (block)
+        {
+            g_mem_pool.free_list[size_class] = block->next;
+            g_mem_pool.cached_bytes -= block->capacity;
+            block->size = size;
+            ct_mem_account_alloc(size);
+        }
+        ct_global_unlock();
+
+        if (block)
+            return (uint8_t*)block + CT_MEM_ALIGNMENT;
+    }
+
+    capacity = (size_class >= 0) ? ct_mem_class_size(size_class) : size;
+    raw = (uint8_t*)malloc(capacity + 2 * CT_MEM_ALIGNMENT);
+    if (raw == NULL)
+        return NULL;
+
+    ptr = (uint8_t*)(((uintptr_t)raw + 2 * CT_MEM_ALIGNMENT - 1) & ~(uintptr_t)(CT_MEM_ALIGNMENT - 1));
+    block = CT_MEM_HEADER(ptr);
+    block->next       = NULL;
+    block->raw        = raw;
+    block->capacity   = capacity;
+    block->size       = size;
+    block->size_class = size_class;
+    block->magic      = CT_MEM_MAGIC;
+
+    ct_global_lock();
+    ct_mem_account_alloc(size);
+    ct_global_unlock();
+
+    return ptr;
+}
+
+static void ct_mem_pool_free(void* ptr)
+{
+    CT_MemBlock* block = CT_MEM_HEADER(ptr);
+
+    if (block->magic != CT_MEM_MAGIC)
+    {
+        fprintf(stderr, "FATAL: ct_free_mem() is called for memory which is not allocated by ct_alloc_mem()\n");
+        abort();
+    }
+
+    ct_global_lock();
+    g_mem_pool.used_bytes -= block->size;
+    g_mem_pool.used_blocks--;
+
+    if (block->size_class < 0)
+    {
+        ct_global_unlock();
+        free(block->raw);
+        return;
+    }
+
+    block->next = g_mem_pool.free_list[block->size_class];
+    g_mem_pool.free_list[block->size_class] = block;
+    g_mem_pool.cached_bytes += block->capacity;
+    ct_global_unlock();
+}
+
+static void ct_mem_pool_trim(size_t limit)
+{
+    int size_class;
+
+    ct_global_lock();
+    // big blocks are released first, they are the most expensive to keep
+    for (size_class = CT_MEM_NUM_CLASSES - 1; size_class >= 0 && g_mem_pool.cached_bytes > limit; size_class--)
+    {
+        while (g_mem_pool.free_list[size_class] && g_mem_pool.cached_bytes > limit)
+        {
+            CT_MemBlock* block = g_mem_pool.free_list[size_class];
+            g_mem_pool.free_list[size_class] = block->next;
+            g_mem_pool.cached_bytes -= block->capacity;
+            free(block->raw);
+        }
+    }
+    ct_global_unlock();
+}
+
+void ct_mem_pool_reset()
+{
+    ct_mem_pool_trim(CT_MEM_CACHE_LIMIT);
+}
+
+void ct_mem_pool_release()
+{
+    ct_mem_pool_trim(0);
+}
+
+void ct_mem_stats_reset()
+{
+    ct_global_lock();
+    g_mem_pool.peak_bytes   = g_mem_pool.used_bytes;
+    g_mem_pool.total_bytes  = 0;
+    g_mem_pool.total_blocks = 0;
+    g_mem_pool.start_bytes  = g_mem_pool.used_bytes;
+    g_mem_pool.start_blocks = g_mem_pool.used_blocks;
+    ct_global_unlock();
+}
+
+void ct_mem_get_stats(CT_MemStats* stats)
+{
+    ct_global_lock();
+    stats->allocated_bytes  = g_mem_pool.total_bytes;
+    stats->allocated_blocks = g_mem_pool.total_blocks;
+    stats->peak_bytes       = g_mem_pool.peak_bytes - g_mem_pool.start_bytes;
+    stats->leaked_bytes     = (int64_t)g_mem_pool.used_bytes - (int64_t)g_mem_pool.start_bytes;
+    stats->leaked_blocks    = (int64_t)g_mem_pool.used_blocks - (int64_t)g_mem_pool.start_blocks;
+    ct_global_unlock();
+}
+
+size_t ct_get_rss_bytes(size_t* peak_rss)
+{
+    size_t rss = 0, peak = 0;
+#if defined WIN32 || defined _WIN32 || defined WINCE
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        rss = (size_t)counters.WorkingSetSize;
+        peak = (size_t)counters.PeakWorkingSetSize;
+    }
+#elif defined __MACH__ && defined __APPLE__
+    struct mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    struct rusage usage;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+        rss = (size_t)info.resident_size;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        peak = (size_t)usage.ru_maxrss; // bytes on OS X
+#elif defined __linux || defined __linux__
+    FILE* f = fopen("/proc/self/statm", "r");
+    struct rusage usage;
+    if (f)
+    {
+        unsigned long size_pages = 0, resident_pages = 0;
+        if (fscanf(f, "%lu %lu", &size_pages, &resident_pages) == 2)
+            rss = (size_t)resident_pages * (size_t)sysconf(_SC_PAGESIZE);
+        fclose(f);
+    }
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        peak = (size_t)usage.ru_maxrss * 1024; // kilobytes on Linux
+#endif
+    if (peak_rss)
+        *peak_rss = peak;
+    return rss;
+}
+
 void *ct_alloc_mem(size_t size)
 {
     void *ptr = NULL;
 
     if (0 != size)
     {
+#ifdef CT_DISABLE_MEM_POOL
         ptr = malloc(size);
+#else
+        ptr = ct_mem_pool_alloc(size);
+#endif
     }
 
     return (ptr);
@@ -35,7 +281,11 @@ void ct_free_mem(void *ptr)
 {
     if (NULL != ptr)
     {
+#ifdef CT_DISABLE_MEM_POOL
         free(ptr);
+#else
+        ct_mem_pool_free(ptr);
+#endif
     }
 }
 
@@ -53,7 +303,16 @@ void *ct_calloc(size_t nmemb, size_t size)
 
     if ((0 != nmemb) && (0 != size))
     {
+#ifdef CT_DISABLE_MEM_POOL
         ptr = calloc(nmemb, size);
+#else
+        if (nmemb <= SIZE_MAX / size)
+        {
+            ptr = ct_mem_pool_alloc(nmemb * size);
+            if (ptr)
+                memset(ptr, 0, nmemb * size);
+        }
+#endif
     }
 
     return (ptr);
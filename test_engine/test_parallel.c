@@ -0,0 +1,384 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "test_parallel.h"
+
+#if defined WIN32 || defined _WIN32 || defined WINCE
+#include <windows.h>
+#define CT_USE_WIN32_THREADS
+#elif !defined CT_DISABLE_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#define CT_USE_PTHREADS
+#endif
+
+#ifndef CT_MAX_THREADS
+#define CT_MAX_THREADS 64
+#endif
+
+// number of ranges per thread, more ranges - better balancing of non-uniform rows
+#define CT_PARALLEL_RANGES_PER_THREAD 4
+
+#if defined CT_USE_WIN32_THREADS
+
+typedef HANDLE             ct_thread_t;
+typedef CRITICAL_SECTION   ct_mutex_t;
+typedef CONDITION_VARIABLE ct_cond_t;
+
+#define ct_mutex_init(m)      InitializeCriticalSection(m)
+#define ct_mutex_destroy(m)   DeleteCriticalSection(m)
+#define ct_mutex_lock(m)      EnterCriticalSection(m)
+#define ct_mutex_unlock(m)    LeaveCriticalSection(m)
+#define ct_cond_init(c)       InitializeConditionVariable(c)
+#define ct_cond_destroy(c)
+#define ct_cond_wait(c, m)    SleepConditionVariableCS(c, m, INFINITE)
+#define ct_cond_broadcast(c)  WakeAllConditionVariable(c)
+#define ct_cond_signal(c)     WakeConditionVariable(c)
+
+#elif defined CT_USE_PTHREADS
+
+typedef pthread_t          ct_thread_t;
+typedef pthread_mutex_t    ct_mutex_t;
+typedef pthread_cond_t     ct_cond_t;
+
+#define ct_mutex_init(m)      pthread_mutex_init(m, NULL)
+#define ct_mutex_destroy(m)   pthread_mutex_destroy(m)
+#define ct_mutex_lock(m)      pthread_mutex_lock(m)
+#define ct_mutex_unlock(m)    pthread_mutex_unlock(m)
+#define ct_cond_init(c)       pthread_cond_init(c, NULL)
+#define ct_cond_destroy(c)    pthread_cond_destroy(c)
+#define ct_cond_wait(c, m)    pthread_cond_wait(c, m)
+#define ct_cond_broadcast(c)  pthread_cond_broadcast(c)
+#define ct_cond_signal(c)     pthread_cond_signal(c)
+
+#endif
+
+static int g_num_threads = 0; // requested value, 0 - auto
+
+#if defined CT_USE_WIN32_THREADS
+static SRWLOCK g_global_lock = SRWLOCK_INIT;
+void ct_global_lock()   { AcquireSRWLockExclusive(&g_global_lock); }
+void ct_global_unlock() { ReleaseSRWLockExclusive(&g_global_lock); }
+#elif defined CT_USE_PTHREADS
+static pthread_mutex_t g_global_lock = PTHREAD_MUTEX_INITIALIZER;
+void ct_global_lock()   { pthread_mutex_lock(&g_global_lock); }
+void ct_global_unlock() { pthread_mutex_unlock(&g_global_lock); }
+#else
+void ct_global_lock()   { }
+void ct_global_unlock() { }
+#endif
+
+int ct_get_num_threads()
+{
+    int n = g_num_threads;
+
+    if (n <= 0)
+    {
+#if defined CT_USE_WIN32_THREADS
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        n = (int)info.dwNumberOfProcessors;
+#elif defined CT_USE_PTHREADS && defined _SC_NPROCESSORS_ONLN
+        n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+        n = 1;
+#endif
+    }
+
+    return CT_MAX(1, CT_MIN(n, CT_MAX_THREADS));
+}
+
+static void ct_parallel_for_serial(int begin, int end, CT_ParallelForBody body, void* user_data)
+{
+    if (begin < end)
+        body(user_data, begin, end);
+}
+
+#if defined CT_USE_WIN32_THREADS || defined CT_USE_PTHREADS
+
+typedef struct CT_ParallelJob_ {
+    CT_ParallelForBody body;
+    void* user_data;
+    int   end;
+    int   grain;
+    int   next;      // first index of not yet started range
+    int   remaining; // number of indices which are not processed yet
+} CT_ParallelJob;
+
+static struct CT_ThreadPool_ {
+    int              initialized;
+    int              shutdown;
+    int              num_workers;
+    ct_thread_t      workers[CT_MAX_THREADS];
+    ct_mutex_t       mutex;
+    ct_cond_t        job_cond;
+    ct_cond_t        done_cond;
+    CT_ParallelJob*  job;
+} g_pool = { 0 };
+
+// called with locked mutex, returns with locked mutex
+static int ct_parallel_run_range(CT_ParallelJob* job)
+{
+    int begin, end;
+
+    if (job->next >= job->end)
+        return 0;
+
+    begin = job->next;
+    end = CT_MIN(begin + job->grain, job->end);
+    job->next = end;
+
+    ct_mutex_unlock(&g_pool.mutex);
+    job->body(job->user_data, begin, end);
+    ct_mutex_lock(&g_pool.mutex);
+
+    job->remaining -= end - begin;
+    if (job->remaining == 0)
+        ct_cond_broadcast(&g_pool.done_cond);
+
+    return 1;
+}
+
+static void ct_parallel_worker_loop()
+{
+    ct_mutex_lock(&g_pool.mutex);
+    for (;;)
+    {
+        while (!g_pool.shutdown && (g_pool.job == NULL || g_pool.job->next >= g_pool.job->end))
+            ct_cond_wait(&g_pool.job_cond, &g_pool.mutex);
+
+        if (g_pool.shutdown)
+            break;
+
+        ct_parallel_run_range(g_pool.job);
+    }
+    ct_mutex_unlock(&g_pool.mutex);
+}
+
+#if defined CT_USE_WIN32_THREADS
+static DWORD WINAPI ct_parallel_worker(LPVOID arg)
+{
+    (void)arg;
+    ct_parallel_worker_loop();
+    return 0;
+}
+#else
+static void* ct_parallel_worker(void* arg)
+{
+    (void)arg;
+    ct_parallel_worker_loop();
+    return NULL;
+}
+#endif
+
+static void ct_parallel_init(int num_workers)
+{
+    int i;
+
+    ct_mutex_init(&g_pool.mutex);
+    ct_cond_init(&g_pool.job_cond);
+    ct_cond_init(&g_pool.done_cond);
+    g_pool.shutdown = 0;
+    g_pool.job = NULL;
+    g_pool.num_workers = 0;
+
+    for (i = 0; i < num_workers; i++)
+    {
+#if defined CT_USE_WIN32_THREADS
+        g_pool.workers[i] = CreateThread(NULL, 0, ct_parallel_worker, NULL, 0, NULL);
+        if (g_pool.workers[i] == NULL)
+            break;
+#else
+        if (pthread_create(&g_pool.workers[i], NULL, ct_parallel_worker, NULL) != 0)
+            break;
+#endif
+        g_pool.num_workers++;
+    }
+
+    g_pool.initialized = 1;
+}
+
+void ct_parallel_shutdown()
+{
+    int i;
+
+    if (!g_pool.initialized)
+        return;
+
+    ct_mutex_lock(&g_pool.mutex);
+    g_pool.shutdown = 1;
+    ct_cond_broadcast(&g_pool.job_cond);
+    ct_mutex_unlock(&g_pool.mutex);
+
+    for (i = 0; i < g_pool.num_workers; i++)
+    {
+#if defined CT_USE_WIN32_THREADS
+        WaitForSingleObject(g_pool.workers[i], INFINITE);
+        CloseHandle(g_pool.workers[i]);
+#else
+        pthread_join(g_pool.workers[i], NULL);
+#endif
+    }
+
+    ct_cond_destroy(&g_pool.done_cond);
+    ct_cond_destroy(&g_pool.job_cond);
+    ct_mutex_destroy(&g_pool.mutex);
+    g_pool.num_workers = 0;
+    g_pool.initialized = 0;
+}
+
+void ct_set_num_threads(int num_threads)
+{
+    ct_parallel_shutdown(); // pool is re-created on demand with new size
+    g_num_threads = num_threads;
+}
+
+void ct_parallel_for(int begin, int end, CT_ParallelForBody body, void* user_data)
+{
+    CT_ParallelJob job;
+    int num_threads = ct_get_num_threads();
+    int num_ranges;
+
+    if (end - begin <= 1 || num_threads <= 1)
+    {
+        ct_parallel_for_serial(begin, end, body, user_data);
+        return;
+    }
+
+    ct_global_lock(); // the first call may come from several threads of a stress test
+    if (!g_pool.initialized)
+        ct_parallel_init(num_threads - 1);
+    ct_global_unlock();
+
+    ct_mutex_lock(&g_pool.mutex);
+    if (g_pool.job != NULL || g_pool.num_workers == 0)
+    {
+        // the pool is busy (nested or concurrent call) or threads are not available
+        ct_mutex_unlock(&g_pool.mutex);
+        ct_parallel_for_serial(begin, end, body, user_data);
+        return;
+    }
+
+    num_ranges = (g_pool.num_workers + 1) * CT_PARALLEL_RANGES_PER_THREAD;
+    job.body      = body;
+    job.user_data = user_data;
+    job.end       = end;
+    job.grain     = CT_MAX(1, (end - begin + num_ranges - 1) / num_ranges);
+    job.next      = begin;
+    job.remaining = end - begin;
+
+    g_pool.job = &job;
+    ct_cond_broadcast(&g_pool.job_cond);
+
+    while (ct_parallel_run_range(&job))
+        ;
+
+    while (job.remaining > 0)
+        ct_cond_wait(&g_pool.done_cond, &g_pool.mutex);
+
+    g_pool.job = NULL;
+    ct_mutex_unlock(&g_pool.mutex);
+}
+
+typedef struct CT_ThreadArg_ {
+    CT_ParallelForBody body;
+    void* user_data;
+    int   index;
+} CT_ThreadArg;
+
+#if defined CT_USE_WIN32_THREADS
+static DWORD WINAPI ct_thread_main(LPVOID arg_)
+{
+    CT_ThreadArg* arg = (CT_ThreadArg*)arg_;
+    arg->body(arg->user_data, arg->index, arg->index + 1);
+    return 0;
+}
+#else
+static void* ct_thread_main(void* arg_)
+{
+    CT_ThreadArg* arg = (CT_ThreadArg*)arg_;
+    arg->body(arg->user_data, arg->index, arg->index + 1);
+    return NULL;
+}
+#endif
+
+void ct_run_threads(int num_threads, CT_ParallelForBody body, void* user_data)
+{
+    CT_ThreadArg args[CT_MAX_THREADS];
+    ct_thread_t threads[CT_MAX_THREADS];
+    int started[CT_MAX_THREADS];
+    int i;
+
+    num_threads = CT_MAX(1, CT_MIN(num_threads, CT_MAX_THREADS));
+
+    for (i = 1; i < num_threads; i++)
+    {
+        args[i].body = body;
+        args[i].user_data = user_data;
+        args[i].index = i;
+#if defined CT_USE_WIN32_THREADS
+        threads[i] = CreateThread(NULL, 0, ct_thread_main, &args[i], 0, NULL);
+        started[i] = threads[i] != NULL;
+#else
+        started[i] = pthread_create(&threads[i], NULL, ct_thread_main, &args[i]) == 0;
+#endif
+    }
+
+    body(user_data, 0, 1);
+
+    for (i = 1; i < num_threads; i++)
+    {
+        if (!started[i])
+        {
+            body(user_data, i, i + 1); // thread creation failed
+            continue;
+        }
+#if defined CT_USE_WIN32_THREADS
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+}
+
+#else // no threads support
+
+void ct_parallel_shutdown()
+{
+}
+
+void ct_set_num_threads(int num_threads)
+{
+    g_num_threads = num_threads;
+}
+
+void ct_parallel_for(int begin, int end, CT_ParallelForBody body, void* user_data)
+{
+    ct_parallel_for_serial(begin, end, body, user_data);
+}
+
+void ct_run_threads(int num_threads, CT_ParallelForBody body, void* user_data)
+{
+    ct_parallel_for_serial(0, CT_MAX(1, num_threads), body, user_data);
+}
+
+#endif
@@ -0,0 +1,51 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VX_CT_PARALLEL_H__
+#define __VX_CT_PARALLEL_H__
+
+/*
+    Row-parallel execution for reference implementations (and concurrent OpenVX calls in stress tests).
+
+    ct_parallel_for() splits [begin, end) into ranges and calls body(user_data, range_begin, range_end)
+    from a pool of worker threads (the calling thread takes part as well). Bodies must not use
+    ASSERT/EXPECT/FAIL macros, allocate CT_Images or register objects for garbage collection,
+    because the test engine state is not thread-safe; results and statuses are returned through
+    user_data and checked by the caller.
+
+    Nested or concurrent calls are executed serially on the calling thread.
+*/
+
+typedef void (*CT_ParallelForBody)(void* user_data, int begin, int end);
+
+void ct_parallel_for(int begin, int end, CT_ParallelForBody body, void* user_data);
+
+// runs body(user_data, i, i + 1) for i in [0, num_threads) simultaneously on dedicated threads
+// (i = 0 on the calling thread), for stress tests which need an exact number of concurrent threads;
+// the same restrictions as for ct_parallel_for() bodies apply
+void ct_run_threads(int num_threads, CT_ParallelForBody body, void* user_data);
+
+int  ct_get_num_threads();
+void ct_set_num_threads(int num_threads); // 0 - use number of CPUs, 1 - disable threading
+
+void ct_parallel_shutdown();
+
+// process-wide lock for short critical sections of engine services (memory pool)
+void ct_global_lock();
+void ct_global_unlock();
+
+#endif // __VX_CT_PARALLEL_H__
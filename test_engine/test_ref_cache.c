@@ -0,0 +1,372 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+
+// bump when the file layout or the hashing changes
+#define CT_REF_CACHE_FORMAT   1
+#define CT_REF_CACHE_MAGIC    (((uint64_t)0x43545243 << 32) | CT_REF_CACHE_FORMAT) // "CTRC"
+#define CT_REF_CACHE_FLAG_RLE 1
+
+static char g_ref_cache_dir[1024] = { 0 };
+static int  g_ref_cache_hits = 0;
+static int  g_ref_cache_misses = 0;
+
+void ct_set_ref_cache_dir(const char* dir)
+{
+    size_t len = dir ? strlen(dir) : 0;
+
+    while (len > 1 && (dir[len - 1] == '/' || dir[len - 1] == '\\'))
+        len--;
+    if (len >= sizeof(g_ref_cache_dir))
+        len = 0;
+    if (len > 0)
+        memcpy(g_ref_cache_dir, dir, len);
+    g_ref_cache_dir[len] = 0;
+}
+
+const char* ct_get_ref_cache_dir()
+{
+    return g_ref_cache_dir[0] ? g_ref_cache_dir : NULL;
+}
+
+void ct_ref_cache_get_stats(int* hits, int* misses)
+{
+    if (hits)
+        *hits = g_ref_cache_hits;
+    if (misses)
+        *misses = g_ref_cache_misses;
+}
+
+static uint64_t ct_ref_cache_mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// two independent 64-bit lanes processing 8 bytes per step, the tail is padded with its length
+static void ct_ref_cache_hash(uint64_t h[2], const void* data, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t h0 = h[0], h1 = h[1], w;
+
+    for (; size >= 8; p += 8, size -= 8)
+    {
+        memcpy(&w, p, 8);
+        h0 = (h0 ^ w) * 0x100000001B3ULL;
+        h1 = ((h1 + w) << 29 | (h1 + w) >> 35) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    w = (uint64_t)size << 56;
+    if (size > 0)
+        memcpy(&w, p, size);
+    h0 = (h0 ^ w) * 0x100000001B3ULL;
+    h1 = ((h1 + w) << 29 | (h1 + w) >> 35) * 0x9E3779B97F4A7C15ULL;
+
+    h[0] = h0;
+    h[1] = h1;
+}
+
+void ct_ref_cache_key_init(CT_RefCacheKey* key, const char* ref_name, int ref_version)
+{
+    size_t i, len = 0;
+
+    key->h[0] = 0xCBF29CE484222325ULL;
+    key->h[1] = 0x84222325CBF29CE4ULL;
+    key->size = 0;
+    key->unsupported = 0;
+
+    // the name is a part of the file name, keep it portable
+    for (i = 0; ref_name && ref_name[i] && len + 1 < sizeof(key->name); i++)
+    {
+        char c = ref_name[i];
+        int ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        key->name[len++] = ok ? c : '_';
+    }
+    key->name[len] = 0;
+
+    ct_ref_cache_key_add(key, key->name, len);
+    ct_ref_cache_key_add_int(key, ref_version);
+    ct_ref_cache_key_add_int(key, CT_REF_CACHE_FORMAT);
+}
+
+void ct_ref_cache_key_add(CT_RefCacheKey* key, const void* data, size_t size)
+{
+    ct_ref_cache_hash(key->h, data, size);
+    key->size += size;
+}
+
+void ct_ref_cache_key_add_int(CT_RefCacheKey* key, int64_t value)
+{
+    ct_ref_cache_key_add(key, &value, sizeof(value));
+}
+
+static size_t ct_ref_cache_row_size(CT_Image image)
+{
+    uint32_t bpp = ct_image_bits_per_pixel(image->format);
+    if (ct_get_num_planes(image->format) != 1 || bpp % 8 != 0)
+        return 0;
+    return (size_t)image->width * (bpp / 8);
+}
+
+void ct_ref_cache_key_add_image(CT_RefCacheKey* key, CT_Image image)
+{
+    size_t row_size = ct_ref_cache_row_size(image);
+    uint32_t y;
+
+    ct_ref_cache_key_add_int(key, image->width);
+    ct_ref_cache_key_add_int(key, image->height);
+    ct_ref_cache_key_add_int(key, image->format);
+
+    if (row_size == 0)
+    {
+        key->unsupported = 1;
+        return;
+    }
+
+    for (y = 0; y < image->height; y++)
+        ct_ref_cache_key_add(key, image->data.y + (size_t)y * ct_stride_bytes(image), row_size);
+}
+
+static void ct_ref_cache_file_name(const CT_RefCacheKey* key, char* buf, size_t buf_size)
+{
+    uint64_t f0 = ct_ref_cache_mix(key->h[0] ^ key->size);
+    uint64_t f1 = ct_ref_cache_mix(key->h[1] + f0);
+    snprintf(buf, buf_size, "%s/%s-%08x%08x%08x%08x.ref", g_ref_cache_dir, key->name,
+             (unsigned)(f0 >> 32), (unsigned)f0, (unsigned)(f1 >> 32), (unsigned)f1);
+}
+
+/*
+    Run-length encoding: control byte c < 128 is followed by c + 1 literal bytes,
+    c >= 128 is followed by one byte repeated c - 125 times (3..130).
+*/
+static size_t ct_ref_cache_rle_encode(const uint8_t* src, size_t size, uint8_t* dst)
+{
+    size_t i = 0, n = 0, literal_start = 0;
+
+    while (i < size)
+    {
+        size_t run = 1;
+        while (i + run < size && run < 130 && src[i + run] == src[i])
+            run++;
+
+        if (run >= 3 || i - literal_start == 128)
+        {
+            while (literal_start < i)
+            {
+                size_t count = CT_MIN(i - literal_start, 128);
+                dst[n++] = (uint8_t)(count - 1);
+                memcpy(dst + n, src + literal_start, count);
+                n += count;
+                literal_start += count;
+            }
+        }
+
+        if (run >= 3)
+        {
+            dst[n++] = (uint8_t)(run + 125);
+            dst[n++] = src[i];
+            i += run;
+            literal_start = i;
+        }
+        else
+            i++;
+    }
+
+    while (literal_start < size)
+    {
+        size_t count = CT_MIN(size - literal_start, 128);
+        dst[n++] = (uint8_t)(count - 1);
+        memcpy(dst + n, src + literal_start, count);
+        n += count;
+        literal_start += count;
+    }
+
+    return n;
+}
+
+static int ct_ref_cache_rle_decode(const uint8_t* src, size_t size, uint8_t* dst, size_t dst_size)
+{
+    size_t i = 0, n = 0;
+
+    while (i < size)
+    {
+        uint8_t c = src[i++];
+        if (c < 128)
+        {
+            size_t count = (size_t)c + 1;
+            if (i + count > size || n + count > dst_size)
+                return 0;
+            memcpy(dst + n, src + i, count);
+            i += count;
+            n += count;
+        }
+        else
+        {
+            size_t count = (size_t)c - 125;
+            if (i >= size || n + count > dst_size)
+                return 0;
+            memset(dst + n, src[i++], count);
+            n += count;
+        }
+    }
+
+    return n == dst_size;
+}
+
+int ct_ref_cache_load(const CT_RefCacheKey* key, void* data, size_t size)
+{
+    char file_name[1200];
+    uint64_t hdr[5], checksum[2] = { 0, 0 };
+    uint8_t* stored = NULL;
+    FILE* f = NULL;
+    int ok = 0;
+
+    if (!g_ref_cache_dir[0] || key->unsupported)
+        return 0;
+
+    ct_ref_cache_file_name(key, file_name, sizeof(file_name));
+    f = fopen(file_name, "rb");
+
+    // header: magic, raw size, stored size, flags, checksum of the raw data
+    if (f && fread(hdr, sizeof(hdr), 1, f) == 1 &&
+        hdr[0] == CT_REF_CACHE_MAGIC && hdr[1] == (uint64_t)size && hdr[2] <= (uint64_t)size + size / 128 + 16)
+    {
+        if (hdr[3] & CT_REF_CACHE_FLAG_RLE)
+        {
+            stored = (uint8_t*)ct_alloc_mem((size_t)hdr[2] + 1);
+            ok = stored && fread(stored, 1, (size_t)hdr[2], f) == (size_t)hdr[2] &&
+                 ct_ref_cache_rle_decode(stored, (size_t)hdr[2], (uint8_t*)data, size);
+        }
+        else
+        {
+            ok = hdr[2] == (uint64_t)size && fread(data, 1, size, f) == size;
+        }
+
+        if (ok)
+        {
+            ct_ref_cache_hash(checksum, data, size);
+            ok = checksum[0] == hdr[4];
+        }
+    }
+
+    if (f)
+        fclose(f);
+    ct_free_mem(stored);
+
+    if (ok)
+        g_ref_cache_hits++;
+    else
+        g_ref_cache_misses++;
+    return ok;
+}
+
+void ct_ref_cache_store(const CT_RefCacheKey* key, const void* data, size_t size)
+{
+    static unsigned counter = 0;
+    char file_name[1200], tmp_name[1300];
+    uint64_t hdr[5], checksum[2] = { 0, 0 };
+    uint8_t* encoded = NULL;
+    const void* stored = data;
+    FILE* f = NULL;
+    int ok = 0;
+
+    if (!g_ref_cache_dir[0] || key->unsupported)
+        return;
+
+    hdr[0] = CT_REF_CACHE_MAGIC;
+    hdr[1] = size;
+    hdr[2] = size;
+    hdr[3] = 0;
+    ct_ref_cache_hash(checksum, data, size);
+    hdr[4] = checksum[0];
+
+    encoded = (uint8_t*)ct_alloc_mem(size + size / 128 + 16);
+    if (encoded)
+    {
+        size_t encoded_size = ct_ref_cache_rle_encode((const uint8_t*)data, size, encoded);
+        if (encoded_size < size)
+        {
+            hdr[2] = encoded_size;
+            hdr[3] = CT_REF_CACHE_FLAG_RLE;
+            stored = encoded;
+        }
+    }
+
+    // write to a unique temporary file and rename it, readers never see partial entries
+    ct_ref_cache_file_name(key, file_name, sizeof(file_name));
+    snprintf(tmp_name, sizeof(tmp_name), "%s.%x%x.tmp", file_name,
+             (unsigned)(ct_ref_cache_mix((uint64_t)time(NULL) ^ (uint64_t)clock() ^ (uint64_t)(size_t)&counter)),
+             counter++);
+    f = fopen(tmp_name, "wb");
+    if (f)
+    {
+        ok = fwrite(hdr, sizeof(hdr), 1, f) == 1 && fwrite(stored, 1, (size_t)hdr[2], f) == (size_t)hdr[2];
+        ok = (fclose(f) == 0) && ok;
+        if (!ok || rename(tmp_name, file_name) != 0)
+            remove(tmp_name); // the entry is already there (Windows) or the disk is full
+    }
+
+    ct_free_mem(encoded);
+}
+
+int ct_ref_cache_load_image(const CT_RefCacheKey* key, CT_Image image)
+{
+    size_t row_size = ct_ref_cache_row_size(image);
+    uint8_t* buf = NULL;
+    uint32_t y;
+    int ok;
+
+    if (!g_ref_cache_dir[0] || row_size == 0)
+        return 0;
+
+    buf = (uint8_t*)ct_alloc_mem(row_size * image->height);
+    if (!buf)
+        return 0;
+
+    ok = ct_ref_cache_load(key, buf, row_size * image->height);
+    for (y = 0; ok && y < image->height; y++)
+        memcpy(image->data.y + (size_t)y * ct_stride_bytes(image), buf + y * row_size, row_size);
+
+    ct_free_mem(buf);
+    return ok;
+}
+
+void ct_ref_cache_store_image(const CT_RefCacheKey* key, CT_Image image)
+{
+    size_t row_size = ct_ref_cache_row_size(image);
+    uint8_t* buf = NULL;
+    uint32_t y;
+
+    if (!g_ref_cache_dir[0] || row_size == 0)
+        return;
+
+    buf = (uint8_t*)ct_alloc_mem(row_size * image->height);
+    if (!buf)
+        return;
+
+    for (y = 0; y < image->height; y++)
+        memcpy(buf + y * row_size, image->data.y + (size_t)y * ct_stride_bytes(image), row_size);
+    ct_ref_cache_store(key, buf, row_size * image->height);
+
+    ct_free_mem(buf);
+}
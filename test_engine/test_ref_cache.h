@@ -0,0 +1,70 @@
+/*
+
+ * Copyright (c) 2012-2017 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VX_CT_REF_CACHE_H__
+#define __VX_CT_REF_CACHE_H__
+
+/*
+    On-disk cache of reference results, enabled with --ref_cache=<dir>.
+
+    An entry is addressed by a hash of the reference function name, its version and everything the
+    result depends on (input data and parameters, added with ct_ref_cache_key_add*()). Bump the
+    version passed to ct_ref_cache_key_init() whenever the reference code changes its output:
+    entries of the previous version are not found anymore. Entries are run-length compressed and
+    written atomically (temporary file + rename), so several processes may share the directory.
+
+    Without --ref_cache all the calls are no-ops and ct_ref_cache_load*() always miss, so callers
+    use the cache unconditionally:
+
+        CT_RefCacheKey key;
+        ct_ref_cache_key_init(&key, "canny", 1);
+        ct_ref_cache_key_add_image(&key, src);
+        ct_ref_cache_key_add(&key, &threshold, sizeof(threshold));
+        if (!ct_ref_cache_load_image(&key, dst))
+        {
+            reference_canny(src, dst, ...);
+            ct_ref_cache_store_image(&key, dst);
+        }
+
+    Must be called from the test thread only (not from ct_parallel_for() bodies).
+*/
+
+typedef struct CT_RefCacheKey {
+    uint64_t h[2];
+    uint64_t size;
+    int      unsupported; // the key has data which can't be hashed, the entry is never loaded or stored
+    char     name[64];
+} CT_RefCacheKey;
+
+void ct_ref_cache_key_init(CT_RefCacheKey* key, const char* ref_name, int ref_version);
+void ct_ref_cache_key_add(CT_RefCacheKey* key, const void* data, size_t size);
+void ct_ref_cache_key_add_int(CT_RefCacheKey* key, int64_t value);
+// size, format and content of the image (ROI only), single-plane formats
+void ct_ref_cache_key_add_image(CT_RefCacheKey* key, CT_Image image);
+
+// return 1 if the entry of exactly 'size' bytes is found and loaded
+int  ct_ref_cache_load(const CT_RefCacheKey* key, void* data, size_t size);
+void ct_ref_cache_store(const CT_RefCacheKey* key, const void* data, size_t size);
+// the image must be allocated with the expected size and (single-plane) format
+int  ct_ref_cache_load_image(const CT_RefCacheKey* key, CT_Image image);
+void ct_ref_cache_store_image(const CT_RefCacheKey* key, CT_Image image);
+
+void        ct_set_ref_cache_dir(const char* dir); // NULL or "" - disable the cache
+const char* ct_get_ref_cache_dir();
+void        ct_ref_cache_get_stats(int* hits, int* misses);
+
+#endif // __VX_CT_REF_CACHE_H__
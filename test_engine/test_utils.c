@@ -382,6 +382,88 @@ void ct_fill_image_random_impl(vx_image image, uint64_t* seed, const char* func,
     } /* for planes */
 }
 
+typedef struct {
+    vx_uint8*                   base_ptr;
+    vx_imagepatch_addressing_t  addr;
+    vx_uint32                   cols;        // number of pixels in the row (dim_x / step_x)
+    uint64_t                    first_index; // counter of the first element of the plane
+    uint64_t                    key;
+} ct_random_fill_patch_job;
+
+static void ct_fill_image_random_keyed_rows(void* job_, int begin, int end)
+{
+    ct_random_fill_patch_job* job = (ct_random_fill_patch_job*)job_;
+    const vx_imagepatch_addressing_t* addr = &job->addr;
+    vx_uint32 x, k, pixel_size = addr->stride_x; // every byte of the pixel is random, as in ct_fill_image_random()
+    int i;
+
+    for (i = begin; i < end; i++)
+    {
+        vx_uint32 y = (vx_uint32)i * addr->step_y;
+        vx_uint8* row = job->base_ptr + (vx_size)(addr->scale_y * y / VX_SCALE_UNITY) * addr->stride_y;
+        uint64_t index = job->first_index + (uint64_t)i * job->cols;
+
+        for (x = 0; x < job->cols; x++)
+        {
+            vx_uint8* data = row + (vx_size)(addr->scale_x * (x * addr->step_x) / VX_SCALE_UNITY) * addr->stride_x;
+            uint64_t v;
+            CT_RNG_AT(v, job->key, index + x);
+            for (k = 0; k < pixel_size; k++)
+                data[k] = (vx_uint8)(v >> (8 * k));
+        }
+    }
+}
+
+void ct_fill_image_random_keyed_impl(vx_image image, uint64_t* seed, const char* func, const char* file, const int line)
+{
+    ct_random_fill_patch_job job;
+    uint64_t rng;
+    vx_uint32 width  = 0;
+    vx_uint32 height = 0;
+    vx_size planes = 0;
+    vx_df_image format = VX_DF_IMAGE_VIRT;
+    vx_rectangle_t rect;
+    vx_uint32 p;
+
+    ASSERT_AT(seed != NULL, func, file, line);
+
+    ASSERT_EQ_VX_STATUS_AT_(return, VX_SUCCESS, vxQueryImage(image, VX_IMAGE_WIDTH,   &width,   sizeof(width)),  func, file, line);
+    ASSERT_EQ_VX_STATUS_AT_(return, VX_SUCCESS, vxQueryImage(image, VX_IMAGE_HEIGHT,  &height,  sizeof(height)), func, file, line);
+    ASSERT_EQ_VX_STATUS_AT_(return, VX_SUCCESS, vxQueryImage(image, VX_IMAGE_PLANES,  &planes,  sizeof(planes)), func, file, line);
+    ASSERT_EQ_VX_STATUS_AT_(return, VX_SUCCESS, vxQueryImage(image, VX_IMAGE_FORMAT,  &format,  sizeof(format)), func, file, line);
+
+    if (format != VX_DF_IMAGE_U8 && format != VX_DF_IMAGE_U16 && format != VX_DF_IMAGE_U32 &&
+        format != VX_DF_IMAGE_S16 && format != VX_DF_IMAGE_S32 && format != VX_DF_IMAGE_RGB &&
+        format != VX_DF_IMAGE_RGBX && format != VX_DF_IMAGE_YUV4 && format != VX_DF_IMAGE_IYUV &&
+        format != VX_DF_IMAGE_NV12 && format != VX_DF_IMAGE_NV21 && format != VX_DF_IMAGE_UYVY &&
+        format != VX_DF_IMAGE_YUYV)
+        FAIL_AT("ENGINE: Unknown or broken vx_image format: %.4s", func, file, line, &format);
+
+    rect.start_x = rect.start_y = 0;
+    rect.end_x = width;
+    rect.end_y = height;
+
+    job.key = *seed;
+    job.first_index = 0;
+
+    for (p = 0; p < planes; ++p)
+    {
+        vx_map_id map_id;
+        void* base_ptr = 0;
+        ASSERT_EQ_VX_STATUS_AT_(return, VX_SUCCESS, vxMapImagePatch(image, &rect, p, &map_id, &job.addr, &base_ptr, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST, 0), func, file, line);
+
+        job.base_ptr = (vx_uint8*)base_ptr;
+        job.cols = (job.addr.dim_x + job.addr.step_x - 1) / job.addr.step_x;
+        ct_parallel_for(0, (int)((job.addr.dim_y + job.addr.step_y - 1) / job.addr.step_y), ct_fill_image_random_keyed_rows, &job);
+        job.first_index += (uint64_t)job.cols * ((job.addr.dim_y + job.addr.step_y - 1) / job.addr.step_y);
+
+        ASSERT_EQ_VX_STATUS_AT_(return, VX_SUCCESS, vxUnmapImagePatch(image, map_id), func, file, line);
+    }
+
+    CT_RNG_INIT(rng, *seed);
+    *seed = CT_RNG_NEXT(rng);
+}
+
 vx_image ct_clone_image_impl(vx_image image, vx_graph graph, const char* func, const char* file, const int line)
 {
 #define CLONE_FAILED() CT_RecordFailureAt("ENGINE: Unable to make a clone of vx_image", func, file, line)
@@ -994,6 +1076,28 @@ void ct_set_check_any_size(int flag)
     check_any_size = flag;
 }
 
+static int check_benchmark = 0;
+int ct_check_benchmark()
+{
+    return check_benchmark;
+}
+
+void ct_set_check_benchmark(int flag)
+{
+    check_benchmark = flag;
+}
+
+static int size_tier = CT_SIZE_TIER_DEFAULT;
+int ct_get_size_tier()
+{
+    return size_tier;
+}
+
+void ct_set_size_tier(int tier)
+{
+    size_tier = tier;
+}
+
 void ct_destroy_vx_context(void **pContext)
 {
     vxReleaseContext((vx_context *)pContext);
@@ -156,6 +156,10 @@ void ct_release_global_vx_context();
 void ct_fill_image_random_impl(vx_image image, uint64_t* seed, const char* func, const char* file, const int line);
 #define ct_fill_image_random(image, seed) ct_fill_image_random_impl(image, seed, __FUNCTION__, __FILE__, __LINE__)
 
+// the same as ct_fill_image_random(), but with CT_RNG_AT() values keyed by *seed (see ct_fill_ct_image_random_keyed())
+void ct_fill_image_random_keyed_impl(vx_image image, uint64_t* seed, const char* func, const char* file, const int line);
+#define ct_fill_image_random_keyed(image, seed) ct_fill_image_random_keyed_impl(image, seed, __FUNCTION__, __FILE__, __LINE__)
+
 vx_image ct_clone_image_impl(vx_image image, vx_graph graph, const char* func, const char* file, const int line);
 #define ct_clone_image(image, graph) ct_clone_image_impl(image, graph, __FUNCTION__, __FILE__, __LINE__)
 
@@ -182,6 +186,18 @@ uint32_t ct_floor_u32_no_overflow(float v);
 #define CT_RNG_NEXT_BOOL(rng)      CT_RNG_NEXT_INT(rng, 0, 2)
 #define CT_RNG_NEXT_REAL(rng, a, b) ((uint32_t)CT_RNG_NEXT(rng)*(2.3283064365386963e-10*((b) - (a))) + (a))
 
+// counter-based generator: 'index'-th value of the SplitMix64 sequence keyed by 'key', so every
+// element is computed independently of the others (no sequential state, can be filled in parallel)
+#define CT_RNG_AT(out, key, index)                                                  \
+    do {                                                                            \
+        uint64_t z_ = (uint64_t)(key) + ((uint64_t)(index) + 1) * 0x9E3779B97F4A7C15ULL; \
+        z_ = (z_ ^ (z_ >> 30)) * 0xBF58476D1CE4E5B9ULL;                             \
+        z_ = (z_ ^ (z_ >> 27)) * 0x94D049BB133111EBULL;                             \
+        (out) = z_ ^ (z_ >> 31);                                                    \
+    } while (0)
+#define CT_RNG_AT_INT(out, key, index, a, b) \
+    do { uint64_t v_; CT_RNG_AT(v_, key, index); (out) = (int)((uint32_t)v_ % ((b) - (a)) + (a)); } while (0)
+
 #define CT_CAST_U8(x)  (uint8_t)((x) < 0 ? 0 : (x) > 255 ? 255 : (x))
 #define CT_CAST_U16(x) (uint16_t)((x) < 0 ? 0 : (x) > 65535 ? 65535 : (x))
 #define CT_CAST_S16(x) (int16_t)((x) < -32768 ? -32768 : (x) > 32767 ? 32767 : (x))
@@ -213,14 +229,49 @@ uint8_t ct_clamp_8u(int32_t v);
 int ct_check_any_size();
 void ct_set_check_any_size(int flag);
 
+// --benchmark: performance tests repeat the measured operations, otherwise they make a single pass
+int ct_check_benchmark();
+void ct_set_check_benchmark(int flag);
+
+// parameters between ARG_PRODUCTION_BEGIN()/ARG_PRODUCTION_END() are executed only in production and all tiers
+enum {
+    CT_SIZE_TIER_DEFAULT = 0,
+    CT_SIZE_TIER_PRODUCTION,   // production parameters only
+    CT_SIZE_TIER_ALL
+};
+
+int ct_get_size_tier();
+void ct_set_size_tier(int tier);
+
 void ct_destroy_vx_context(void **pContext);
 
 char *ct_get_test_file_path();
 
+// memory returned by ct_alloc_mem()/ct_calloc() must be released by ct_free_mem(); it is CT_MEM_ALIGNMENT
+// aligned unless CT_DISABLE_MEM_POOL is defined (plain malloc)
+#define CT_MEM_ALIGNMENT 64
+
 void *ct_alloc_mem(size_t size);
 
 void ct_free_mem(void *ptr);
 
+void ct_mem_pool_reset();   // trims cached free blocks, called after every test
+void ct_mem_pool_release(); // releases all cached free blocks
+
+// accounting of ct_alloc_mem() memory since the last ct_mem_stats_reset() (not available with CT_DISABLE_MEM_POOL)
+typedef struct CT_MemStats_ {
+    size_t  allocated_bytes;  // total size of allocations
+    size_t  allocated_blocks;
+    size_t  peak_bytes;       // high-water mark of memory in use above the starting level
+    int64_t leaked_bytes;     // memory in use above the starting level
+    int64_t leaked_blocks;
+} CT_MemStats;
+
+void ct_mem_stats_reset();
+void ct_mem_get_stats(CT_MemStats* stats);
+
+size_t ct_get_rss_bytes(size_t* peak_rss); // resident set size of the process, 0 if not supported
+
 void ct_memset(void *ptr, vx_uint8 c, size_t);
 void *ct_calloc(size_t nmemb, size_t size);
 